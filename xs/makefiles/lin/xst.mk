@@ -36,6 +36,9 @@ SRC_DIR = $(XS_DIR)/sources
 TLS_DIR = $(XS_DIR)/tools
 TMP_DIR = $(BUILD_DIR)/tmp/lin/$(GOAL)/$(NAME)
 
+# number of threads that mark and sweep large heaps, 0 to collect on the calling thread alone
+COLLECT_THREADS ?= 4
+
 MACOS_ARCH ?= -arch i386
 MACOS_VERSION_MIN ?= -mmacosx-version-min=10.7
 
@@ -43,13 +46,20 @@ C_OPTIONS = \
 	-fno-common \
 	-DINCLUDE_XSPLATFORM \
 	-DXSPLATFORM=\"xst.h\" \
+	-DmxCollectKeys=1 \
 	-DmxDebug=1 \
+	-DmxDictionaries=1 \
 	-DmxNoConsole=1 \
 	-DmxParse=1 \
+	-DmxPropertyCache=1 \
+	-DmxPropertyCacheKeys=1 \
 	-DmxRun=1 \
 	-DmxSloppy=1 \
 	-DmxSnapshot=1 \
 	-DmxRegExpUnicodePropertyEscapes=1 \
+	-DmxStringCache=1 \
+	-DmxParallelMark=$(COLLECT_THREADS) \
+	-DmxParallelSweep=$(COLLECT_THREADS) \
 	-I$(INC_DIR) \
 	-I$(PLT_DIR) \
 	-I$(SRC_DIR) \
@@ -46,13 +46,18 @@ C_OPTIONS = \
 	$(MACOS_VERSION_MIN) \
 	-DINCLUDE_XSPLATFORM \
 	-DXSPLATFORM=\"xst.h\" \
+	-DmxCollectKeys=1 \
 	-DmxDebug=1 \
+	-DmxDictionaries=1 \
 	-DmxNoConsole=1 \
 	-DmxParse=1 \
+	-DmxPropertyCache=1 \
+	-DmxPropertyCacheKeys=1 \
 	-DmxRun=1 \
 	-DmxSloppy=1 \
 	-DmxSnapshot=1 \
 	-DmxRegExpUnicodePropertyEscapes=1 \
+	-DmxStringCache=1 \
 	-I$(INC_DIR) \
 	-I$(PLT_DIR) \
 	-I$(SRC_DIR) \
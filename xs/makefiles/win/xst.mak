@@ -45,13 +45,18 @@ C_OPTIONS = \
 	/D YAML_DECLARE_STATIC \
 	/D INCLUDE_XSPLATFORM \
 	/D XSPLATFORM=\"xst.h\" \
+	/D mxCollectKeys=1 \
 	/D mxDebug=1 \
+	/D mxDictionaries=1 \
 	/D mxNoConsole=1 \
 	/D mxParse=1 \
+	/D mxPropertyCache=1 \
+	/D mxPropertyCacheKeys=1 \
 	/D mxRun=1 \
 	/D mxSloppy=1 \
 	/D mxSnapshot=1 \
 	/D mxRegExpUnicodePropertyEscapes=1 \
+	/D mxStringCache=1 \
 	/I$(INC_DIR) \
 	/I$(PLT_DIR) \
 	/I$(SRC_DIR) \
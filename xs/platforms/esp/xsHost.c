@@ -1391,6 +1391,10 @@ void espInstrumentMachineReset(txMachine *the)
 	the->stackPeak = the->stack;
 	the->peakParserSize = 0;
 	the->floatingPointOps = 0;
+#if mxRegExpCache
+	the->regExpCacheHits = 0;
+	the->regExpCacheMisses = 0;
+#endif
 }
 
 #if INSTRUMENT_CPULOAD
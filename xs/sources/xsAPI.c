@@ -1337,8 +1337,10 @@ txMachine* fxCreateMachine(txCreation* theCreation, txString theName, void* theC
 			mxPushList();
 			/* mxInstanceInspectors */
 			mxPushList();
+			/* mxRegExpCacheList */
+			mxPushList();
 
-			for (id = mxInstanceInspectorsStackIndex + 1; id < mxEmptyCodeStackIndex; id++)
+			for (id = mxRegExpCacheStackIndex + 1; id < mxEmptyCodeStackIndex; id++)
 				mxPushUndefined();
 
 			/* mxEmptyCode */
@@ -1544,6 +1546,13 @@ txMachine* fxCloneMachine(txCreation* theCreation, txMachine* theMachine, txStri
 
 			fxAllocate(the, theCreation);
 
+			if (the->nameModulo != theMachine->nameModulo) {
+				c_free_uint32(the->nameTable);
+				the->nameModulo = theMachine->nameModulo;
+				the->nameTable = (txSlot **)c_malloc_uint32(the->nameModulo * sizeof(txSlot*));
+				if (!the->nameTable)
+					fxJump(the);
+			}
             c_memcpy(the->nameTable, theMachine->nameTable, the->nameModulo * sizeof(txSlot *));
 			c_memcpy(the->symbolTable, theMachine->symbolTable, the->symbolModulo * sizeof(txSlot *));
 //			c_memset(the->keyArray, 0, theCreation->keyCount * sizeof(txSlot*));		//@@ this is not necessary
@@ -1585,6 +1594,8 @@ txMachine* fxCloneMachine(txCreation* theCreation, txMachine* theMachine, txStri
 			mxPushList();
 			/* mxInstanceInspectors */
 			mxPushList();
+			/* mxRegExpCacheList */
+			mxPushList();
 
 			the->stackPrototypes = theMachine->stackTop;
 
@@ -1700,6 +1711,7 @@ void fxShareMachine(txMachine* the)
 			mxBreakpoints = mxUndefined;
 			mxHostInspectors = mxUndefined;
 			mxInstanceInspectors = mxUndefined;
+			mxRegExpCacheList = mxUndefined;
 		}
 		fxCollectGarbage(the);
 		fxShare(the);
@@ -2200,7 +2212,7 @@ void* fxMapArchive(txPreparation* preparation, void* src, void* dst, size_t buff
 		id = (txID)preparation->keyCount;
 		for (i = 0; i < c; i++) {
 			txU1 byte;
-			txU4 sum = 0;
+			txU4 sum = mxNameSumSeed;
 			txU4 modulo = 0;
 			txSlot* result;
 			p = self->scratch;
@@ -2208,11 +2220,11 @@ void* fxMapArchive(txPreparation* preparation, void* src, void* dst, size_t buff
 			while ((byte = fxMapperRead1(self))) {
 				mxElseFatalCheck(p < q);
 				*p++ = byte;
-				sum = (sum << 1) + byte;
+				sum = mxNameSum(sum, byte);
 			}
 			mxElseFatalCheck(p < q);
 			*p = 0;
-			sum &= 0x7FFFFFFF;
+			sum &= mxNameSumMask;
 			modulo = sum % preparation->nameModulo;
 			result = preparation->names[modulo];
 			while (result != C_NULL) {
@@ -157,17 +157,53 @@ void fxBufferObjectName(txMachine* the, txString buffer, txSize size, txSlot* ob
 
 txString fxConcatString(txMachine* the, txSlot* a, txSlot* b)
 {
-	txSize aSize = mxStringLength(a->value.string);
-	txSize bSize = mxStringLength(b->value.string);
+	txSize aSize = fxGetStringSize(the, a);
+	txSize bSize = fxGetStringSize(the, b);
 	txSize resultSize = fxAddChunkSizes(the, fxAddChunkSizes(the, aSize, bSize), 1);
 	txString result = (txString)fxNewChunk(the, resultSize);
 	c_memcpy(result, a->value.string, aSize);
 	c_memcpy(result + aSize, b->value.string, bSize + 1);
 	a->value.string = result;
 	a->kind = XS_STRING_KIND;
+#if mxStringCache
+	fxCacheStringSize(the, result, resultSize - 1, -1);
+#endif
 	return result;
 }
 
+#if mxStringAppend
+txBoolean fxAppendString(txMachine* the, txSlot* variable, txSlot* a, txSlot* b)
+{
+	txSize aSize, bSize, resultSize;
+	txString result = C_NULL;
+	if ((variable->kind < 0) || (variable->flag & XS_DONT_SET_FLAG))
+		return 0;
+	aSize = fxGetStringSize(the, a);
+	bSize = fxGetStringSize(the, b);
+	resultSize = fxAddChunkSizes(the, fxAddChunkSizes(the, aSize, bSize), 1);
+	/* append_local marked the variable: the left operand is its string and nothing else refers to it */
+	if ((variable->flag & XS_STRING_READ_FLAG) && (variable->kind == XS_STRING_KIND) && (a->kind == XS_STRING_KIND) && (variable->value.string == a->value.string)) {
+		result = (txString)fxRenewChunk(the, a->value.string, resultSize);
+		if (!result) {
+			result = (txString)fxNewGrowableChunk(the, resultSize, fxAddChunkSizes(the, resultSize, resultSize >> 1));
+			c_memcpy(result, a->value.string, aSize);
+		}
+	}
+	else {
+		result = (txString)fxNewChunk(the, resultSize);
+		c_memcpy(result, a->value.string, aSize);
+	}
+	c_memcpy(result + aSize, b->value.string, bSize + 1);
+	variable->flag = (variable->flag & ~XS_STRING_READ_FLAG) | XS_STRING_OWNED_FLAG;
+	variable->kind = XS_STRING_KIND;
+	variable->value.string = result;
+#if mxStringCache
+	fxCacheStringSize(the, result, resultSize - 1, -1);
+#endif
+	return 1;
+}
+#endif
+
 txString fxConcatStringC(txMachine* the, txSlot* a, txString b)
 {
 	txSize aSize = mxStringLength(a->value.string);
@@ -55,6 +55,113 @@ extern "C" {
 #ifndef mxRegExp
 	#define mxRegExp 1
 #endif
+/* 0 to always backtrack, 1 to match in linear time the patterns that nest repetitions, 2 to match in linear time every pattern without back references and lookarounds */
+#ifndef mxRegExpLinear
+	#define mxRegExpLinear 1
+#endif
+/* number of compiled regular expressions that instances with the same source and flags share, 0 to compile every instance */
+#ifndef mxRegExpCache
+	#define mxRegExpCache 16
+#endif
+/* multiply and divide BigInt values by 64-bit limbs where the compiler has 128-bit integers */
+#ifndef mxBigInt64
+	#if defined(__SIZEOF_INT128__) && !mxBigEndian
+		#define mxBigInt64 1
+	#else
+		#define mxBigInt64 0
+	#endif
+#endif
+/* number of limbs from which BigInt multiplications and squarings split their operands in halves */
+#ifndef mxBigIntKaratsuba
+	#define mxBigIntKaratsuba 24
+#endif
+/* convert numbers to their shortest strings with Grisu3, falling back to dtoa when it cannot decide */
+#ifndef mxGrisu
+	#define mxGrisu 1
+#endif
+/* convert decimal strings to numbers with Eisel-Lemire, falling back to strtod when it cannot decide */
+#ifndef mxEiselLemire
+	#define mxEiselLemire 1
+#endif
+#ifndef mxPropertyCache
+	#define mxPropertyCache 0
+#endif
+/* share the entries of property caches between ordinary instances with the same prototype and the same property IDs, the properties stay in the slot chain */
+#ifndef mxPropertyCacheKeys
+	#define mxPropertyCacheKeys 0
+#endif
+#if mxPropertyCacheKeys && (!mxPropertyCache || (!mx32bitID && !(INTPTR_MAX == INT64_MAX)))
+	#undef mxPropertyCacheKeys
+	#define mxPropertyCacheKeys 0
+#endif
+#ifndef mxDictionaries
+	#define mxDictionaries 0
+#endif
+#if mxDictionaries && !mx32bitID && !(INTPTR_MAX == INT64_MAX)
+	#undef mxDictionaries
+	#define mxDictionaries 0
+#endif
+/* read and write the items of dense arrays and typed arrays directly from GET_PROPERTY_AT and SET_PROPERTY_AT */
+#ifndef mxIndexFastPath
+	#define mxIndexFastPath 1
+#endif
+/* recognize the keys of the former object at the same depth when JSON.parse builds objects */
+#ifndef mxJSONKeyCache
+	#define mxJSONKeyCache 1
+#endif
+#ifndef mxStringAppend
+	#define mxStringAppend 1
+#endif
+#ifndef mxStringCache
+	#define mxStringCache 0
+#endif
+#ifndef mxCollectKeys
+	#define mxCollectKeys 0
+#endif
+/* number of threads that mark the slot heaps, 0 to mark on the collecting thread alone */
+#ifndef mxParallelMark
+	#define mxParallelMark 0
+#endif
+#if mxParallelMark && !(defined(mxUsePOSIXThreads) && defined(mxUseGCCAtomics))
+	#undef mxParallelMark
+	#define mxParallelMark 0
+#endif
+#ifndef mxKeyLimit
+	#if mx32bitID
+		#define mxKeyLimit 0x7FFFFFFF
+	#else
+		#define mxKeyLimit 0x7FFF
+	#endif
+#endif
+#define mxNameSumSeed 0x811C9DC5
+#define mxNameSum(SUM, BYTE) (((SUM) ^ (txU1)(BYTE)) * 0x01000193)
+#define mxNameSumMask 0x7FFFFFFF
+#if mxPropertyCache
+	#define mxPropertyCacheCount 512
+	#define mxPropertyCacheShadowCount 8
+	#define mxPropertyCacheWayCount 2
+#endif
+#if mxStringCache
+	#define mxStringCacheCount 256
+#endif
+#if mxPropertyCacheKeys
+	#define mxPropertyCacheKeyCount 4096
+	#define mxPropertyCacheKeyLimit 64
+	#define mxPropertyCacheKeyRootModulo 61
+#endif
+#if mxDictionaries
+	#ifndef mxDictionaryThreshold
+		#define mxDictionaryThreshold 64
+	#endif
+	#ifndef mxDictionaryRevert
+		#define mxDictionaryRevert 1
+	#endif
+	#if mx32bitID
+		#define mxDictionaryCount 0x7FFF
+	#else
+		#define mxDictionaryCount 0x7FFFFFFF
+	#endif
+#endif
 #ifndef mxMachinePlatform
 	#define mxMachinePlatform \
 		void* host;
@@ -64,6 +171,7 @@ typedef struct sxMachine txMachine;
 typedef struct sxSlot txSlot;
 typedef struct sxBlock txBlock;
 typedef struct sxChunk txChunk;
+typedef struct sxHashEntry txHashEntry;
 typedef struct sxJump txJump;
 typedef struct sxProfileRecord txProfileRecord;
 typedef struct sxCreation txCreation;
@@ -72,6 +180,11 @@ typedef struct sxHostFunctionBuilder txHostFunctionBuilder;
 typedef struct sxHostHooks txHostHooks;
 typedef struct sxInspectorNameLink txInspectorNameLink;
 typedef struct sxInspectorNameList txInspectorNameList;
+typedef struct sxPropertyCacheEntry txPropertyCacheEntry;
+typedef struct sxPropertyCacheKey txPropertyCacheKey;
+typedef struct sxStringCacheEntry txStringCacheEntry;
+typedef struct sxDictionary txDictionary;
+typedef struct sxMarkThread txMarkThread;
 
 typedef txBoolean (*txArchiveRead)(void* src, size_t offset, void* buffer, size_t size);
 typedef txBoolean (*txArchiveWrite)(void* dst, size_t offset, void* buffer, size_t size);
@@ -163,12 +276,20 @@ typedef struct {
     txBehaviorSetPrototype setPrototype;
 } txBehavior;
 
+#define mxSortMinMerge 32
+#define mxSortMinGallop 7
+#define mxSortRadixThreshold 64
+#define mxSortRunCount 49
 typedef struct {
-    txInteger lo;
-    txInteger hi;
-} txSortPartition;
-#define mxSortThreshold 4
-#define mxSortStackSize 8 * sizeof(txUnsigned)
+	txSlot* function;
+	txSlot* list;
+	txSlot* temp;
+	txInteger length;
+	txInteger minGallop;
+	txInteger runCount;
+	txInteger runBases[mxSortRunCount];
+	txInteger runLengths[mxSortRunCount];
+} txSorter;
 
 #define mxTypeArrayCount 11
 
@@ -302,6 +423,12 @@ struct sxChunk {
 	txByte* temporary;
 };
 
+/* Map and Set tables are open addressed: the key slots are in the list that follows the table, the entries cache their sums */
+struct sxHashEntry {
+	txSlot* slot;
+	txU4 sum;
+};
+
 struct sxJump {
 	c_jmp_buf buffer; /* xs.h */
 	txJump* nextJump; /* xs.h */
@@ -380,6 +507,45 @@ struct sxProfileRecord {
 	txInteger profileID;
 };
 
+struct sxPropertyCacheEntry {
+	txByte* code;
+	txSlot* instance;
+	txSlot* property;
+	txUnsigned epoch;
+#if mxPropertyCacheKeys
+	txInteger key;
+	txInteger position;
+#endif
+};
+
+struct sxStringCacheEntry {
+	txString string;
+	txSize size;
+	txSize length;
+	txU4 sum;
+	txID id;
+	txIndex index;
+	txSize crumbIndex;
+	txSize crumbOffset;
+	txFlag flag;
+};
+
+struct sxPropertyCacheKey {
+	txSlot* prototype;
+	txInteger parent;
+	txInteger first;
+	txInteger next;
+	txInteger count;
+	txID id;
+};
+
+struct sxDictionary {
+	txSlot* last;
+	txInteger count;
+	txInteger mask;
+	txSlot* table[1];
+};
+
 struct sxMachine {
 	txSlot* stack; /* xs.h */
 	txSlot* scope; /* xs.h */
@@ -413,6 +579,10 @@ struct sxMachine {
 	txID keyIndex;
 	txID keyOffset;
 	txSlot** keyArrayHost;
+	txID* keyFreeArray;
+	txID keyFreeCount;
+	txID keyFreeSize;
+	txSize nameCount;
 
 	txID aliasCount;
 	txID aliasIndex;
@@ -422,6 +592,7 @@ struct sxMachine {
 	
 	txSlot* firstWeakListLink;
 	txSlot* firstWeakRefLink;
+	txSlot* firstTableLink;
 	
 	txSize currentChunksSize;
 	txSize peakChunksSize;
@@ -446,6 +617,34 @@ struct sxMachine {
 
 	txInteger tag;
 	char nameBuffer[256];
+#if mxPropertyCache
+	txPropertyCacheEntry* propertyCache;
+	txUnsigned propertyCacheEpoch;
+	txUnsigned propertyCacheHits;
+	txUnsigned propertyCacheMisses;
+	txU4 propertyCacheShadows[mxPropertyCacheShadowCount];
+#endif
+#if mxStringCache
+	txStringCacheEntry* stringCache;
+#endif
+#if mxRegExpCache
+	txUnsigned regExpCacheHits;
+	txUnsigned regExpCacheMisses;
+#endif
+#if mxPropertyCacheKeys
+	txPropertyCacheKey* propertyCacheKeyArray;
+	txInteger propertyCacheKeyCount;
+	txInteger propertyCacheKeyIndex;
+	txInteger propertyCacheKeyRoots[mxPropertyCacheKeyRootModulo];
+#endif
+#if mxParallelMark
+	txMarkThread* markThread;
+#endif
+#if mxDictionaries
+	txDictionary** dictionaryArray;
+	txInteger dictionaryCount;
+	txInteger dictionaryFree;
+#endif
 #ifdef mxDebug
 	txString name;
 	txFlag breakOnExceptionsFlag;
@@ -759,6 +958,9 @@ extern void fxBufferFrameName(txMachine* the, txString buffer, txSize size, txSl
 extern void fxBufferFunctionName(txMachine* the, txString buffer, txSize size, txSlot* function, txString suffix);
 extern void fxBufferObjectName(txMachine* the, txString buffer, txSize size, txSlot* object, txString suffix);
 extern txString fxConcatString(txMachine* the, txSlot* a, txSlot* b);
+#if mxStringAppend
+extern txBoolean fxAppendString(txMachine* the, txSlot* variable, txSlot* a, txSlot* b);
+#endif
 extern txString fxConcatStringC(txMachine* the, txSlot* a, txString b);
 extern txString fxCopyString(txMachine* the, txSlot* a, txSlot* b);
 extern txString fxCopyStringC(txMachine* the, txSlot* a, txString b);
@@ -858,10 +1060,32 @@ extern txSlot* fxNewRealmInstance(txMachine* the);
 extern txSlot* fxNewProgramInstance(txMachine* the);
 
 /* xsProperty.c */
+#if mxPropertyCache
+extern txSlot* fxGetCachedProperty(txMachine* the, txByte* code, txSlot* instance, txID id);
+extern void fxInvalidatePropertyCache(txMachine* the);
+extern txSlot* fxSetCachedProperty(txMachine* the, txByte* code, txSlot* instance, txID id);
+#if mxPropertyCacheKeys
+extern void fxEmptyPropertyCacheKeys(txMachine* the);
+extern txInteger fxGetPropertyCacheKey(txMachine* the, txSlot* instance);
+extern txInteger fxNextPropertyCacheKey(txMachine* the, txInteger key, txInteger count, txID id);
+#endif
+#if mxDictionaries
+extern void fxFreeDictionary(txMachine* the, txSlot* instance);
+extern txSlot* fxGetDictionaryProperty(txMachine* the, txSlot* instance, txID id);
+extern txSlot** fxGetDictionaryTail(txMachine* the, txSlot* instance);
+extern void fxNewDictionary(txMachine* the, txSlot* instance);
+extern void fxRemoveDictionaryProperty(txMachine* the, txSlot* instance, txSlot* property, txSlot* previous);
+#endif
+#if mxPropertyCacheKeys || mxDictionaries
+/* positive for property cache keys, negative for dictionaries */
+#define mxInstanceIndex(INSTANCE) ((INSTANCE)->dummy)
+#endif
+#endif
 extern txSlot* fxNextHostAccessorProperty(txMachine* the, txSlot* property, txCallback get, txCallback set, txID id, txFlag flag);
 extern txSlot* fxNextHostFunctionProperty(txMachine* the, txSlot* property, txCallback call, txInteger length, txID id, txFlag flag);
 
 extern txSlot* fxLastProperty(txMachine* the, txSlot* slot);
+extern txSlot* fxNewProperty(txMachine* the, txSlot** address, txID id, txFlag flag);
 extern txSlot* fxNextUndefinedProperty(txMachine* the, txSlot* property, txID id, txFlag flag);
 extern txSlot* fxNextNullProperty(txMachine* the, txSlot* property, txID id, txFlag flag);
 extern txSlot* fxNextBooleanProperty(txMachine* the, txSlot* property, txBoolean boolean, txID id, txFlag flag);
@@ -1016,6 +1240,8 @@ extern txBoolean fxIsKeySymbol(txMachine* the, txID theID);
 extern txID fxNewName(txMachine* the, txSlot* theSlot);
 extern txID fxNewNameC(txMachine* the, txString theString);
 extern txID fxNewNameX(txMachine* the, txString theString);
+extern txID fxNewKey(txMachine* the, txSlot* theSlot);
+extern txID fxNewCollectableName(txMachine* the, txSlot* theSlot);
 extern txSlot* fxAt(txMachine* the, txSlot* slot);
 extern void fxKeyAt(txMachine* the, txID id, txIndex index, txSlot* slot);
 extern void fxIDToString(txMachine* the, txID id, txString theBuffer, txSize theSize);
@@ -1236,6 +1462,17 @@ extern txNumber fxDateNow();
 /* xsString.c */
 extern const txBehavior gxStringBehavior;
 
+#if mxStringCache
+extern void fxCacheStringSize(txMachine* the, txString string, txSize size, txSize length);
+extern txStringCacheEntry* fxFindStringCacheEntry(txMachine* the, txSlot* slot);
+extern void fxInvalidateStringCache(txMachine* the);
+extern void fxInvalidateStringCacheEntry(txMachine* the, txString string);
+#endif
+extern txSize fxGetStringIndex(txMachine* the, txSlot* slot, txSize offset);
+extern txSize fxGetStringLength(txMachine* the, txSlot* slot);
+extern txSize fxGetStringOffset(txMachine* the, txSlot* slot, txSize index);
+extern txSize fxGetStringSize(txMachine* the, txSlot* slot);
+
 mxExport void fx_String(txMachine* the);
 mxExport void fx_String_fromArrayBuffer(txMachine* the);
 mxExport void fx_String_fromCharCode(txMachine* the);
@@ -1370,6 +1607,7 @@ extern void fxCacheArray(txMachine* the, txSlot* theArray);
 extern void fxConstructArrayEntry(txMachine* the, txSlot* entry);
 extern txBoolean fxIsArray(txMachine* the, txSlot* instance);
 extern txSlot* fxNewArrayInstance(txMachine* the);
+extern void fxSortArrayItems(txMachine* the, txSlot* function, txSlot* list);
 extern txNumber fxToLength(txMachine* the, txSlot* slot);
 
 /* xsDataView.c */
@@ -1647,10 +1885,16 @@ extern txSlot* fxNewSetInstance(txMachine* the);
 extern txSlot* fxNewWeakMapInstance(txMachine* the);
 extern txSlot* fxNewWeakSetInstance(txMachine* the);
 extern void fxCleanupFinalizationRegistries(txMachine* the);
+extern void fxIndexEntry(txMachine* the, txSlot* table, txSlot* key, txU4 sum);
+extern void fxPurgeEntries(txMachine* the, txSlot* table, txFlag flag);
+extern void fxRehashEntries(txMachine* the, txSlot* table, txSlot* list);
 extern txU4 fxSumEntry(txMachine* the, txSlot* slot); 
 
 /* xsJSON.c */
 mxExport void fx_JSON_parse(txMachine* the);
+mxExport void fx_JSON_parser(txMachine* the);
+mxExport void fx_JSON_parser_close(txMachine* the);
+mxExport void fx_JSON_parser_push(txMachine* the);
 mxExport void fx_JSON_stringify(txMachine* the);
 
 extern void fxBuildJSON(txMachine* the);
@@ -1849,6 +2093,30 @@ enum {
 	XS_DERIVED_FLAG = 64,
 	/* XS_MARK_FLAG = 128, */
 
+	/* local flags */
+	/* XS_DONT_SET_FLAG = 8, */
+	XS_STRING_OWNED_FLAG = 16,
+	XS_STRING_READ_FLAG = 32,
+	/* XS_MARK_FLAG = 128, */
+
+	/* string cache flags */
+	XS_STRING_SIZE_FLAG = 1,
+	XS_STRING_LENGTH_FLAG = 2,
+	XS_STRING_SUM_FLAG = 4,
+	XS_STRING_AT_FLAG = 8,
+	XS_STRING_CRUMB_FLAG = 16,
+
+	/* entry flags */
+	/* XS_DONT_ENUM_FLAG = 4, */
+	XS_VISITED_FLAG = 32,
+	/* XS_MARK_FLAG = 128, */
+
+	/* key flags */
+	/* XS_DONT_ENUM_FLAG = 4, */
+	XS_COLLECTABLE_FLAG = 16,
+	XS_RECENT_FLAG = 32,
+	/* XS_MARK_FLAG = 128, */
+
 	/* mxBehaviorOwnKeys flags */
 	XS_EACH_NAME_FLAG = 1,
 	XS_EACH_SYMBOL_FLAG = 2,
@@ -2057,6 +2325,16 @@ enum {
 
 #define mxIsStringPrimitive(THE_SLOT) \
 	(((THE_SLOT)->kind == XS_STRING_KIND) || ((THE_SLOT)->kind == XS_STRING_X_KIND))
+
+/* the entry after the last one counts the deleted slots that are still in the list but were never visited, and links the tables to purge while collecting */
+#define mxTableEntries(THE_TABLE) \
+	((txHashEntry*)((THE_TABLE)->value.table.address))
+#define mxTableDeleted(THE_TABLE) \
+	(mxTableEntries(THE_TABLE)[(THE_TABLE)->value.table.length].sum)
+#define mxTableLink(THE_TABLE) \
+	(mxTableEntries(THE_TABLE)[(THE_TABLE)->value.table.length].slot)
+#define mxTableSize(THE_LENGTH) \
+	((txSize)(((THE_LENGTH) + 1) * sizeof(txHashEntry)))
 	
 #ifdef mxMetering
 #define mxMeterOne() \
@@ -2371,6 +2649,7 @@ enum {
 	mxBreakpointsStackIndex,
 	mxHostInspectorsStackIndex,
 	mxInstanceInspectorsStackIndex,
+	mxRegExpCacheStackIndex,
 
 	mxObjectPrototypeStackIndex = XS_INTRINSICS_COUNT,
 	mxFunctionPrototypeStackIndex,
@@ -2476,6 +2755,7 @@ enum {
 #define mxBreakpoints the->stackTop[-1 - mxBreakpointsStackIndex]
 #define mxHostInspectors the->stackTop[-1 - mxHostInspectorsStackIndex]
 #define mxInstanceInspectors the->stackTop[-1 - mxInstanceInspectorsStackIndex]
+#define mxRegExpCacheList the->stackTop[-1 - mxRegExpCacheStackIndex]
 
 #define mxAggregateErrorConstructor the->stackPrototypes[-1 - _AggregateError]
 #define mxArrayConstructor the->stackPrototypes[-1 - _Array]
@@ -38,19 +38,31 @@
 #include "xsAll.h"
 
 #define mxArraySize(ARRAY) (((ARRAY)->value.array.address) ? (((txChunk*)(((txByte*)((ARRAY)->value.array.address)) - sizeof(txChunk)))->size) / sizeof(txSlot) : 0)
+#define mxSortItem(ARRAY, INDEX) ((ARRAY)->value.array.address + (INDEX))
+#define mxSortCompare(A, B) fxCompareSortItems(the, sorter->function, A, B)
+#define mxSortCopy(TO, FROM, COUNT) c_memmove(TO, FROM, (COUNT) * sizeof(txSlot))
 
 static txIndex fxCheckArrayLength(txMachine* the, txSlot* slot);
 static txBoolean fxCallThisItem(txMachine* the, txSlot* function, txIndex index, txSlot* item);
 static txSlot* fxCheckArray(txMachine* the, txSlot* slot, txBoolean mutable);
 static txSlot* fxCheckArrayItems(txMachine* the, txSlot* array, txIndex from, txIndex to);
-static int fxCompareArrayItem(txMachine* the, txSlot* function, txSlot* array, txInteger i);
+static void fxCollapseSortRuns(txMachine* the, txSorter* sorter, txBoolean force);
+static txInteger fxCompareSortItems(txMachine* the, txSlot* function, txSlot* a, txSlot* b);
+static txInteger fxCountSortRun(txMachine* the, txSorter* sorter, txInteger low, txInteger high);
 static txSlot* fxCreateArray(txMachine* the, txFlag flag, txIndex length);
 static txSlot* fxCreateArraySpecies(txMachine* the, txNumber length);
 static void fxFindThisItem(txMachine* the, txSlot* function, txIndex index, txSlot* item);
+static txInteger fxGallopSortLeft(txMachine* the, txSorter* sorter, txSlot* key, txSlot* array, txInteger base, txInteger length, txInteger hint);
+static txInteger fxGallopSortRight(txMachine* the, txSorter* sorter, txSlot* key, txSlot* array, txInteger base, txInteger length, txInteger hint);
 static txNumber fxGetArrayLength(txMachine* the, txSlot* reference);
 static txIndex fxGetArrayLimit(txMachine* the, txSlot* reference);
+static void fxInsertSortItems(txMachine* the, txSorter* sorter, txInteger low, txInteger high, txInteger start);
+static void fxMergeSortAt(txMachine* the, txSorter* sorter, txInteger i);
+static void fxMergeSortHigh(txMachine* the, txSorter* sorter, txInteger base1, txInteger length1, txInteger base2, txInteger length2);
+static void fxMergeSortLow(txMachine* the, txSorter* sorter, txInteger base1, txInteger length1, txInteger base2, txInteger length2);
 static void fxMoveThisItem(txMachine* the, txNumber from, txNumber to);
 static void fxReduceThisItem(txMachine* the, txSlot* function, txIndex index);
+static void fxReserveSortItems(txMachine* the, txSorter* sorter, txInteger count);
 static txBoolean fxSetArrayLength(txMachine* the, txSlot* array, txIndex target);
 static void fx_Array_from_aux(txMachine* the, txSlot* function, txSlot* value, txIndex index);
 static txIndex fx_Array_prototype_flatAux(txMachine* the, txSlot* source, txIndex length, txIndex start, txIndex depth, txSlot* function);
@@ -335,50 +347,447 @@ txIndex fxCheckArrayLength(txMachine* the, txSlot* slot)
 	return 0;
 }
 
-int fxCompareArrayItem(txMachine* the, txSlot* function, txSlot* array, txInteger i)
+void fxCollapseSortRuns(txMachine* the, txSorter* sorter, txBoolean force)
 {
-	txSlot* address = array->value.array.address;
-	txSlot* a = address + i;
-	txSlot* b = the->stack;
-	int result;
-	
+	txInteger* lengths = sorter->runLengths;
+	while (sorter->runCount > 1) {
+		txInteger n = sorter->runCount - 2;
+		if (force) {
+			if ((n > 0) && (lengths[n - 1] < lengths[n + 1]))
+				n--;
+		}
+		else if (((n > 0) && (lengths[n - 1] <= lengths[n] + lengths[n + 1])) || ((n > 1) && (lengths[n - 2] <= lengths[n - 1] + lengths[n]))) {
+			if (lengths[n - 1] < lengths[n + 1])
+				n--;
+		}
+		else if (lengths[n] > lengths[n + 1])
+			break;
+		fxMergeSortAt(the, sorter, n);
+	}
+}
+
+txInteger fxCompareSortItems(txMachine* the, txSlot* function, txSlot* a, txSlot* b)
+{
+	txInteger result;
 	if (a->kind == XS_UNDEFINED_KIND)
-		result = (b->kind == XS_UNDEFINED_KIND) ? 0 : 1;
-	else if (b->kind == XS_UNDEFINED_KIND)
-		result = -1;
+		return (b->kind == XS_UNDEFINED_KIND) ? 0 : 1;
+	if (b->kind == XS_UNDEFINED_KIND)
+		return -1;
+	/* the items can move while the function runs, so the arguments are pushed first */
+	if (function) {
+		/* THIS */
+		mxPushUndefined();
+		/* FUNCTION */
+		mxPushSlot(function);
+		mxCall();
+		/* ARGUMENTS */
+		mxPushSlot(a);
+		mxPushSlot(b);
+		mxRunCount(2);
+		if (the->stack->kind == XS_INTEGER_KIND)
+			result = the->stack->value.integer;
+		else {
+			txNumber number = fxToNumber(the, the->stack);
+			result = (number < 0) ? -1 :  (number > 0) ? 1 : 0;
+		}
+		mxPop();
+	}
 	else {
-		if (function) {
-			/* THIS */
-			mxPushUndefined();
-			/* FUNCTION */
-			mxPushSlot(function);
-			mxCall();
-			/* ARGUMENTS */
-			mxPushSlot(a);
-			mxPushSlot(b);
-			mxRunCount(2);
-			if (the->stack->kind == XS_INTEGER_KIND)
-				result = the->stack->value.integer;
+		mxPushSlot(a);
+		mxPushSlot(b);
+		fxToString(the, the->stack + 1);
+		fxToString(the, the->stack);
+		result = c_strcmp((the->stack + 1)->value.string, the->stack->value.string);
+		mxPop();
+		mxPop();
+		mxMeterSome(3);
+	}
+	return result;
+}
+
+txInteger fxCountSortRun(txMachine* the, txSorter* sorter, txInteger low, txInteger high)
+{
+	txSlot* list = sorter->list;
+	txInteger index = low + 1;
+	if (index == high)
+		return 1;
+	if (mxSortCompare(mxSortItem(list, index), mxSortItem(list, low)) < 0) {
+		index++;
+		while ((index < high) && (mxSortCompare(mxSortItem(list, index), mxSortItem(list, index - 1)) < 0))
+			index++;
+		/* strictly descending, so reversing keeps the sort stable */
+		{
+			txSlot* from = mxSortItem(list, low);
+			txSlot* to = mxSortItem(list, index - 1);
+			txSlot swap;
+			while (from < to) {
+				swap = *from;
+				*from++ = *to;
+				*to-- = swap;
+			}
+		}
+	}
+	else {
+		index++;
+		while ((index < high) && (mxSortCompare(mxSortItem(list, index), mxSortItem(list, index - 1)) >= 0))
+			index++;
+	}
+	return index - low;
+}
+
+txInteger fxGallopSortLeft(txMachine* the, txSorter* sorter, txSlot* key, txSlot* array, txInteger base, txInteger length, txInteger hint)
+{
+	txInteger former = 0, offset = 1, limit, middle;
+	if (mxSortCompare(key, mxSortItem(array, base + hint)) > 0) {
+		limit = length - hint;
+		while ((offset < limit) && (mxSortCompare(key, mxSortItem(array, base + hint + offset)) > 0)) {
+			former = offset;
+			offset = (offset << 1) + 1;
+		}
+		if (offset > limit)
+			offset = limit;
+		former += hint;
+		offset += hint;
+	}
+	else {
+		limit = hint + 1;
+		while ((offset < limit) && (mxSortCompare(key, mxSortItem(array, base + hint - offset)) <= 0)) {
+			former = offset;
+			offset = (offset << 1) + 1;
+		}
+		if (offset > limit)
+			offset = limit;
+		middle = former;
+		former = hint - offset;
+		offset = hint - middle;
+	}
+	former++;
+	while (former < offset) {
+		middle = former + ((offset - former) >> 1);
+		if (mxSortCompare(key, mxSortItem(array, base + middle)) > 0)
+			former = middle + 1;
+		else
+			offset = middle;
+	}
+	return offset;
+}
+
+txInteger fxGallopSortRight(txMachine* the, txSorter* sorter, txSlot* key, txSlot* array, txInteger base, txInteger length, txInteger hint)
+{
+	txInteger former = 0, offset = 1, limit, middle;
+	if (mxSortCompare(key, mxSortItem(array, base + hint)) < 0) {
+		limit = hint + 1;
+		while ((offset < limit) && (mxSortCompare(key, mxSortItem(array, base + hint - offset)) < 0)) {
+			former = offset;
+			offset = (offset << 1) + 1;
+		}
+		if (offset > limit)
+			offset = limit;
+		middle = former;
+		former = hint - offset;
+		offset = hint - middle;
+	}
+	else {
+		limit = length - hint;
+		while ((offset < limit) && (mxSortCompare(key, mxSortItem(array, base + hint + offset)) >= 0)) {
+			former = offset;
+			offset = (offset << 1) + 1;
+		}
+		if (offset > limit)
+			offset = limit;
+		former += hint;
+		offset += hint;
+	}
+	former++;
+	while (former < offset) {
+		middle = former + ((offset - former) >> 1);
+		if (mxSortCompare(key, mxSortItem(array, base + middle)) < 0)
+			offset = middle;
+		else
+			former = middle + 1;
+	}
+	return offset;
+}
+
+void fxInsertSortItems(txMachine* the, txSorter* sorter, txInteger low, txInteger high, txInteger start)
+{
+	txSlot* list = sorter->list;
+	txSlot* pivot;
+	txSlot* item;
+	if (start == low)
+		start++;
+	while (start < high) {
+		txInteger left = low, right = start, middle;
+		mxPushSlot(mxSortItem(list, start));
+		pivot = the->stack;
+		while (left < right) {
+			middle = left + ((right - left) >> 1);
+			if (mxSortCompare(pivot, mxSortItem(list, middle)) < 0)
+				right = middle;
+			else
+				left = middle + 1;
+		}
+		mxSortCopy(mxSortItem(list, left + 1), mxSortItem(list, left), start - left);
+		item = mxSortItem(list, left);
+		item->kind = pivot->kind;
+		item->value = pivot->value;
+		mxPop();
+		start++;
+	}
+}
+
+void fxMergeSortAt(txMachine* the, txSorter* sorter, txInteger i)
+{
+	txSlot* list = sorter->list;
+	txInteger base1 = sorter->runBases[i];
+	txInteger length1 = sorter->runLengths[i];
+	txInteger base2 = sorter->runBases[i + 1];
+	txInteger length2 = sorter->runLengths[i + 1];
+	txInteger count;
+	sorter->runLengths[i] = length1 + length2;
+	if (i == sorter->runCount - 3) {
+		sorter->runBases[i + 1] = sorter->runBases[i + 2];
+		sorter->runLengths[i + 1] = sorter->runLengths[i + 2];
+	}
+	sorter->runCount--;
+	/* the items of the first run that precede the second run, and the items of the second run that follow the first run, are in place */
+	mxPushSlot(mxSortItem(list, base2));
+	count = fxGallopSortRight(the, sorter, the->stack, list, base1, length1, 0);
+	mxPop();
+	base1 += count;
+	length1 -= count;
+	if (length1 == 0)
+		return;
+	mxPushSlot(mxSortItem(list, base1 + length1 - 1));
+	length2 = fxGallopSortLeft(the, sorter, the->stack, list, base2, length2, length2 - 1);
+	mxPop();
+	if (length2 == 0)
+		return;
+	if (length1 <= length2)
+		fxMergeSortLow(the, sorter, base1, length1, base2, length2);
+	else
+		fxMergeSortHigh(the, sorter, base1, length1, base2, length2);
+}
+
+void fxMergeSortHigh(txMachine* the, txSorter* sorter, txInteger base1, txInteger length1, txInteger base2, txInteger length2)
+{
+	txSlot* list = sorter->list;
+	txSlot* temp = sorter->temp;
+	txInteger cursor1 = base1 + length1 - 1;
+	txInteger cursor2 = length2 - 1;
+	txInteger target = base2 + length2 - 1;
+	txInteger minGallop = sorter->minGallop;
+	txInteger count1, count2;
+	fxReserveSortItems(the, sorter, length2);
+	mxSortCopy(mxSortItem(temp, 0), mxSortItem(list, base2), length2);
+	*mxSortItem(list, target--) = *mxSortItem(list, cursor1--);
+	if ((--length1 == 0) || (length2 == 1))
+		goto bail;
+	for (;;) {
+		count1 = 0;
+		count2 = 0;
+		do {
+			if (mxSortCompare(mxSortItem(temp, cursor2), mxSortItem(list, cursor1)) < 0) {
+				*mxSortItem(list, target--) = *mxSortItem(list, cursor1--);
+				count1++;
+				count2 = 0;
+				if (--length1 == 0)
+					goto bail;
+			}
 			else {
-				txNumber number = fxToNumber(the, the->stack);
-				result = (number < 0) ? -1 :  (number > 0) ? 1 : 0;
+				*mxSortItem(list, target--) = *mxSortItem(temp, cursor2--);
+				count2++;
+				count1 = 0;
+				if (--length2 == 1)
+					goto bail;
 			}
+		} while ((count1 | count2) < minGallop);
+		do {
+			mxPushSlot(mxSortItem(temp, cursor2));
+			count1 = length1 - fxGallopSortRight(the, sorter, the->stack, list, base1, length1, length1 - 1);
 			mxPop();
-		}
-		else {
-			mxPushSlot(a);
-			mxPushSlot(b);
-			fxToString(the, the->stack + 1);
-			fxToString(the, the->stack);
-			result = c_strcmp((the->stack + 1)->value.string, the->stack->value.string);
+			if (count1) {
+				target -= count1;
+				cursor1 -= count1;
+				length1 -= count1;
+				mxSortCopy(mxSortItem(list, target + 1), mxSortItem(list, cursor1 + 1), count1);
+				if (length1 == 0)
+					goto bail;
+			}
+			*mxSortItem(list, target--) = *mxSortItem(temp, cursor2--);
+			if (--length2 == 1)
+				goto bail;
+			mxPushSlot(mxSortItem(list, cursor1));
+			count2 = length2 - fxGallopSortLeft(the, sorter, the->stack, temp, 0, length2, length2 - 1);
 			mxPop();
+			if (count2) {
+				target -= count2;
+				cursor2 -= count2;
+				length2 -= count2;
+				mxSortCopy(mxSortItem(list, target + 1), mxSortItem(temp, cursor2 + 1), count2);
+				if (length2 <= 1)
+					goto bail;
+			}
+			*mxSortItem(list, target--) = *mxSortItem(list, cursor1--);
+			if (--length1 == 0)
+				goto bail;
+			minGallop--;
+		} while ((count1 >= mxSortMinGallop) || (count2 >= mxSortMinGallop));
+		if (minGallop < 0)
+			minGallop = 0;
+		minGallop += 2;
+	}
+bail:
+	sorter->minGallop = (minGallop < 1) ? 1 : minGallop;
+	if (length2 == 1) {
+		target -= length1;
+		cursor1 -= length1;
+		mxSortCopy(mxSortItem(list, target + 1), mxSortItem(list, cursor1 + 1), length1);
+		*mxSortItem(list, target) = *mxSortItem(temp, cursor2);
+	}
+	else if (length2 > 0)
+		mxSortCopy(mxSortItem(list, target - (length2 - 1)), mxSortItem(temp, 0), length2);
+	/* else the function is inconsistent and the remaining items are already in place */
+}
+
+void fxMergeSortLow(txMachine* the, txSorter* sorter, txInteger base1, txInteger length1, txInteger base2, txInteger length2)
+{
+	txSlot* list = sorter->list;
+	txSlot* temp = sorter->temp;
+	txInteger cursor1 = 0;
+	txInteger cursor2 = base2;
+	txInteger target = base1;
+	txInteger minGallop = sorter->minGallop;
+	txInteger count1, count2;
+	fxReserveSortItems(the, sorter, length1);
+	mxSortCopy(mxSortItem(temp, 0), mxSortItem(list, base1), length1);
+	*mxSortItem(list, target++) = *mxSortItem(list, cursor2++);
+	if ((--length2 == 0) || (length1 == 1))
+		goto bail;
+	for (;;) {
+		count1 = 0;
+		count2 = 0;
+		do {
+			if (mxSortCompare(mxSortItem(list, cursor2), mxSortItem(temp, cursor1)) < 0) {
+				*mxSortItem(list, target++) = *mxSortItem(list, cursor2++);
+				count2++;
+				count1 = 0;
+				if (--length2 == 0)
+					goto bail;
+			}
+			else {
+				*mxSortItem(list, target++) = *mxSortItem(temp, cursor1++);
+				count1++;
+				count2 = 0;
+				if (--length1 == 1)
+					goto bail;
+			}
+		} while ((count1 | count2) < minGallop);
+		do {
+			mxPushSlot(mxSortItem(list, cursor2));
+			count1 = fxGallopSortRight(the, sorter, the->stack, temp, cursor1, length1, 0);
 			mxPop();
-			mxMeterSome(3);
-		}
+			if (count1) {
+				mxSortCopy(mxSortItem(list, target), mxSortItem(temp, cursor1), count1);
+				target += count1;
+				cursor1 += count1;
+				length1 -= count1;
+				if (length1 <= 1)
+					goto bail;
+			}
+			*mxSortItem(list, target++) = *mxSortItem(list, cursor2++);
+			if (--length2 == 0)
+				goto bail;
+			mxPushSlot(mxSortItem(temp, cursor1));
+			count2 = fxGallopSortLeft(the, sorter, the->stack, list, cursor2, length2, 0);
+			mxPop();
+			if (count2) {
+				mxSortCopy(mxSortItem(list, target), mxSortItem(list, cursor2), count2);
+				target += count2;
+				cursor2 += count2;
+				length2 -= count2;
+				if (length2 == 0)
+					goto bail;
+			}
+			*mxSortItem(list, target++) = *mxSortItem(temp, cursor1++);
+			if (--length1 == 1)
+				goto bail;
+			minGallop--;
+		} while ((count1 >= mxSortMinGallop) || (count2 >= mxSortMinGallop));
+		if (minGallop < 0)
+			minGallop = 0;
+		minGallop += 2;
+	}
+bail:
+	sorter->minGallop = (minGallop < 1) ? 1 : minGallop;
+	if (length1 == 1) {
+		mxSortCopy(mxSortItem(list, target), mxSortItem(list, cursor2), length2);
+		*mxSortItem(list, target + length2) = *mxSortItem(temp, cursor1);
+	}
+	else if (length1 > 0)
+		mxSortCopy(mxSortItem(list, target), mxSortItem(temp, cursor1), length1);
+	/* else the function is inconsistent and the remaining items are already in place */
+}
+
+void fxReserveSortItems(txMachine* the, txSorter* sorter, txInteger count)
+{
+	txSlot* temp = sorter->temp;
+	if ((txInteger)temp->value.array.length < count) {
+		txInteger size = 16;
+		while (size < count)
+			size <<= 1;
+		if (size > (sorter->length >> 1))
+			size = sorter->length >> 1;
+		if (size < count)
+			size = count;
+		fxSetIndexSize(the, temp, (txIndex)size, XS_CHUNK);
+	}
+}
+
+void fxSortArrayItems(txMachine* the, txSlot* function, txSlot* list)
+{
+	/* TimSort: natural runs, extended to a minimum length by binary insertion, then merged with galloping */
+	txSorter sorter;
+	txInteger length = (txInteger)list->value.array.length;
+	txInteger base = 0, count, minRun, run, flag = 0;
+	if (length < 2)
+		return;
+	sorter.function = function;
+	sorter.list = list;
+	sorter.temp = C_NULL;
+	sorter.length = length;
+	sorter.minGallop = mxSortMinGallop;
+	sorter.runCount = 0;
+	if (length < mxSortMinMerge) {
+		run = fxCountSortRun(the, &sorter, 0, length);
+		fxInsertSortItems(the, &sorter, 0, length, run);
+		return;
 	}
-	if (result == 0)
-		result = (b->next > a->next) ? -1 : (b->next < a->next) ? 1 : 0;
-	return result;
+	mxPush(mxArrayPrototype);
+	sorter.temp = fxNewArrayInstance(the)->next;
+	count = length;
+	while (count >= mxSortMinMerge) {
+		flag |= count & 1;
+		count >>= 1;
+	}
+	minRun = count + flag;
+	count = length;
+	do {
+		run = fxCountSortRun(the, &sorter, base, base + count);
+		if (run < minRun) {
+			txInteger force = (count <= minRun) ? count : minRun;
+			fxInsertSortItems(the, &sorter, base, base + force, base + run);
+			run = force;
+		}
+		sorter.runBases[sorter.runCount] = base;
+		sorter.runLengths[sorter.runCount] = run;
+		sorter.runCount++;
+		fxCollapseSortRuns(the, &sorter, 0);
+		base += run;
+		count -= run;
+	} while (count);
+	fxCollapseSortRuns(the, &sorter, 1);
+	mxPop();
 }
 
 void fxConstructArrayEntry(txMachine* the, txSlot* entry)
@@ -2084,10 +2493,11 @@ void fx_Array_prototype_sort(txMachine* the)
 {
 	txSlot* array = fxCheckArray(the, mxThis, XS_MUTABLE);
 	txSlot* function = C_NULL;
- 	txNumber LENGTH;
- 	txIndex index, length, size;
-	txSlot* instance = C_NULL;
-    txSlot* item;
+	txNumber LENGTH;
+	txIndex index, length;
+	txSlot* instance;
+	txSlot* list;
+	txSlot* item;
 	if (mxArgc > 0) {
 		txSlot* slot = mxArgv(0);
 		if (slot->kind != XS_UNDEFINED_KIND) {
@@ -2099,22 +2509,30 @@ void fx_Array_prototype_sort(txMachine* the)
 	}
 	if (array)
 		array = fxCheckArrayItems(the, array, 0, array->value.array.length);
-again:
-	if (!array) {
+	/* the items are sorted in a list, then written back */
+	mxPush(mxArrayPrototype);
+	instance = fxNewArrayInstance(the);
+	list = instance->next;
+	if (array) {
+		LENGTH = length = array->value.array.length;
+		if (length) {
+			fxSetIndexSize(the, list, length, XS_CHUNK);
+			c_memcpy(list->value.array.address, array->value.array.address, length * sizeof(txSlot));
+			mxMeterSome(length * 10);
+		}
+	}
+	else {
 		LENGTH = fxGetArrayLength(the, mxThis);
 		if (LENGTH > 0xFFFFFFFF)
 			mxRangeError("array overflow");
-		mxPush(mxArrayPrototype);
-		instance = fxNewArrayInstance(the);
-		array = instance->next;
-		item = array;
-        index = 0;
+		item = list;
+		index = 0;
 		while (index < LENGTH) {
 			mxPushSlot(mxThis);
 			if (fxHasIndex(the, index)) {
 				item->next = fxNewSlot(the);
 				item = item->next;
-				array->value.array.length++;
+				list->value.array.length++;
 				mxPushSlot(mxThis);
 				mxGetIndex(index);
 				mxPullSlot(item);
@@ -2122,129 +2540,23 @@ again:
 			index++;
 		}
 		fxCacheArray(the, instance);
+		length = list->value.array.length;
 	}
-	length = array->value.array.length;
-	size = mxArraySize(array);
-	/* like GCC qsort */
-	#define CHECK \
-		if (size != mxArraySize(array)) { \
-			array = C_NULL; \
-			goto again; \
-		}
-	#define COMPARE(INDEX) \
-		fxCompareArrayItem(the, function, array, INDEX)
-	#define COPY \
-		to->next = from->next; \
-		to->ID = from->ID; \
-		to->kind = from->kind; \
-		to->value = from->value
-	#define MOVE(FROM,TO) \
-		from = array->value.array.address + (FROM); \
-		to = array->value.array.address + (TO); \
-		COPY
-	#define PUSH(INDEX) \
-		from = array->value.array.address + (INDEX); \
-		mxPushUndefined(); \
-		to = the->stack; \
-		COPY
-	#define PULL(INDEX) \
-		from = the->stack++; \
-		to = array->value.array.address + (INDEX); \
-		COPY
-	if (length > 0) {
-		txIndex i, j;
-		txSlot* from;
-		txSlot* to;
-		if (length > mxSortThreshold) {
-			txIndex lo = 0, hi = length - 1;
-			txSortPartition stack[mxSortStackSize];
-			txSortPartition *top = stack + 1;
-			while (stack < top) {
-				txIndex mid = lo + ((hi - lo) >> 1);
-				PUSH(mid);
-				if (COMPARE(lo) > 0) {
-					CHECK;
-					MOVE(lo, mid);
-					PULL(lo);
-					PUSH(mid);
-				}
-				else
-					CHECK;
-				if (COMPARE(hi) < 0) {
-					CHECK;
-					MOVE(hi, mid);
-					PULL(hi);
-					PUSH(mid);
-					if (COMPARE(lo) > 0) {
-						CHECK;
-						MOVE(lo, mid);
-						PULL(lo);
-						PUSH(mid);
-					}
-					else
-						CHECK;
-				}
-				else
-					CHECK;
-				i = lo + 1;
-				j = hi - 1;
-				do {
-					while ((COMPARE(i) < 0) && (i <= j)) { CHECK; i++; }
-					while ((COMPARE(j) > 0) && (i <= j)) { CHECK; j--; }
-					if (i < j) {
-						PUSH(i);
-						MOVE(j, i);
-						PULL(j);
-						i++;
-						j--;
-					}
-					else if (i == j) {
-						i++;
-						j--;
-						break;
-					}
-				} while (i <= j);
-				if ((j - lo) <= mxSortThreshold) {
-					if ((hi - i) <= mxSortThreshold) {
-						top--;
-						lo = top->lo; 
-						hi = top->hi;
-					}
-					else {
-						lo = i;
-					}
-				}
-				else if ((hi - i) <= mxSortThreshold) {
-					hi = j;
-				}
-				else if ((j - lo) > (hi - i)) {
-					top->lo = lo;
-					top->hi = j; 
-					top++;
-					lo = i;
-				}
-				else {
-					top->lo = i;
-					top->hi = hi; 
-					top++;
-					hi = j;
-				}
-			}
-		}
-		for (i = 1; i < length; i++) {
-			PUSH(i);
-			for (j = i; (j > 0) && (COMPARE(j - 1) > 0); j--) {
-				CHECK;
-				MOVE(j - 1, j);
-			}
-            CHECK;
-			PULL(j);
+	fxSortArrayItems(the, function, list);
+	array = fxCheckArray(the, mxThis, XS_MUTABLE);
+	if (array)
+		array = fxCheckArrayItems(the, array, 0, array->value.array.length);
+	if (array && (array->value.array.length == length) && (length == LENGTH)) {
+		if (length) {
+			c_memcpy(array->value.array.address, list->value.array.address, length * sizeof(txSlot));
+			fxIndexArray(the, array);
+			mxMeterSome(length * 10);
 		}
 	}
-	if (instance) {
+	else {
 		index = 0;
 		while (index < length) {
-			item = array->value.array.address + index;
+			item = list->value.array.address + index;
 			mxPushSlot(item);
 			mxPushSlot(mxThis);
 			mxSetIndex(index);
@@ -2256,10 +2568,8 @@ again:
 			mxDeleteIndex(index);
 			index++;
 		}
-		mxPop();
 	}
-	else
-		fxIndexArray(the, array);
+	mxPop();
 	mxResult->kind = mxThis->kind;
 	mxResult->value = mxThis->value;
 }
@@ -1469,9 +1469,365 @@ txBigInt *fxBigInt_usub(txMachine* the, txBigInt *rr, txBigInt *aa, txBigInt *bb
 	return(rr);
 }
 
+/*
+ * limbs
+ *
+ * multiplications, squarings and divisions copy their operands into limbs, which are 64-bit words when the compiler has 128-bit integers, and compute there. The limbs and their temporary buffers are in the free part of the stack, or allocated when it is too small.
+ */
+
+#if mxBigInt64
+typedef txU8 txBigLimb;
+typedef unsigned __int128 txBigLimbs;
+#define mxBigLimbCount(N) (((N) + 1) >> 1)
+#else
+typedef txU4 txBigLimb;
+typedef txU8 txBigLimbs;
+#define mxBigLimbCount(N) (N)
+#endif
+#define mxBigLimbSize (sizeof(txBigLimb) * 8)
+
+static txBigLimb* fxBigLimb_alloc(txMachine* the, txSize count, txBoolean* allocated);
+static void fxBigLimb_free(txMachine* the, txBigLimb* limbs, txBoolean allocated);
+static void fxBigLimb_load(txBigLimb* r, txU4* data, int size);
+static void fxBigLimb_store(txU4* data, txBigLimb* a, int size);
+static txBigLimb fxBigLimb_add(txBigLimb* r, txBigLimb* a, txBigLimb* b, int n);
+static txBigLimb fxBigLimb_add1(txBigLimb* r, int n, txBigLimb c);
+static txBigLimb fxBigLimb_sub(txBigLimb* r, txBigLimb* a, txBigLimb* b, int n);
+static int fxBigLimb_diff(txBigLimb* r, txBigLimb* a, int an, txBigLimb* b, int bn);
+static txBigLimb fxBigLimb_addmul1(txBigLimb* r, txBigLimb* a, int n, txBigLimb b);
+static txBigLimb fxBigLimb_submul1(txBigLimb* r, txBigLimb* a, int n, txBigLimb b);
+static void fxBigLimb_mul(txBigLimb* r, txBigLimb* a, int an, txBigLimb* b, int bn, txBigLimb* t);
+static void fxBigLimb_mul_basecase(txBigLimb* r, txBigLimb* a, int an, txBigLimb* b, int bn);
+static void fxBigLimb_mul_karatsuba(txBigLimb* r, txBigLimb* a, txBigLimb* b, int n, txBigLimb* t);
+static int fxBigLimb_mul_size(int an, int bn);
+static void fxBigLimb_sqr(txBigLimb* r, txBigLimb* a, int n, txBigLimb* t);
+static void fxBigLimb_sqr_basecase(txBigLimb* r, txBigLimb* a, int n);
+static int fxBigLimb_sqr_size(int n);
+static void fxBigLimb_div(txBigLimb* q, txBigLimb* u, int un, txBigLimb* v, int vn);
+
+txBigLimb* fxBigLimb_alloc(txMachine* the, txSize count, txBoolean* allocated)
+{
+	txSize size = count * sizeof(txBigLimb);
+	txBigLimb* limbs;
+#ifdef mxRun
+	if (the && (((txByte*)(the->stackBottom) + size) < (txByte*)(the->stack))) {
+		*allocated = 0;
+		return (txBigLimb*)(the->stackBottom);
+	}
+#endif
+	limbs = c_malloc(size);
+	if (!limbs) {
+#ifdef mxRun
+		fxAbort(the, XS_NOT_ENOUGH_MEMORY_EXIT);
+#endif
+		/* without a machine, the callers return NULL, like fxBigInt_alloc */
+		return NULL;
+	}
+	*allocated = 1;
+	return limbs;
+}
+
+void fxBigLimb_free(txMachine* the, txBigLimb* limbs, txBoolean allocated)
+{
+	if (allocated)
+		c_free(limbs);
+}
+
+void fxBigLimb_load(txBigLimb* r, txU4* data, int size)
+{
+	r[mxBigLimbCount(size) - 1] = 0;
+	c_memcpy(r, data, size * sizeof(txU4));
+}
+
+void fxBigLimb_store(txU4* data, txBigLimb* a, int size)
+{
+	c_memcpy(data, a, size * sizeof(txU4));
+}
+
+txBigLimb fxBigLimb_add(txBigLimb* r, txBigLimb* a, txBigLimb* b, int n)
+{
+	txBigLimb c = 0;
+	int i;
+	for (i = 0; i < n; i++) {
+		txBigLimb x = a[i] + c;
+		c = x < c;
+		x += b[i];
+		c += x < b[i];
+		r[i] = x;
+	}
+	return c;
+}
+
+txBigLimb fxBigLimb_add1(txBigLimb* r, int n, txBigLimb c)
+{
+	int i;
+	for (i = 0; c && (i < n); i++) {
+		r[i] += c;
+		c = r[i] < c;
+	}
+	return c;
+}
+
+txBigLimb fxBigLimb_sub(txBigLimb* r, txBigLimb* a, txBigLimb* b, int n)
+{
+	txBigLimb c = 0;
+	int i;
+	for (i = 0; i < n; i++) {
+		txBigLimb x = a[i];
+		txBigLimb y = x - b[i];
+		txBigLimb z = y - c;
+		c = (x < b[i]) | (y < c);
+		r[i] = z;
+	}
+	return c;
+}
+
+int fxBigLimb_diff(txBigLimb* r, txBigLimb* a, int an, txBigLimb* b, int bn)
+{
+	/* r = |a - b| in an limbs, with an >= bn, returns 1 if a < b */
+	int i = an;
+	while (i > bn) {
+		i--;
+		if (a[i]) {
+			txBigLimb c = fxBigLimb_sub(r, a, b, bn);
+			for (i = bn; i < an; i++) {
+				r[i] = a[i] - c;
+				c = a[i] < c;
+			}
+			return 0;
+		}
+	}
+	while (i > 0) {
+		i--;
+		if (a[i] != b[i])
+			break;
+	}
+	for (i = bn; i < an; i++)
+		r[i] = 0;
+	if (fxBigLimb_sub(r, a, b, bn)) {
+		fxBigLimb_sub(r, b, a, bn);
+		return 1;
+	}
+	return 0;
+}
+
+txBigLimb fxBigLimb_addmul1(txBigLimb* r, txBigLimb* a, int n, txBigLimb b)
+{
+	txBigLimb c = 0;
+	int i;
+	for (i = 0; i < n; i++) {
+		txBigLimbs x = ((txBigLimbs)a[i] * b) + r[i] + c;
+		r[i] = (txBigLimb)x;
+		c = (txBigLimb)(x >> mxBigLimbSize);
+	}
+	return c;
+}
+
+txBigLimb fxBigLimb_submul1(txBigLimb* r, txBigLimb* a, int n, txBigLimb b)
+{
+	txBigLimb c = 0;
+	int i;
+	for (i = 0; i < n; i++) {
+		txBigLimbs x = ((txBigLimbs)a[i] * b) + c;
+		txBigLimb y = (txBigLimb)x;
+		c = (txBigLimb)(x >> mxBigLimbSize);
+		c += r[i] < y;
+		r[i] -= y;
+	}
+	return c;
+}
+
+void fxBigLimb_mul(txBigLimb* r, txBigLimb* a, int an, txBigLimb* b, int bn, txBigLimb* t)
+{
+	/* r = a * b in an + bn limbs, with an >= bn, t is fxBigLimb_mul_size(an, bn) limbs */
+	int i, n;
+	if (bn < mxBigIntKaratsuba)
+		fxBigLimb_mul_basecase(r, a, an, b, bn);
+	else if (an == bn)
+		fxBigLimb_mul_karatsuba(r, a, b, bn, t);
+	else {
+		/* multiply b by slices of a */
+		fxBigLimb_mul_karatsuba(r, a, b, bn, t + (2 * bn));
+		c_memset(r + (2 * bn), 0, (an - bn) * sizeof(txBigLimb));
+		for (i = bn; i < an; i += bn) {
+			n = an - i;
+			if (n >= bn) {
+				n = bn;
+				fxBigLimb_mul_karatsuba(t, a + i, b, bn, t + (2 * bn));
+			}
+			else
+				fxBigLimb_mul(t, b, bn, a + i, n, t + (2 * bn));
+			fxBigLimb_add1(r + i + bn + n, an - i - n, fxBigLimb_add(r + i, r + i, t, bn + n));
+		}
+	}
+}
+
+void fxBigLimb_mul_basecase(txBigLimb* r, txBigLimb* a, int an, txBigLimb* b, int bn)
+{
+	int j;
+	c_memset(r, 0, an * sizeof(txBigLimb));
+	for (j = 0; j < bn; j++)
+		r[an + j] = fxBigLimb_addmul1(r + j, a, an, b[j]);
+}
+
+void fxBigLimb_mul_karatsuba(txBigLimb* r, txBigLimb* a, txBigLimb* b, int n, txBigLimb* t)
+{
+	/* a * b = a0b0 + ((a0b0 + a1b1 - (a0 - a1)(b0 - b1)) << l) + (a1b1 << 2l) */
+	int h, l, sign;
+	txBigLimb c;
+	if (n < mxBigIntKaratsuba) {
+		fxBigLimb_mul_basecase(r, a, n, b, n);
+		return;
+	}
+	h = n >> 1;
+	l = n - h;
+	sign = fxBigLimb_diff(t, a, l, a + l, h);
+	sign ^= fxBigLimb_diff(t + l, b, l, b + l, h);
+	fxBigLimb_mul_karatsuba(t + (2 * l) + 1, t, t + l, l, t + (4 * l) + 1);
+	fxBigLimb_mul_karatsuba(r, a, b, l, t + (4 * l) + 1);
+	fxBigLimb_mul_karatsuba(r + (2 * l), a + l, b + l, h, t + (4 * l) + 1);
+	c = fxBigLimb_add(t, r, r + (2 * l), 2 * h);
+	c_memcpy(t + (2 * h), r + (2 * h), (2 * (l - h)) * sizeof(txBigLimb));
+	t[2 * l] = fxBigLimb_add1(t + (2 * h), 2 * (l - h), c);
+	if (sign)
+		t[2 * l] += fxBigLimb_add(t, t, t + (2 * l) + 1, 2 * l);
+	else
+		t[2 * l] -= fxBigLimb_sub(t, t, t + (2 * l) + 1, 2 * l);
+	fxBigLimb_add1(r + (3 * l) + 1, (2 * h) - l - 1, fxBigLimb_add(r + l, r + l, t, (2 * l) + 1));
+}
+
+int fxBigLimb_mul_size(int an, int bn)
+{
+	int size, n;
+	if (bn < mxBigIntKaratsuba)
+		return 0;
+	size = 0;
+	n = bn;
+	while (n >= mxBigIntKaratsuba) {
+		n -= n >> 1;
+		size += (4 * n) + 1;
+	}
+	if (an > bn) {
+		n = an % bn;
+		if (n) {
+			n = fxBigLimb_mul_size(bn, n);
+			if (size < n)
+				size = n;
+		}
+		size += 2 * bn;
+	}
+	return size;
+}
+
+void fxBigLimb_sqr(txBigLimb* r, txBigLimb* a, int n, txBigLimb* t)
+{
+	/* a * a = a0a0 + ((a0a0 + a1a1 - (a0 - a1)(a0 - a1)) << l) + (a1a1 << 2l) */
+	int h, l;
+	txBigLimb c;
+	if (n < mxBigIntKaratsuba) {
+		fxBigLimb_sqr_basecase(r, a, n);
+		return;
+	}
+	h = n >> 1;
+	l = n - h;
+	fxBigLimb_diff(t, a, l, a + l, h);
+	fxBigLimb_sqr(t + (2 * l) + 1, t, l, t + (4 * l) + 1);
+	fxBigLimb_sqr(r, a, l, t + (4 * l) + 1);
+	fxBigLimb_sqr(r + (2 * l), a + l, h, t + (4 * l) + 1);
+	c = fxBigLimb_add(t, r, r + (2 * l), 2 * h);
+	c_memcpy(t + (2 * h), r + (2 * h), (2 * (l - h)) * sizeof(txBigLimb));
+	t[2 * l] = fxBigLimb_add1(t + (2 * h), 2 * (l - h), c);
+	t[2 * l] -= fxBigLimb_sub(t, t, t + (2 * l) + 1, 2 * l);
+	fxBigLimb_add1(r + (3 * l) + 1, (2 * h) - l - 1, fxBigLimb_add(r + l, r + l, t, (2 * l) + 1));
+}
+
+void fxBigLimb_sqr_basecase(txBigLimb* r, txBigLimb* a, int n)
+{
+	txBigLimb c;
+	int i;
+	/* the products of different limbs, twice, then the squares of each limb */
+	c_memset(r, 0, 2 * n * sizeof(txBigLimb));
+	for (i = 0; i < n - 1; i++)
+		r[n + i] = fxBigLimb_addmul1(r + (2 * i) + 1, a + i + 1, n - i - 1, a[i]);
+	c = 0;
+	for (i = 0; i < 2 * n; i++) {
+		txBigLimb x = r[i];
+		r[i] = (x << 1) | c;
+		c = x >> (mxBigLimbSize - 1);
+	}
+	c = 0;
+	for (i = 0; i < n; i++) {
+		txBigLimbs x = (txBigLimbs)a[i] * a[i];
+		txBigLimbs y = (txBigLimbs)r[2 * i] + (txBigLimb)x + c;
+		r[2 * i] = (txBigLimb)y;
+		y = (txBigLimbs)r[(2 * i) + 1] + (txBigLimb)(x >> mxBigLimbSize) + (txBigLimb)(y >> mxBigLimbSize);
+		r[(2 * i) + 1] = (txBigLimb)y;
+		c = (txBigLimb)(y >> mxBigLimbSize);
+	}
+}
+
+int fxBigLimb_sqr_size(int n)
+{
+	int size = 0;
+	while (n >= mxBigIntKaratsuba) {
+		n -= n >> 1;
+		size += (4 * n) + 1;
+	}
+	return size;
+}
+
+#if !mxBigInt64 && BN_NO_ULDIVMOD
+static txU8 div64_32(txU8 a, txU4 b);
+#define mxBigLimbDivide(X, Y) div64_32(X, Y)
+#else
+#define mxBigLimbDivide(X, Y) ((X) / (Y))
+#endif
+
+void fxBigLimb_div(txBigLimb* q, txBigLimb* u, int un, txBigLimb* v, int vn)
+{
+	/* Knuth, The Art of Computer Programming, 4.3.1, algorithm D: u is un + 1 limbs and v is normalized, q is un - vn + 1 limbs and the remainder is left in u */
+	txBigLimb v1 = v[vn - 1];
+	txBigLimbs x, qhat, rhat;
+	txBigLimb c;
+	int j;
+	if (vn == 1) {
+		c = u[un];
+		for (j = un - 1; j >= 0; j--) {
+			x = ((txBigLimbs)c << mxBigLimbSize) | u[j];
+			qhat = mxBigLimbDivide(x, v1);
+			q[j] = (txBigLimb)qhat;
+			c = (txBigLimb)(x - (qhat * v1));
+		}
+		u[0] = c;
+		return;
+	}
+	for (j = un - vn; j >= 0; j--) {
+		x = ((txBigLimbs)u[j + vn] << mxBigLimbSize) | u[j + vn - 1];
+		qhat = mxBigLimbDivide(x, v1);
+		rhat = x - (qhat * v1);
+		while ((qhat >> mxBigLimbSize) || ((qhat * v[vn - 2]) > ((rhat << mxBigLimbSize) | u[j + vn - 2]))) {
+			qhat--;
+			rhat += v1;
+			if (rhat >> mxBigLimbSize)
+				break;
+		}
+		c = fxBigLimb_submul1(u + j, v, vn, (txBigLimb)qhat);
+		if (u[j + vn] < c) {
+			qhat--;
+			u[j + vn] += fxBigLimb_add(u + j, u + j, v, vn) - c;
+		}
+		else
+			u[j + vn] -= c;
+		q[j] = (txBigLimb)qhat;
+	}
+}
+
 txBigInt *fxBigInt_mul(txMachine* the, txBigInt *rr, txBigInt *aa, txBigInt *bb)
 {
-	rr = fxBigInt_umul(the, rr, aa, bb);
+	if ((aa->data == bb->data) && (aa->size == bb->size))
+		rr = fxBigInt_sqr(the, rr, aa);
+	else
+		rr = fxBigInt_umul(the, rr, aa, bb);
 	if ((aa->sign != bb->sign) && !fxBigInt_iszero(rr))
 		rr->sign = 1;
 	mxBigInt_meter(rr->size);
@@ -1480,33 +1836,32 @@ txBigInt *fxBigInt_mul(txMachine* the, txBigInt *rr, txBigInt *aa, txBigInt *bb)
 
 txBigInt *fxBigInt_umul(txMachine* the, txBigInt *rr, txBigInt *aa, txBigInt *bb)
 {
-	txU8 a, b, r;
-	txU4 *ap, *bp, *rp;
-	txU4 c = 0;
-	int i, j, n, m;
+	txBigLimb *limbs, *ap, *bp, *rp;
+	txBoolean allocated;
+	int an, bn, n;
 
+	if (aa->size < bb->size) {
+		txBigInt *tt = aa;
+		aa = bb;
+		bb = tt;
+	}
 	if (rr == NULL)
 		rr = fxBigInt_alloc(the, aa->size + bb->size);
-	fxBigInt_fill0(rr);
-	ap = aa->data;
-	bp = bb->data;
-	rp = rr->data;
-	n = bb->size;
-	for (i = 0, j = 0; i < n; i++) {
-		b = (txU8)bp[i];
-		c = 0;
-		m = aa->size;
-		for (j = 0; j < m; j++) {
-			a = (txU8)ap[j];
-			r = a * b + c;
-			r += (txU8)rp[i + j];
-			rp[i + j] = mxBigIntLowWord(r);
-			c = mxBigIntHighWord(r);
-		}
-		rp[i + j] = c;
-	}
+	an = mxBigLimbCount(aa->size);
+	bn = mxBigLimbCount(bb->size);
+	limbs = fxBigLimb_alloc(the, (2 * (an + bn)) + fxBigLimb_mul_size(an, bn), &allocated);
+	if (!limbs)
+		return NULL;
+	ap = limbs;
+	bp = ap + an;
+	rp = bp + bn;
+	fxBigLimb_load(ap, aa->data, aa->size);
+	fxBigLimb_load(bp, bb->data, bb->size);
+	fxBigLimb_mul(rp, ap, an, bp, bn, rp + an + bn);
+	fxBigLimb_store(rr->data, rp, aa->size + bb->size);
+	fxBigLimb_free(the, limbs, allocated);
 	/* remove leading 0s */
-	for (n = i + j; --n > 0 && rp[n] == 0;)
+	for (n = aa->size + bb->size; --n > 0 && rr->data[n] == 0;)
 		;
 	rr->size = n + 1;
 	rr->sign = 0;
@@ -1592,48 +1947,27 @@ txBigInt *fxBigInt_exp(txMachine* the, txBigInt *r, txBigInt *a, txBigInt *b)
 
 txBigInt *fxBigInt_sqr(txMachine* the, txBigInt *r, txBigInt *a)
 {
-	int i, j, t;
-	txU4 *ap, *rp;
-	txU8 uv, t1, t2, t3, ai;
-	txU4 c, cc;
-	txU4 overflow = 0;	/* overflow flag of 'u' */
+	txBigLimb *limbs, *ap, *rp;
+	txBoolean allocated;
+	int i, n;
 
 	if (r == NULL)
 		r = fxBigInt_alloc(the, a->size * 2);
-	fxBigInt_fill0(r);
-	t = a->size;
-	ap = a->data;
-	rp = r->data;
-
-	for (i = 0; i < t - 1; i++) {
-		uv = (txU8)ap[i] * ap[i] + rp[i * 2];
-		rp[i * 2] = mxBigIntLowWord(uv);
-		c = mxBigIntHighWord(uv);
-		cc = 0;
-		ai = ap[i];
-		for (j = i + 1; j < t; j++) {
-			int k = i + j;
-			t1 = ai * ap[j];
-			t2 = t1 + c + ((txU8)cc << mxBigIntWordSize);	/* 'cc:c' must be <= 2(b-1) so no overflow here */
-			t3 = t1 + t2;
-			uv = t3 + rp[k];
-			cc = t3 < t1 || uv < t3;
-			c = (txU4)mxBigIntHighWord(uv);
-			rp[k] = mxBigIntLowWord(uv);
-		}
-		c += overflow;
-		rp[i + t] = c;		/* c = u */
-		overflow = cc || c < overflow;
-	}
-	/* the last loop */
-	uv = (txU8)ap[i] * ap[i] + rp[i * 2];
-	rp[i * 2] = mxBigIntLowWord(uv);
-	rp[i + t] = mxBigIntHighWord(uv) + overflow;
-
+	n = mxBigLimbCount(a->size);
+	limbs = fxBigLimb_alloc(the, (3 * n) + fxBigLimb_sqr_size(n), &allocated);
+	if (!limbs)
+		return NULL;
+	ap = limbs;
+	rp = ap + n;
+	fxBigLimb_load(ap, a->data, a->size);
+	fxBigLimb_sqr(rp, ap, n, rp + (2 * n));
+	fxBigLimb_store(r->data, rp, a->size * 2);
+	fxBigLimb_free(the, limbs, allocated);
 	/* remove leading 0s */
-	for (i = 2*t; --i > 0 && rp[i] == 0;)
+	for (i = a->size * 2; --i > 0 && r->data[i] == 0;)
 		;
 	r->size = i + 1;
+	r->sign = 0;
 	return(r);
 }
 
@@ -1690,22 +2024,7 @@ txBigInt *fxBigInt_rem(txMachine* the, txBigInt *r, txBigInt *a, txBigInt *b)
 	return(r);
 }
 
-static void fxBigInt_makepoly(txBigInt *r, txBigInt *a, int t)
-{
-	int n;
-	txU4 *rp, *ap;
-
-	/* make up a polynomial a_t*b^n + a_{t-1}*b^{n-1} + ... */
-	n = r->size;
-	rp = &r->data[n];
-	ap = a->data;
-	while (--n >= 0) {
-		*--rp = t < 0 ? 0: ap[t];
-		--t;
-	}
-}
-
-#if BN_NO_ULDIVMOD
+#if !mxBigInt64 && BN_NO_ULDIVMOD
 static txU8
 div64_32(txU8 a, txU4 b)
 {
@@ -1735,11 +2054,9 @@ div64_32(txU8 a, txU4 b)
 
 txBigInt *fxBigInt_udiv(txMachine* the, txBigInt *q, txBigInt *a, txBigInt *b, txBigInt **r)
 {
-	int sw;
-	txBigInt *nb, *na, *tb, *a2, *b2, *tb2, *tb3;
-	int i, n, t;
-	txU4 *qp, *ap, *bp;
-#define mk_dword(p, i)	(((txU8)(p)[i] << mxBigIntWordSize) | (p)[i - 1])
+	txBigLimb *limbs, *up, *vp, *qp;
+	txBoolean allocated;
+	int sw, i, un, vn;
 
 	if (fxBigInt_ucomp(a, b) < 0) {
 		if (q == NULL) {
@@ -1766,74 +2083,53 @@ txBigInt *fxBigInt_udiv(txMachine* the, txBigInt *q, txBigInt *a, txBigInt *b, t
 	if (r != NULL && *r == NULL)
 		*r = fxBigInt_alloc(the, b->size);
 
-	/* normalize */
-	sw = fxBigInt_ffs(b);
-	nb = fxBigInt_ulsl1(the, NULL, b, sw);
-	na = fxBigInt_ulsl1(the, NULL, a, sw);
-	t = nb->size - 1;	/* the size must not change from 'b' */
-	n = na->size - 1;
-
-	/* adjust size of q */
-	q->size = na->size - nb->size + 1;
-	fxBigInt_fill0(q);	/* set 0 to quotient */
-
-	/* process the most significant word */
-	tb = fxBigInt_ulsl1(the, NULL, nb, (n - t) * mxBigIntWordSize);	/* y*b^n */
-	if (fxBigInt_ucomp(na, tb) >= 0) {
-		q->data[q->size - 1]++;
-		fxBigInt_sub(C_NULL, na, na, tb);
-		/* since nomalization done, must be na < tb here */
-	}
-
-	/* prepare the constant for the adjustment: y_t*b + y_{t-1} */
-	b2 = fxBigInt_alloc(the, 2);
-	fxBigInt_makepoly(b2, nb, t);
-	/* and allocate for temporary buffer */
-	a2 = fxBigInt_alloc(the, 3);
-	tb2 = fxBigInt_alloc(the, 3);
-	tb3 = fxBigInt_alloc(the, tb->size + 1);
-
-	qp = &q->data[q->size - 1];
-	ap = na->data;
-	bp = nb->data;
-	for (i = n; i >= t + 1; --i) {
-		txU4 tq;
-
-		/* the first estimate */
-#if BN_NO_ULDIVMOD
-		tq = (ap[i] == bp[t]) ? ~(txU4)0: (txU4)div64_32(mk_dword(ap, i), bp[t]);
-#else
-		tq = (ap[i] == bp[t]) ? ~(txU4)0: (txU4)(mk_dword(ap, i) / bp[t]);
-#endif
-
-		/* adjust */
-		fxBigInt_makepoly(a2, na, i);
-		while (fxBigInt_ucomp(fxBigInt_umul1(the, tb2, b2, tq), a2) > 0)
-			--tq;
-
-		/* next x */
-		fxBigInt_ulsr1(the, tb, tb, mxBigIntWordSize);
-		fxBigInt_usub(the, na, na, fxBigInt_umul1(the, tb3, tb, tq));
-		if (na->sign) {
-			fxBigInt_add(the, na, na, tb);
-			--tq;
-		}
-		*--qp = tq;
-	}
-	if (r != NULL)
-		*r = fxBigInt_ulsr1(the, *r, na, sw);
+	un = mxBigLimbCount(a->size);
+	vn = mxBigLimbCount(b->size);
+	limbs = fxBigLimb_alloc(the, (un + 1) + vn + (un - vn + 1), &allocated);
+	if (!limbs)
+		return NULL;
+	up = limbs;
+	vp = up + un + 1;
+	qp = vp + vn;
+	fxBigLimb_load(up, a->data, a->size);
+	fxBigLimb_load(vp, b->data, b->size);
+
+	/* normalize so that the most significant bit of the divisor is set */
+	sw = 0;
+	while (!(vp[vn - 1] & ((txBigLimb)1 << (mxBigLimbSize - 1 - sw))))
+		sw++;
+	up[un] = 0;
+	if (sw) {
+		for (i = vn; --i > 0;)
+			vp[i] = (vp[i] << sw) | (vp[i - 1] >> (mxBigLimbSize - sw));
+		vp[0] <<= sw;
+		up[un] = up[un - 1] >> (mxBigLimbSize - sw);
+		for (i = un; --i > 0;)
+			up[i] = (up[i] << sw) | (up[i - 1] >> (mxBigLimbSize - sw));
+		up[0] <<= sw;
+	}
+	fxBigLimb_div(qp, up, un, vp, vn);
+
+	fxBigLimb_store(q->data, qp, a->size - b->size + 1);
 	/* remove leading 0s from q */
-	for (i = q->size; --i > 0 && q->data[i] == 0;)
+	for (i = a->size - b->size + 1; --i > 0 && q->data[i] == 0;)
 		;
 	q->size = i + 1;
-	
-	fxBigInt_free(the, tb3);
-	fxBigInt_free(the, tb2);
-	fxBigInt_free(the, a2);
-	fxBigInt_free(the, b2);
-	fxBigInt_free(the, tb);
-	fxBigInt_free(the, na);
-	fxBigInt_free(the, nb);
+	q->sign = 0;
+	if (r != NULL) {
+		if (sw) {
+			for (i = 0; i < vn - 1; i++)
+				up[i] = (up[i] >> sw) | (up[i + 1] << (mxBigLimbSize - sw));
+			up[vn - 1] >>= sw;
+		}
+		fxBigLimb_store((*r)->data, up, b->size);
+		/* remove leading 0s from r */
+		for (i = b->size; --i > 0 && (*r)->data[i] == 0;)
+			;
+		(*r)->size = i + 1;
+		(*r)->sign = 0;
+	}
+	fxBigLimb_free(the, limbs, allocated);
 	return(q);
 }
 
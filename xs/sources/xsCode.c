@@ -301,6 +301,7 @@ txScript* fxParserCode(txParser* parser)
 			size += value;
 			break;
 			
+		case XS_CODE_APPEND_LOCAL_1:
 		case XS_CODE_CONST_CLOSURE_1:
 		case XS_CODE_CONST_LOCAL_1:
 		case XS_CODE_GET_CLOSURE_1:
@@ -438,6 +439,7 @@ txScript* fxParserCode(txParser* parser)
 			size += 1 + sizeof(txID);
 			break;
 			
+		case XS_CODE_APPEND_LOCAL_1:
 		case XS_CODE_CONST_CLOSURE_1:
 		case XS_CODE_CONST_LOCAL_1:
 		case XS_CODE_GET_CLOSURE_1:
@@ -463,6 +465,7 @@ txScript* fxParserCode(txParser* parser)
 		case XS_CODE_UNWIND_1:
 			size += 2;
 			break;
+		case XS_CODE_APPEND_LOCAL_2:
 		case XS_CODE_CONST_CLOSURE_2:
 		case XS_CODE_CONST_LOCAL_2:
 		case XS_CODE_GET_CLOSURE_2:
@@ -663,6 +666,7 @@ txScript* fxParserCode(txParser* parser)
 			mxEncode2(p, u2);
 			break;
 
+		case XS_CODE_APPEND_LOCAL_1:
 		case XS_CODE_CONST_CLOSURE_1:
 		case XS_CODE_CONST_LOCAL_1:
 		case XS_CODE_GET_CLOSURE_1:
@@ -687,6 +691,7 @@ txScript* fxParserCode(txParser* parser)
 			*((txU1*)p++) = u1;
 			break;
 
+		case XS_CODE_APPEND_LOCAL_2:
 		case XS_CODE_CONST_CLOSURE_2:
 		case XS_CODE_CONST_LOCAL_2:
 		case XS_CODE_GET_CLOSURE_2:
@@ -852,6 +857,8 @@ txScript* fxParserCode(txParser* parser)
 				fprintf(stderr, "%s ?\n", gxCodeNames[code->id]);
 			break;
 		
+		case XS_CODE_APPEND_LOCAL_1:
+		case XS_CODE_APPEND_LOCAL_2:
 		case XS_CODE_CONST_CLOSURE_1:
 		case XS_CODE_CONST_CLOSURE_2:
 		case XS_CODE_CONST_LOCAL_1:
@@ -2573,6 +2580,8 @@ void fxCompoundExpressionNodeCode(void* it, void* param)
 		stackLevel = coder->stackLevel;
 		break;
 	default:
+		if ((token == XS_TOKEN_ADD_ASSIGN) && (self->flags & mxExpressionNoValue) && (coder->lastCode->id == XS_CODE_GET_LOCAL_1))
+			coder->lastCode->id = XS_CODE_APPEND_LOCAL_1;
 		fxNodeDispatchCode(self->value, param);
 		fxCoderAddByte(param, -1, self->description->code);
 		break;
@@ -274,7 +274,9 @@ const txString gxCodeNames[XS_CODE_COUNT] = {
 	/* XS_CODE_VOID */ "void",
 	/* XS_CODE_WITH */ "with",
 	/* XS_CODE_WITHOUT */ "without",
-	/* XS_CODE_YIELD */ "yield"
+	/* XS_CODE_YIELD */ "yield",
+	/* XS_CODE_APPEND_LOCAL_1 */ "append_local_1",
+	/* XS_CODE_APPEND_LOCAL_2 */ "append_local_2"
 };
 
 const txS1 gxCodeSizes[XS_CODE_COUNT] ICACHE_FLASH_ATTR = {
@@ -510,7 +512,9 @@ const txS1 gxCodeSizes[XS_CODE_COUNT] ICACHE_FLASH_ATTR = {
 	1 /* XS_CODE_VOID */,
 	1 /* XS_CODE_WITH */,
 	1 /* XS_CODE_WITHOUT */,
-	1 /* XS_CODE_YIELD */
+	1 /* XS_CODE_YIELD */,
+	2 /* XS_CODE_APPEND_LOCAL_1 */,
+	3 /* XS_CODE_APPEND_LOCAL_2 */
 };
 
 #if mxUseDefaultCStackLimit
@@ -1273,6 +1277,7 @@ const txString gxIDStrings[XS_ID_COUNT] = {
 	"chunkify",
 	"cleanupSome",
 	"clear",
+	"close",
 	"closure",
 	"clz32",
 	"codePointAt",
@@ -1284,6 +1289,7 @@ const txString gxIDStrings[XS_ID_COUNT] = {
 	"console",
 	"construct",
 	"constructor",
+	"consumed",
 	"copyWithin",
 	"cos",
 	"cosh",
@@ -1439,6 +1445,8 @@ const txString gxIDStrings[XS_ID_COUNT] = {
 	"padEnd",
 	"padStart",
 	"parse",
+	"parser",
+	"partial",
 	"path",
 	"peek",
 	"poke",
@@ -1565,6 +1573,7 @@ const txString gxIDStrings[XS_ID_COUNT] = {
 	"wake",
 	"weak",
 	"writable",
+	"write",
 	"xor",
 	"",
 	"<xsbug:script>"
@@ -100,7 +100,7 @@ typedef struct {
 #define XS_ATOM_SYMBOLS 0x53594D42 /* 'SYMB' */
 #define XS_ATOM_VERSION 0x56455253 /* 'VERS' */
 #define XS_MAJOR_VERSION 11
-#define XS_MINOR_VERSION 0
+#define XS_MINOR_VERSION 1
 #define XS_PATCH_VERSION 0
 
 #define XS_DIGEST_SIZE 16
@@ -372,6 +372,9 @@ enum {
 	XS_CODE_WITH,
 	XS_CODE_WITHOUT,
 	XS_CODE_YIELD,
+	/* after the others, so that they keep their numbers */
+	XS_CODE_APPEND_LOCAL_1,
+	XS_CODE_APPEND_LOCAL_2,
 	XS_CODE_COUNT
 };
 
@@ -462,6 +465,7 @@ enum {
 };
 mxExport txBoolean fxCompileRegExp(void* the, txString pattern, txString modifier, txInteger** code, txInteger** data, txString errorBuffer, txInteger errorSize);
 mxExport void fxDeleteRegExp(void* the, txInteger* code, txInteger* data);
+mxExport txInteger fxMeasureRegExpData(txInteger* code);
 mxExport txInteger fxMatchRegExp(void* the, txInteger* code, txInteger* data, txString subject, txInteger offset);
 
 /* xsBigInt.c */
@@ -776,6 +780,7 @@ enum {
 	_chunkify,
 	_cleanupSome,
 	_clear,
+	_close,
 	_closure,
 	_clz32,
 	_codePointAt,
@@ -787,6 +792,7 @@ enum {
 	_console,
 	_construct,
 	_constructor,
+	_consumed,
 	_copyWithin,
 	_cos,
 	_cosh,
@@ -942,6 +948,8 @@ enum {
 	_padEnd,
 	_padStart,
 	_parse,
+	_parser,
+	_partial,
 	_path,
 	_peek,
 	_poke,
@@ -1068,6 +1076,7 @@ enum {
 	_wake,
 	_weak,
 	_writable,
+	_write,
 	_xor,
 	__empty_string_,
 	__xsbug_script_,
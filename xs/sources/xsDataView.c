@@ -49,10 +49,10 @@ static txSlot* fxNewDataViewInstance(txMachine* the);
 
 static void fxCallTypedArrayItem(txMachine* the, txSlot* function, txSlot* dispatch, txSlot* view, txSlot* data, txInteger index, txSlot* item);
 static txSlot* fxCheckTypedArrayInstance(txMachine* the, txSlot* slot);
-static int fxCompareTypedArrayItem(txMachine* the, txSlot* function, txSlot* dispatch, txSlot* view, txSlot* data, txInteger index);
 static txSlot* fxConstructTypedArray(txMachine* the);
 static txSlot* fxNewTypedArrayInstance(txMachine* the, txTypeDispatch* dispatch, txTypeAtomics* atomics);
 static void fxReduceTypedArrayItem(txMachine* the, txSlot* function, txSlot* dispatch, txSlot* view, txSlot* data, txInteger index);
+static txBoolean fxSortTypedArrayItems(txMachine* the, txTypeDispatch* dispatch, txByte* address, txInteger length);
 
 static txBoolean fxTypedArrayDefineOwnProperty(txMachine* the, txSlot* instance, txID id, txIndex index, txSlot* slot, txFlag mask);
 static txBoolean fxTypedArrayDeleteProperty(txMachine* the, txSlot* instance, txID id, txIndex index);
@@ -1052,32 +1052,6 @@ txSlot* fxCheckTypedArrayInstance(txMachine* the, txSlot* slot)
 	return C_NULL;
 }
 
-int fxCompareTypedArrayItem(txMachine* the, txSlot* function, txSlot* dispatch, txSlot* view, txSlot* data, txInteger index)
-{
-	txSlot* slot = the->stack;
-	int result;
-	/* THIS */
-	mxPushUndefined();
-	/* FUNCTION */
-	mxPushSlot(function);
-	mxCall();
-	/* ARGUMENTS */
-	mxPushUndefined();
-	(*dispatch->value.typedArray.dispatch->getter)(the, data, view->value.dataView.offset + (index << dispatch->value.typedArray.dispatch->shift), the->stack, EndianNative);
-	mxPushSlot(slot);
-	mxRunCount(2);
-	if (the->stack->kind == XS_INTEGER_KIND)
-		result = the->stack->value.integer;
-	else {
-		txNumber number = fxToNumber(the, the->stack);
-		result = (number < 0) ? -1 :  (number > 0) ? 1 : 0;
-	}
-	mxPop();
-	if (data->value.arrayBuffer.address == C_NULL)
-		mxTypeError("detached buffer");
-	return result;
-}
-
 txSlot* fxConstructTypedArray(txMachine* the)
 {
 	txSlot* prototype;
@@ -1141,6 +1115,109 @@ void fxReduceTypedArrayItem(txMachine* the, txSlot* function, txSlot* dispatch,
 	mxRunCount(4);
 }
 
+txBoolean fxSortTypedArrayItems(txMachine* the, txTypeDispatch* dispatch, txByte* address, txInteger length)
+{
+	/* least significant digit radix sort of keys that compare like the items */
+	txInteger size = dispatch->size;
+	txID id = dispatch->constructorID;
+	txBoolean isFloat = ((id == _Float32Array) || (id == _Float64Array)) ? 1 : 0;
+	txBoolean isSigned = (isFloat || (id == _BigInt64Array) || (id == _Int8Array) || (id == _Int16Array) || (id == _Int32Array)) ? 1 : 0;
+	txU8 sign = (txU8)1 << ((size << 3) - 1);
+	txU8 mask = (size == 8) ? ~((txU8)0) : (((txU8)1 << (size << 3)) - 1);
+	txU8 exponent = (id == _Float32Array) ? 0x7F800000 : 0x7FF0000000000000ull;
+	txU4 counts[256];
+	txU8* keys;
+	txU8* temp;
+	txU8 key;
+	txInteger index, shift;
+	if (size == 1) {
+		txU1* p = (txU1*)address;
+		txU1 bias = (isSigned) ? 0x80 : 0;
+		txU4 count;
+		c_memset(counts, 0, sizeof(counts));
+		for (index = 0; index < length; index++)
+			counts[p[index] ^ bias]++;
+		for (index = 0; index < 256; index++) {
+			count = counts[index];
+			c_memset(p, index ^ bias, count);
+			p += count;
+		}
+		return 1;
+	}
+	if (length < mxSortRadixThreshold)
+		return 0;
+	keys = c_malloc(2 * length * sizeof(txU8));
+	if (!keys)
+		return 0;
+	temp = keys + length;
+	for (index = 0; index < length; index++) {
+		txByte* p = address + (index * size);
+		if (size == 2) {
+			txU2 u;
+			c_memcpy(&u, p, 2);
+			key = u;
+		}
+		else if (size == 4) {
+			txU4 u;
+			c_memcpy(&u, p, 4);
+			key = u;
+		}
+		else
+			c_memcpy(&key, p, 8);
+		if (isFloat) {
+			/* NaN after +Infinity, -0 before +0 */
+			if (((key & exponent) == exponent) && (key & ~(sign | exponent) & mask))
+				key &= ~sign;
+			key = (key & sign) ? (~key & mask) : (key | sign);
+		}
+		else if (isSigned)
+			key ^= sign;
+		keys[index] = key;
+	}
+	for (shift = 0; shift < (size << 3); shift += 8) {
+		txU4 offset = 0, count;
+		c_memset(counts, 0, sizeof(counts));
+		for (index = 0; index < length; index++)
+			counts[(keys[index] >> shift) & 0xFF]++;
+		if (counts[(keys[0] >> shift) & 0xFF] == (txU4)length)
+			continue;
+		for (index = 0; index < 256; index++) {
+			count = counts[index];
+			counts[index] = offset;
+			offset += count;
+		}
+		for (index = 0; index < length; index++) {
+			key = keys[index];
+			temp[counts[(key >> shift) & 0xFF]++] = key;
+		}
+		{
+			txU8* swap = keys;
+			keys = temp;
+			temp = swap;
+		}
+	}
+	for (index = 0; index < length; index++) {
+		txByte* p = address + (index * size);
+		key = keys[index];
+		if (isFloat)
+			key = (key & sign) ? (key ^ sign) : (~key & mask);
+		else if (isSigned)
+			key ^= sign;
+		if (size == 2) {
+			txU2 u = (txU2)key;
+			c_memcpy(p, &u, 2);
+		}
+		else if (size == 4) {
+			txU4 u = (txU4)key;
+			c_memcpy(p, &u, 4);
+		}
+		else
+			c_memcpy(p, &key, 8);
+	}
+	c_free((keys < temp) ? keys : temp);
+	return 1;
+}
+
 txSlot* fxNewTypedArrayInstance(txMachine* the, txTypeDispatch* dispatch, txTypeAtomics* atomics)
 {
 	txSlot* instance;
@@ -2053,100 +2130,36 @@ void fx_TypedArray_prototype_sort(txMachine* the)
 		}
 	}
 	if (function) {
-		/* like GCC qsort */
-		#define COMPARE(INDEX) \
-			fxCompareTypedArrayItem(the, function, dispatch, view, data, INDEX)
-		#define MOVE(FROM,TO) \
-			from = data->value.arrayBuffer.address + view->value.dataView.offset + ((FROM) * delta); \
-			to = data->value.arrayBuffer.address + view->value.dataView.offset + ((TO) * delta); \
-			for (k = 0; k < delta; k++) *to++ = *from++
-		#define PUSH(INDEX) \
-			mxPushUndefined(); \
-			(*dispatch->value.typedArray.dispatch->getter)(the, data, view->value.dataView.offset + ((INDEX) * delta), the->stack, EndianNative)
-		#define PULL(INDEX) \
-			(*dispatch->value.typedArray.dispatch->setter)(the, data, view->value.dataView.offset + ((INDEX) * delta), the->stack++, EndianNative)
+		/* the items are sorted in a list, then written back */
+		txTypeDispatch* typeDispatch = dispatch->value.typedArray.dispatch;
+		txSlot* list;
+		txSlot* item;
+		txInteger index;
+		mxPush(mxArrayPrototype);
+		list = fxNewArrayInstance(the)->next;
 		if (length > 0) {
-			txInteger i, j, k;
-			txByte* from;
-			txByte* to;
-			if (length > mxSortThreshold) {
-				txInteger lo = 0, hi = length - 1;
-				txSortPartition stack[mxSortStackSize];
-				txSortPartition *top = stack + 1;
-				while (stack < top) {
-					txIndex mid = lo + ((hi - lo) >> 1);
-					PUSH(mid);
-					if (COMPARE(lo) > 0) {
-						MOVE(lo, mid);
-						PULL(lo);
-						PUSH(mid);
-					}
-					if (COMPARE(hi) < 0) {
-						MOVE(hi, mid);
-						PULL(hi);
-						PUSH(mid);
-						if (COMPARE(lo) > 0) {
-							MOVE(lo, mid);
-							PULL(lo);
-							PUSH(mid);
-						}
-					}
-					i = lo + 1;
-					j = hi - 1;
-					do {
-						while (COMPARE(i) < 0) i++;
-						while (COMPARE(j) > 0) j--;
-						if (i < j) {
-							PUSH(i);
-							MOVE(j, i);
-							PULL(j);
-							i++;
-							j--;
-						}
-						else if (i == j) {
-							i++;
-							j--;
-							break;
-						}
-					} while (i <= j);
-					if ((j - lo) <= mxSortThreshold) {
-						if ((hi - i) <= mxSortThreshold) {
-							top--;
-							lo = top->lo; 
-							hi = top->hi;
-						}
-						else {
-							lo = i;
-						}
-					}
-					else if ((hi - i) <= mxSortThreshold) {
-						hi = j;
-					}
-					else if ((j - lo) > (hi - i)) {
-						top->lo = lo;
-						top->hi = j; 
-						top++;
-						lo = i;
-					}
-					else {
-						top->lo = i;
-						top->hi = hi; 
-						top++;
-						hi = j;
-					}
-				}
-			}
-			for (i = 1; i < length; i++) {
-				PUSH(i);
-				for (j = i; (j > 0) && (COMPARE(j - 1) > 0); j--) {
-					MOVE(j - 1, j);
-				}	
-				PULL(j);
+			fxSetIndexSize(the, list, length, XS_CHUNK);
+			for (index = 0; index < length; index++) {
+				mxPushUndefined();
+				(*typeDispatch->getter)(the, data, view->value.dataView.offset + (index * delta), the->stack, EndianNative);
+				item = list->value.array.address + index;
+				item->kind = the->stack->kind;
+				item->value = the->stack->value;
+				mxPop();
 			}
 		}
+		fxSortArrayItems(the, function, list);
+		if (data->value.arrayBuffer.address == C_NULL)
+			mxTypeError("detached buffer");
+		for (index = 0; index < length; index++)
+			(*typeDispatch->setter)(the, data, view->value.dataView.offset + (index * delta), list->value.array.address + index, EndianNative);
+		mxPop();
+	}
+	else if (length > 1) {
+		txByte* address = data->value.arrayBuffer.address + view->value.dataView.offset;
+		if (!fxSortTypedArrayItems(the, dispatch->value.typedArray.dispatch, address, length))
+			c_qsort(address, length, delta, dispatch->value.typedArray.dispatch->compare);
 	}
-	else
-		c_qsort(data->value.arrayBuffer.address, length, delta, dispatch->value.typedArray.dispatch->compare);
 	mxResult->kind = mxThis->kind;
 	mxResult->value = mxThis->value;
 }
@@ -2480,7 +2493,9 @@ int fxFloat32Compare(const void* p, const void* q)
 	}
 	if (c_isnan(b))
 		return -1;
-	return (a < b) ? -1 : (a > b) ? 1 : 0;
+	if (a == b)
+		return (c_signbit(a) ? -1 : 0) + (c_signbit(b) ? 1 : 0);
+	return (a < b) ? -1 : 1;
 }
 
 void fxFloat32Getter(txMachine* the, txSlot* data, txInteger offset, txSlot* slot, int endian)
@@ -2519,7 +2534,9 @@ int fxFloat64Compare(const void* p, const void* q)
 	}
 	if (c_isnan(b))
 		return -1;
-	return (a < b) ? -1 : (a > b) ? 1 : 0;
+	if (a == b)
+		return (c_signbit(a) ? -1 : 0) + (c_signbit(b) ? 1 : 0);
+	return (a < b) ? -1 : 1;
 }
 
 void fxFloat64Getter(txMachine* the, txSlot* data, txInteger offset, txSlot* slot, int endian)
@@ -2194,7 +2194,11 @@ void fxVReportWarning(void* console, txString thePath, txInteger theLine, txStri
 }
 
 #ifdef mxInstrument	
+#if mxRegExpCache
+#define xsInstrumentCount 13
+#else
 #define xsInstrumentCount 11
+#endif
 static char* const xsInstrumentNames[xsInstrumentCount] ICACHE_XS6STRING_ATTR = {
 	"Chunk used",
 	"Chunk available",
@@ -2207,6 +2211,10 @@ static char* const xsInstrumentNames[xsInstrumentCount] ICACHE_XS6STRING_ATTR =
 	"Modules loaded",
 	"Parser used",
 	"Floating Point",
+#if mxRegExpCache
+	"RegExp cache hits",
+	"RegExp cache misses",
+#endif
 };
 static char* const xsInstrumentUnits[xsInstrumentCount] ICACHE_XS6STRING_ATTR = {
 	" / ",
@@ -2220,6 +2228,10 @@ static char* const xsInstrumentUnits[xsInstrumentCount] ICACHE_XS6STRING_ATTR =
 	" modules",
 	" bytes",
 	" operations",
+#if mxRegExpCache
+	" regexps",
+	" regexps",
+#endif
 };
 
 void fxDescribeInstrumentation(txMachine* the, txInteger count, txString* names, txString* units)
@@ -2280,6 +2292,10 @@ void fxSampleInstrumentation(txMachine* the, txInteger count, txInteger* values)
 	xsInstrumentValues[8] = the->loadedModulesCount;
 	xsInstrumentValues[9] = the->peakParserSize;
 	xsInstrumentValues[10] = the->floatingPointOps;
+#if mxRegExpCache
+	xsInstrumentValues[11] = the->regExpCacheHits;
+	xsInstrumentValues[12] = the->regExpCacheMisses;
+#endif
 
 	txInteger i, j = 0;
 #ifdef mxDebug
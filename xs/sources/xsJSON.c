@@ -46,6 +46,7 @@ enum {
 	XS_JSON_TOKEN_INTEGER,
 	XS_JSON_TOKEN_LEFT_BRACE,
 	XS_JSON_TOKEN_LEFT_BRACKET,
+	XS_JSON_TOKEN_MORE,
 	XS_JSON_TOKEN_NULL,
 	XS_JSON_TOKEN_NUMBER,
 	XS_JSON_TOKEN_RIGHT_BRACE,
@@ -54,17 +55,63 @@ enum {
 	XS_JSON_TOKEN_TRUE,
 };
 
+#if mxJSONKeyCache
+#define mxJSONKeyCacheDepth 8
+#define mxJSONKeyCacheLength 32
+
+typedef struct {
+	txInteger count;
+	txID ids[mxJSONKeyCacheLength];
+	txSize lengths[mxJSONKeyCacheLength];
+} txJSONKeyCache;
+#endif
+
 typedef struct {
 	txSlot* slot;
 	txSize offset;
+	txSize size;
 	txInteger integer;
 	txNumber number;
 	txSlot* string;
 	txInteger token;
 	txSlot* keys;
 	txInteger line;
+	txInteger depth;
+	txBoolean partial;
+	txBoolean streaming;
+#if mxJSONKeyCache
+	txJSONKeyCache keyCaches[mxJSONKeyCacheDepth];
+#endif
 } txJSONParser;
 
+enum {
+	XS_JSON_EXPECT_VALUE,
+	XS_JSON_EXPECT_FIRST_ITEM,
+	XS_JSON_EXPECT_ITEM,
+	XS_JSON_EXPECT_ITEM_COMMA,
+	XS_JSON_EXPECT_FIRST_NAME,
+	XS_JSON_EXPECT_NAME,
+	XS_JSON_EXPECT_COLON,
+	XS_JSON_EXPECT_MEMBER,
+	XS_JSON_EXPECT_MEMBER_COMMA,
+};
+
+enum {
+	XS_JSON_STREAM_IDLE,
+	XS_JSON_STREAM_BUSY,
+	XS_JSON_STREAM_CLOSED,
+};
+
+#define mxJSONStreamBuffer(STATE) ((STATE)->next)
+#define mxJSONStreamCallback(STATE) ((STATE)->next->next)
+#define mxJSONStreamDepth(STATE) ((STATE)->next->next->next)
+#define mxJSONStreamLine(STATE) ((STATE)->next->next->next->next)
+#define mxJSONStreamOffset(STATE) ((STATE)->next->next->next->next->next)
+#define mxJSONStreamStatus(STATE) ((STATE)->next->next->next->next->next->next)
+#define mxJSONStreamFrames(STATE) ((STATE)->next->next->next->next->next->next->next)
+
+#define mxJSONSource(PARSER) (((PARSER)->slot->kind == XS_ARRAY_BUFFER_KIND) ? (txString)((PARSER)->slot->value.arrayBuffer.address) : (PARSER)->slot->value.string)
+
 typedef struct {
 	txString buffer;
 	char indent[16];
@@ -74,25 +121,47 @@ typedef struct {
 	txSlot* replacer;
 	txSlot* keys;
 	txSlot* stack;
+	txSlot* output;
+	txSlot* target;
+	txSlot* write;
+	txSize base;
+	txNumber total;
 } txJSONStringifier;
 
+#define mxJSONBlockSize 1024
+
+static txSlot* fxGetJSONBuffer(txMachine* the, txSlot* slot, txSize* offset, txSize* size);
 static void fxParseJSON(txMachine* the, txJSONParser* theParser);
 static void fxParseJSONArray(txMachine* the, txJSONParser* theParser);
+static txBoolean fxParseJSONBuffer(txMachine* the, txJSONParser* theParser, txSlot* source, txSlot* options);
+#if mxJSONKeyCache
+static txBoolean fxParseJSONCachedName(txMachine* the, txJSONParser* theParser, txID id, txSize length);
+#endif
+static txString fxParseJSONCharacter(txString string, txString limit, txInteger* character);
+static void fxParseJSONName(txMachine* the, txJSONParser* theParser);
 static void fxParseJSONObject(txMachine* the, txJSONParser* theParser);
+static void fxParseJSONStream(txMachine* the, txSlot* state, txBoolean streaming);
+static void fxParseJSONStreamPop(txMachine* the, txSlot* state);
+static void fxParseJSONStreamPush(txMachine* the, txSlot* state, txInteger expect);
+static void fxParseJSONStreamReset(txMachine* the, txSlot* state);
+static void fxParseJSONStreamValue(txMachine* the, txSlot* state, txBoolean container);
 static void fxParseJSONToken(txMachine* the, txJSONParser* theParser);
+static txBoolean fxParseJSONUnicodeEscape(txString* string, txString limit, txInteger* character);
 static void fxParseJSONValue(txMachine* the, txJSONParser* theParser);
 static void fxReviveJSON(txMachine* the, txSlot* reviver);
 
 static void fxStringifyJSON(txMachine* the, txJSONStringifier* theStringifier);
 static void fxStringifyJSONChar(txMachine* the, txJSONStringifier* theStringifier, char c);
 static void fxStringifyJSONChars(txMachine* the, txJSONStringifier* theStringifier, char* s, txSize theSize);
+static void fxStringifyJSONFlush(txMachine* the, txJSONStringifier* theStringifier);
 static void fxStringifyJSONIndent(txMachine* the, txJSONStringifier* theStringifier);
 static void fxStringifyJSONInteger(txMachine* the, txJSONStringifier* theStringifier, txInteger theInteger);
 static void fxStringifyJSONName(txMachine* the, txJSONStringifier* theStringifier, txInteger* theFlag);
 static void fxStringifyJSONNumber(txMachine* the, txJSONStringifier* theStringifier, txNumber theNumber);
 static void fxStringifyJSONProperty(txMachine* the, txJSONStringifier* theStringifier, txInteger* theFlag);
-static void fxStringifyJSONString(txMachine* the, txJSONStringifier* theStringifier, txString theString);
+static void fxStringifyJSONString(txMachine* the, txJSONStringifier* theStringifier, txSlot* theSlot);
 static void fxStringifyJSONUnicodeEscape(txMachine* the, txJSONStringifier* theStringifier, txInteger character);
+static void fxStringifyJSONWrite(txMachine* the, txJSONStringifier* theStringifier, char* s, txSize theSize);
 
 static txSlot* fxToJSONKeys(txMachine* the, txSlot* reference);
 
@@ -102,14 +171,37 @@ void fxBuildJSON(txMachine* the)
 	mxPush(mxObjectPrototype);
 	slot = fxLastProperty(the, fxNewObjectInstance(the));
 	slot = fxNextHostFunctionProperty(the, slot, mxCallback(fx_JSON_parse), 2, mxID(_parse), XS_DONT_ENUM_FLAG);
+	slot = fxNextHostFunctionProperty(the, slot, mxCallback(fx_JSON_parser), 1, mxID(_parser), XS_DONT_ENUM_FLAG);
 	slot = fxNextHostFunctionProperty(the, slot, mxCallback(fx_JSON_stringify), 3, mxID(_stringify), XS_DONT_ENUM_FLAG);
 	slot = fxNextStringXProperty(the, slot, "JSON", mxID(_Symbol_toStringTag), XS_DONT_ENUM_FLAG | XS_DONT_SET_FLAG);
 	mxPull(mxJSONObject);
 }
 
+txSlot* fxGetJSONBuffer(txMachine* the, txSlot* slot, txSize* offset, txSize* size)
+{
+	if (slot->kind == XS_TYPED_ARRAY_KIND)
+		slot = slot->next;
+	if (slot->kind == XS_DATA_VIEW_KIND) {
+		txSlot* buffer = slot->next;
+		if ((buffer->kind != XS_REFERENCE_KIND) || !(buffer = buffer->value.reference->next) || (buffer->kind != XS_ARRAY_BUFFER_KIND))
+			mxTypeError("no ArrayBuffer instance");
+		if (buffer->value.arrayBuffer.address == C_NULL)
+			mxTypeError("detached buffer");
+		*offset = slot->value.dataView.offset;
+		*size = slot->value.dataView.size;
+		return buffer;
+	}
+	if (slot->value.arrayBuffer.address == C_NULL)
+		mxTypeError("detached buffer");
+	*offset = 0;
+	*size = slot->value.arrayBuffer.length;
+	return slot;
+}
+
 void fx_JSON_parse(txMachine* the)
 {
 	volatile txJSONParser* aParser = C_NULL;
+	txSize start = 0, consumed = -1;
 	mxTry(the) {
 		if (mxArgc < 1)
 			mxSyntaxError("no buffer");
@@ -119,13 +211,24 @@ void fx_JSON_parse(txMachine* the)
 		c_memset((txJSONParser*)aParser, 0, sizeof(txJSONParser));
 		if ((mxArgc > 1) && mxIsReference(mxArgv(1)) && fxIsArray(the, mxArgv(1)->value.reference))
 			aParser->keys = fxToJSONKeys(the, mxArgv(1));
-		fxToString(the, mxArgv(0));
-		aParser->slot = mxArgv(0);
-		aParser->offset = 0;
+		if (fxParseJSONBuffer(the, (txJSONParser*)aParser, mxArgv(0), (mxArgc > 2) ? mxArgv(2) : C_NULL)) {
+			txU1* p = (txU1*)mxJSONSource(aParser) + aParser->offset;
+			start = aParser->offset;
+			if (((aParser->size - aParser->offset) >= 3) && (p[0] == 0xEF) && (p[1] == 0xBB) && (p[2] == 0xBF))
+				aParser->offset += 3;
+		}
+		else {
+			fxToString(the, mxArgv(0));
+			aParser->slot = mxArgv(0);
+			aParser->offset = 0;
+			aParser->size = (txSize)c_strlen(aParser->slot->value.string);
+		}
 		fxParseJSON(the, (txJSONParser*)aParser);
 		mxPullSlot(mxResult);
 		if (aParser->keys)
 			mxPop();
+		if (aParser->partial)
+			consumed = aParser->offset - start;
 		c_free((txJSONParser*)aParser);
         aParser = C_NULL;
 		if ((mxArgc > 1) && mxIsReference(mxArgv(1)) && mxIsCallable(mxArgv(1)->value.reference)) {
@@ -143,6 +246,14 @@ void fx_JSON_parse(txMachine* the)
 			fxReviveJSON(the, mxArgv(1));
 			mxPullSlot(mxResult);
 		}
+		if (consumed >= 0) {
+			txSlot* slot;
+			mxPush(mxObjectPrototype);
+			slot = fxLastProperty(the, fxNewObjectInstance(the));
+			slot = fxNextSlotProperty(the, slot, mxResult, mxID(_value), XS_NO_FLAG);
+			slot = fxNextIntegerProperty(the, slot, consumed, mxID(_consumed), XS_NO_FLAG);
+			mxPullSlot(mxResult);
+		}
 	}
 	mxCatch(the) {
 		if (aParser)
@@ -151,6 +262,107 @@ void fx_JSON_parse(txMachine* the)
 	}
 }
 
+void fx_JSON_parser(txMachine* the)
+{
+	txNumber depth = 0;
+	txSlot* state;
+	txSlot* slot;
+	if ((mxArgc < 1) || !mxIsReference(mxArgv(0)) || !mxIsCallable(mxArgv(0)->value.reference))
+		mxTypeError("callback is no function");
+	if ((mxArgc > 1) && !mxIsUndefined(mxArgv(1))) {
+		depth = fxToNumber(the, mxArgv(1));
+		if ((depth < 0) || (depth > 0x7FFFFFFF) || (depth != c_trunc(depth)))
+			mxRangeError("invalid depth");
+	}
+	state = fxNewInstance(the);
+	slot = state->next = fxNewSlot(the);
+	slot->flag = XS_INTERNAL_FLAG;
+	slot->kind = XS_ARRAY_BUFFER_KIND;
+	slot->value.arrayBuffer.address = C_NULL;
+	slot->value.arrayBuffer.length = 0;
+	slot = fxNextSlotProperty(the, slot, mxArgv(0), XS_NO_ID, XS_INTERNAL_FLAG);
+	slot = fxNextIntegerProperty(the, slot, (txInteger)depth, XS_NO_ID, XS_INTERNAL_FLAG);
+	slot = fxNextIntegerProperty(the, slot, 1, XS_NO_ID, XS_INTERNAL_FLAG);
+	slot = fxNextIntegerProperty(the, slot, 0, XS_NO_ID, XS_INTERNAL_FLAG);
+	slot = fxNextIntegerProperty(the, slot, XS_JSON_STREAM_IDLE, XS_NO_ID, XS_INTERNAL_FLAG);
+	slot = fxNextIntegerProperty(the, slot, 0, XS_NO_ID, XS_INTERNAL_FLAG);
+	mxPush(mxObjectPrototype);
+	slot = fxLastProperty(the, fxNewObjectInstance(the));
+	slot = fxNextHostFunctionProperty(the, slot, mxCallback(fx_JSON_parser_push), 1, mxID(_push), XS_DONT_ENUM_FLAG);
+	mxFunctionInstanceHome(slot->value.reference)->value.home.object = state;
+	slot = fxNextHostFunctionProperty(the, slot, mxCallback(fx_JSON_parser_close), 0, mxID(_close), XS_DONT_ENUM_FLAG);
+	mxFunctionInstanceHome(slot->value.reference)->value.home.object = state;
+	mxPullSlot(mxResult);
+	mxPop();
+}
+
+void fx_JSON_parser_close(txMachine* the)
+{
+	txSlot* state = mxFunctionInstanceHome(mxFunction->value.reference)->value.home.object;
+	txSlot* status = mxJSONStreamStatus(state);
+	if (status->value.integer == XS_JSON_STREAM_BUSY)
+		mxTypeError("busy");
+	if (status->value.integer == XS_JSON_STREAM_CLOSED)
+		return;
+	status->value.integer = XS_JSON_STREAM_BUSY;
+	mxTry(the) {
+		fxParseJSONStream(the, state, 0);
+		fxParseJSONStreamReset(the, state);
+	}
+	mxCatch(the) {
+		fxParseJSONStreamReset(the, state);
+		fxJump(the);
+	}
+}
+
+void fx_JSON_parser_push(txMachine* the)
+{
+	txSlot* state = mxFunctionInstanceHome(mxFunction->value.reference)->value.home.object;
+	txSlot* status = mxJSONStreamStatus(state);
+	if (status->value.integer == XS_JSON_STREAM_BUSY)
+		mxTypeError("busy");
+	if (status->value.integer == XS_JSON_STREAM_CLOSED)
+		mxTypeError("closed");
+	if (mxArgc < 1)
+		mxTypeError("no chunk");
+	status->value.integer = XS_JSON_STREAM_BUSY;
+	mxTry(the) {
+		txSlot* buffer = mxJSONStreamBuffer(state);
+		txSize offset = mxJSONStreamOffset(state)->value.integer;
+		txSize tail = buffer->value.arrayBuffer.length - offset;
+		txJSONParser aChunk;
+		txSize start, size;
+		c_memset(&aChunk, 0, sizeof(txJSONParser));
+		if (fxParseJSONBuffer(the, &aChunk, mxArgv(0), C_NULL)) {
+			start = aChunk.offset;
+			size = aChunk.size - aChunk.offset;
+		}
+		else {
+			fxToString(the, mxArgv(0));
+			aChunk.slot = mxArgv(0);
+			start = 0;
+			size = (txSize)c_strlen(aChunk.slot->value.string);
+		}
+		if (size) {
+			/* the unparsed tail of the former chunks is followed by the chunk */
+			txSize length = fxAddChunkSizes(the, tail, size);
+			txByte* address = (txByte*)fxNewChunk(the, length);
+			if (tail)
+				c_memcpy(address, buffer->value.arrayBuffer.address + offset, tail);
+			c_memcpy(address + tail, mxJSONSource(&aChunk) + start, size);
+			buffer->value.arrayBuffer.address = address;
+			buffer->value.arrayBuffer.length = length;
+			mxJSONStreamOffset(state)->value.integer = 0;
+			fxParseJSONStream(the, state, 1);
+		}
+		status->value.integer = XS_JSON_STREAM_IDLE;
+	}
+	mxCatch(the) {
+		fxParseJSONStreamReset(the, state);
+		fxJump(the);
+	}
+}
+
 void fxParseJSON(txMachine* the, txJSONParser* theParser)
 {
 	mxPush(mxEmptyString);
@@ -169,6 +381,7 @@ void fxParseJSONArray(txMachine* the, txJSONParser* theParser)
 	txSlot* anItem;
 
 	mxCheckCStack();
+	theParser->depth++;
 	fxParseJSONToken(the, theParser);
 	mxPush(mxArrayPrototype);
 	anArray = fxNewArrayInstance(the);
@@ -193,9 +406,359 @@ void fxParseJSONArray(txMachine* the, txJSONParser* theParser)
 	}
 	anArray->next->value.array.length = aLength;
 	fxCacheArray(the, anArray);
+	theParser->depth--;
 	fxParseJSONToken(the, theParser);
 }
 
+txBoolean fxParseJSONBuffer(txMachine* the, txJSONParser* theParser, txSlot* source, txSlot* options)
+{
+	txSlot* slot;
+	txNumber offset = 0, size = -1;
+	if (source->kind != XS_REFERENCE_KIND)
+		return 0;
+	slot = source->value.reference->next;
+	if (!slot || !(slot->flag & XS_INTERNAL_FLAG))
+		return 0;
+	if ((slot->kind != XS_ARRAY_BUFFER_KIND) && (slot->kind != XS_TYPED_ARRAY_KIND) && (slot->kind != XS_DATA_VIEW_KIND))
+		return 0;
+	/* options can run code, so they are read before the buffer */
+	if (options && mxIsReference(options)) {
+		mxPushSlot(options);
+		mxGetID(mxID(_byteOffset));
+		if (!mxIsUndefined(the->stack)) {
+			offset = fxToNumber(the, the->stack);
+			if ((offset < 0) || (offset != c_trunc(offset)))
+				mxRangeError("invalid byteOffset");
+		}
+		mxPop();
+		mxPushSlot(options);
+		mxGetID(mxID(_byteLength));
+		if (!mxIsUndefined(the->stack)) {
+			size = fxToNumber(the, the->stack);
+			if ((size < 0) || (size != c_trunc(size)))
+				mxRangeError("invalid byteLength");
+		}
+		mxPop();
+		mxPushSlot(options);
+		mxGetID(mxID(_partial));
+		theParser->partial = fxToBoolean(the, the->stack);
+		mxPop();
+	}
+	slot = fxGetJSONBuffer(the, slot, &(theParser->offset), &(theParser->size));
+	if (offset > theParser->size)
+		mxRangeError("out of range byteOffset");
+	theParser->offset += (txSize)offset;
+	theParser->size -= (txSize)offset;
+	if (size >= 0) {
+		if (size > theParser->size)
+			mxRangeError("out of range byteLength");
+		theParser->size = (txSize)size;
+	}
+	theParser->size += theParser->offset;
+	theParser->slot = slot;
+	return 1;
+}
+
+#if mxJSONKeyCache
+txBoolean fxParseJSONCachedName(txMachine* the, txJSONParser* theParser, txID id, txSize length)
+{
+	txString source = mxJSONSource(theParser);
+	txString p = source + theParser->offset;
+	txString limit = source + theParser->size;
+	txInteger line = theParser->line;
+	txString string;
+	while (p < limit) {
+		if ((*p == ' ') || (*p == '\t'))
+			p++;
+		else if (*p == 10) {
+			p++;
+			line++;
+		}
+		else if (*p == 13) {
+			p++;
+			line++;
+			if ((p < limit) && (*p == 10))
+				p++;
+		}
+		else
+			break;
+	}
+	if ((mxPtrDiff(limit - p) < length + 2) || (*p != '"') || (p[length + 1] != '"'))
+		return 0;
+	string = fxGetKey(the, id)->value.key.string;
+	if (c_memcmp(p + 1, string, length))
+		return 0;
+	theParser->offset = mxPtrDiff(p + length + 2 - source);
+	theParser->line = line;
+	return 1;
+}
+#endif
+
+txString fxParseJSONCharacter(txString string, txString limit, txInteger* character)
+{
+	txU1* p = (txU1*)string;
+	txU4 c, minimum;
+	txInteger size;
+	if (p >= (txU1*)limit)
+		goto error;
+	c = c_read8(p++);
+	if (c < 0x80) {
+		*character = (txInteger)c;
+		return (txString)p;
+	}
+	if ((c & 0xE0) == 0xC0) {
+		c &= 0x1F;
+		minimum = 0x80;
+		size = 1;
+	}
+	else if ((c & 0xF0) == 0xE0) {
+		c &= 0x0F;
+		minimum = 0x800;
+		size = 2;
+	}
+	else if ((c & 0xF8) == 0xF0) {
+		c &= 0x07;
+		minimum = 0x10000;
+		size = 3;
+	}
+	else
+		goto error;
+	if (mxPtrDiff((txU1*)limit - p) < size)
+		goto error;
+	while (size > 0) {
+		txU4 d = c_read8(p++);
+		if ((d & 0xC0) != 0x80)
+			goto error;
+		c = (c << 6) | (d & 0x3F);
+		size--;
+	}
+	if ((c < minimum) || (c > 0x10FFFF) || ((0xD800 <= c) && (c <= 0xDFFF)))
+		goto error;
+	*character = (txInteger)c;
+	return (txString)p;
+error:
+	*character = C_EOF;
+	return string;
+}
+
+void fxParseJSONStream(txMachine* the, txSlot* state, txBoolean streaming)
+{
+	txSlot* buffer = mxJSONStreamBuffer(state);
+	txSlot* frames = mxJSONStreamFrames(state);
+	txSlot* frame;
+	txJSONParser aParser;
+
+	c_memset(&aParser, 0, sizeof(txJSONParser));
+	aParser.slot = buffer;
+	aParser.offset = mxJSONStreamOffset(state)->value.integer;
+	aParser.size = buffer->value.arrayBuffer.length;
+	aParser.line = mxJSONStreamLine(state)->value.integer;
+	aParser.streaming = streaming;
+	mxPush(mxEmptyString);
+	aParser.string = the->stack;
+	while (buffer->value.arrayBuffer.address) {
+		fxParseJSONToken(the, &aParser);
+		if ((aParser.token == XS_JSON_TOKEN_MORE) || (aParser.token == XS_JSON_TOKEN_EOF))
+			break;
+		frame = frames->next;
+		switch (frame ? frame->next->next->value.integer : XS_JSON_EXPECT_VALUE) {
+		case XS_JSON_EXPECT_FIRST_ITEM:
+			if (aParser.token == XS_JSON_TOKEN_RIGHT_BRACKET) {
+				fxParseJSONStreamPop(the, state);
+				break;
+			}
+			/* continue */
+		case XS_JSON_EXPECT_ITEM:
+		case XS_JSON_EXPECT_MEMBER:
+		case XS_JSON_EXPECT_VALUE:
+			switch (aParser.token) {
+			case XS_JSON_TOKEN_FALSE:
+				mxPushBoolean(0);
+				fxParseJSONStreamValue(the, state, 0);
+				break;
+			case XS_JSON_TOKEN_TRUE:
+				mxPushBoolean(1);
+				fxParseJSONStreamValue(the, state, 0);
+				break;
+			case XS_JSON_TOKEN_NULL:
+				mxPushNull();
+				fxParseJSONStreamValue(the, state, 0);
+				break;
+			case XS_JSON_TOKEN_INTEGER:
+				mxPushInteger(aParser.integer);
+				fxParseJSONStreamValue(the, state, 0);
+				break;
+			case XS_JSON_TOKEN_NUMBER:
+				mxPushNumber(aParser.number);
+				fxParseJSONStreamValue(the, state, 0);
+				break;
+			case XS_JSON_TOKEN_STRING:
+				mxPushString(aParser.string->value.string);
+				fxParseJSONStreamValue(the, state, 0);
+				break;
+			case XS_JSON_TOKEN_LEFT_BRACE:
+				mxPush(mxObjectPrototype);
+				fxNewObjectInstance(the);
+				fxParseJSONStreamPush(the, state, XS_JSON_EXPECT_FIRST_NAME);
+				break;
+			case XS_JSON_TOKEN_LEFT_BRACKET:
+				mxPush(mxArrayPrototype);
+				fxNewArrayInstance(the);
+				fxParseJSONStreamPush(the, state, XS_JSON_EXPECT_FIRST_ITEM);
+				break;
+			default:
+				mxSyntaxError("%ld: invalid value", aParser.line);
+				break;
+			}
+			break;
+		case XS_JSON_EXPECT_ITEM_COMMA:
+			if (aParser.token == XS_JSON_TOKEN_COMMA)
+				frame->next->next->value.integer = XS_JSON_EXPECT_ITEM;
+			else if (aParser.token == XS_JSON_TOKEN_RIGHT_BRACKET)
+				fxParseJSONStreamPop(the, state);
+			else
+				mxSyntaxError("%ld: missing ,", aParser.line);
+			break;
+		case XS_JSON_EXPECT_FIRST_NAME:
+			if (aParser.token == XS_JSON_TOKEN_RIGHT_BRACE) {
+				fxParseJSONStreamPop(the, state);
+				break;
+			}
+			/* continue */
+		case XS_JSON_EXPECT_NAME:
+			if (aParser.token != XS_JSON_TOKEN_STRING)
+				mxSyntaxError("%ld: missing name", aParser.line);
+			fxParseJSONName(the, &aParser);
+			frame->next->kind = the->stack->kind;
+			frame->next->value = the->stack->value;
+			mxPop();
+			frame->next->next->value.integer = XS_JSON_EXPECT_COLON;
+			break;
+		case XS_JSON_EXPECT_COLON:
+			if (aParser.token != XS_JSON_TOKEN_COLON)
+				mxSyntaxError("%ld: missing :", aParser.line);
+			frame->next->next->value.integer = XS_JSON_EXPECT_MEMBER;
+			break;
+		case XS_JSON_EXPECT_MEMBER_COMMA:
+			if (aParser.token == XS_JSON_TOKEN_COMMA)
+				frame->next->next->value.integer = XS_JSON_EXPECT_NAME;
+			else if (aParser.token == XS_JSON_TOKEN_RIGHT_BRACE)
+				fxParseJSONStreamPop(the, state);
+			else
+				mxSyntaxError("%ld: missing ,", aParser.line);
+			break;
+		}
+	}
+	if (!streaming && frames->next)
+		mxSyntaxError("%ld: missing %c", aParser.line, (frames->next->next->kind == XS_INTEGER_KIND) ? ']' : '}');
+	mxJSONStreamOffset(state)->value.integer = aParser.offset;
+	mxJSONStreamLine(state)->value.integer = aParser.line;
+	if (aParser.offset == buffer->value.arrayBuffer.length) {
+		buffer->value.arrayBuffer.address = C_NULL;
+		buffer->value.arrayBuffer.length = 0;
+		mxJSONStreamOffset(state)->value.integer = 0;
+	}
+	mxPop();
+}
+
+void fxParseJSONStreamPop(txMachine* the, txSlot* state)
+{
+	txSlot* frames = mxJSONStreamFrames(state);
+	txSlot* frame = frames->next;
+	txInteger expect = frame->next->next->value.integer;
+	mxPushSlot(frame);
+	frames->next = frame->next->next->next;
+	frames->value.integer--;
+	/* empty containers have no values to report, so they are reported like primitives */
+	fxParseJSONStreamValue(the, state, ((expect == XS_JSON_EXPECT_FIRST_ITEM) || (expect == XS_JSON_EXPECT_FIRST_NAME)) ? 0 : 1);
+}
+
+void fxParseJSONStreamPush(txMachine* the, txSlot* state, txInteger expect)
+{
+	txSlot* frames = mxJSONStreamFrames(state);
+	txSlot* slot;
+	/* a frame is the container, the key of its next value and what is expected next, the innermost frame is first */
+	slot = fxNewSlot(the);
+	slot->next = frames->next;
+	slot->kind = XS_INTEGER_KIND;
+	slot->value.integer = expect;
+	frames->next = slot;
+	slot = fxNewSlot(the);
+	slot->next = frames->next;
+	if (expect == XS_JSON_EXPECT_FIRST_ITEM) {
+		slot->kind = XS_INTEGER_KIND;
+		slot->value.integer = 0;
+	}
+	else
+		slot->kind = XS_UNDEFINED_KIND;
+	frames->next = slot;
+	slot = fxNewSlot(the);
+	slot->next = frames->next;
+	slot->kind = the->stack->kind;
+	slot->value = the->stack->value;
+	frames->next = slot;
+	frames->value.integer++;
+	mxPop();
+}
+
+void fxParseJSONStreamReset(txMachine* the, txSlot* state)
+{
+	txSlot* buffer = mxJSONStreamBuffer(state);
+	txSlot* frames = mxJSONStreamFrames(state);
+	buffer->value.arrayBuffer.address = C_NULL;
+	buffer->value.arrayBuffer.length = 0;
+	mxJSONStreamOffset(state)->value.integer = 0;
+	mxJSONStreamStatus(state)->value.integer = XS_JSON_STREAM_CLOSED;
+	frames->next = C_NULL;
+	frames->value.integer = 0;
+}
+
+void fxParseJSONStreamValue(txMachine* the, txSlot* state, txBoolean container)
+{
+	txSlot* value = the->stack;
+	txSlot* frames = mxJSONStreamFrames(state);
+	txSlot* frame = frames->next;
+	txSlot* key = (frame) ? frame->next : C_NULL;
+	txInteger depth = frames->value.integer;
+	txInteger target = mxJSONStreamDepth(state)->value.integer;
+	if (depth > target) {
+		txSlot* property;
+		if (key->kind == XS_INTEGER_KIND)
+			property = mxBehaviorSetProperty(the, frame->value.reference, 0, (txIndex)key->value.integer, XS_OWN);
+		else
+			property = mxBehaviorSetProperty(the, frame->value.reference, key->value.at.id, key->value.at.index, XS_OWN);
+		property->kind = value->kind;
+		property->value = value->value;
+	}
+	else if (!container || (depth == target)) {
+		/* non-empty containers above the target depth are not reported, their values already were */
+		mxPushUndefined();
+		mxPushSlot(mxJSONStreamCallback(state));
+		mxCall();
+		mxPushSlot(value);
+		if (!key)
+			mxPushUndefined();
+		else if (key->kind == XS_INTEGER_KIND)
+			mxPushInteger(key->value.integer);
+		else {
+			mxPushUndefined();
+			fxKeyAt(the, key->value.at.id, key->value.at.index, the->stack);
+		}
+		mxPushInteger(depth);
+		mxRunCount(3);
+		mxPop();
+	}
+	mxPop();
+	if (frame) {
+		if (key->kind == XS_INTEGER_KIND) {
+			key->value.integer++;
+			frame->next->next->value.integer = XS_JSON_EXPECT_ITEM_COMMA;
+		}
+		else
+			frame->next->next->value.integer = XS_JSON_EXPECT_MEMBER_COMMA;
+	}
+}
+
 void fxParseJSONToken(txMachine* the, txJSONParser* theParser)
 {
 	txInteger character;
@@ -203,16 +766,31 @@ void fxParseJSONToken(txMachine* the, txJSONParser* theParser)
 	txNumber number;
 	txSize offset;
 	txSize size;
-	txString p, s;
+	txString p, q, s, t, limit;
+	txBoolean buffered = (theParser->slot->kind == XS_ARRAY_BUFFER_KIND) ? 1 : 0;
 
+	/* reads stop at the end of the source, which buffers do not terminate */
+	#define mxJSONPeek(P) (((P) < limit) ? *(P) : 0)
+	if (theParser->partial && !theParser->depth && theParser->token) {
+		/* the value is complete, the next token belongs to the next value */
+		theParser->token = XS_JSON_TOKEN_EOF;
+		return;
+	}
 	theParser->integer = 0;
 	theParser->number = 0;
 	theParser->string->value.string = mxEmptyString.value.string;
 	theParser->token = XS_NO_JSON_TOKEN;
-	p = theParser->slot->value.string + theParser->offset;
+	p = mxJSONSource(theParser);
+	limit = p + theParser->size;
+	p += theParser->offset;
 	while (theParser->token == XS_NO_JSON_TOKEN) {
-		switch (*p) {
+		q = p;
+		switch (mxJSONPeek(p)) {
 		case 0:
+			if (p < limit)
+				goto error;
+			if (theParser->streaming)
+				goto more;
 			theParser->token = XS_JSON_TOKEN_EOF;
 			break;
 		case 10:
@@ -220,9 +798,11 @@ void fxParseJSONToken(txMachine* the, txJSONParser* theParser)
 			theParser->line++;
 			break;
 		case 13:
+			if (theParser->streaming && ((p + 1) >= limit))
+				goto more;
 			p++;
 			theParser->line++;
-			if (*p == 10)
+			if (mxJSONPeek(p) == 10)
 				p++;
 			break;
 		case '\t':
@@ -241,34 +821,35 @@ void fxParseJSONToken(txMachine* the, txJSONParser* theParser)
 		case '8':
 		case '9':
 			s = p;
-			if (*p == '-')
+			if (mxJSONPeek(p) == '-')
 				p++;
-			if (('0' <= *p) && (*p <= '9')) {
-				if (*p == '0') {
+			if (('0' <= mxJSONPeek(p)) && (mxJSONPeek(p) <= '9')) {
+				if (mxJSONPeek(p) == '0') {
 					p++;
 				}
 				else {
 					p++;
-					while (('0' <= *p) && (*p <= '9'))
+					while (('0' <= mxJSONPeek(p)) && (mxJSONPeek(p) <= '9'))
 						p++;
 				}
-				if (*p == '.') {
+				t = p;
+				if (mxJSONPeek(p) == '.') {
 					p++;
-					if (('0' <= *p) && (*p <= '9')) {
+					if (('0' <= mxJSONPeek(p)) && (mxJSONPeek(p) <= '9')) {
 						p++;
-						while (('0' <= *p) && (*p <= '9'))
+						while (('0' <= mxJSONPeek(p)) && (mxJSONPeek(p) <= '9'))
 							p++;
 					}
 					else
 						goto error;
 				}
-				if ((*p == 'e') || (*p == 'E')) {
+				if ((mxJSONPeek(p) == 'e') || (mxJSONPeek(p) == 'E')) {
 					p++;
-					if ((*p == '+') || (*p == '-'))
+					if ((mxJSONPeek(p) == '+') || (mxJSONPeek(p) == '-'))
 						p++;
-					if (('0' <= *p) && (*p <= '9')) {
+					if (('0' <= mxJSONPeek(p)) && (mxJSONPeek(p) <= '9')) {
 						p++;
-						while (('0' <= *p) && (*p <= '9'))
+						while (('0' <= mxJSONPeek(p)) && (mxJSONPeek(p) <= '9'))
 							p++;
 					}
 					else
@@ -277,12 +858,26 @@ void fxParseJSONToken(txMachine* the, txJSONParser* theParser)
 			}
 			else
 				goto error;
+			if (theParser->streaming && (p >= limit))
+				goto more;
 			size = mxPtrDiff(p - s);
-			if ((size_t)(size + 1) > sizeof(the->nameBuffer))
-				mxSyntaxError("%ld: number overflow", theParser->line);
-			c_memcpy(the->nameBuffer, s, size);
-			the->nameBuffer[size] = 0;
-			theParser->number = fxStringToNumber(the->dtoa, the->nameBuffer, 0);
+			if ((p == t) && (size <= 15)) {
+				/* integers without fraction nor exponent, up to 15 characters, are exact doubles */
+				txU8 value = 0;
+				t = s;
+				if (*t == '-')
+					t++;
+				while (t < p)
+					value = (value * 10) + (*t++ - '0');
+				theParser->number = (*s == '-') ? -(txNumber)value : (txNumber)value;
+			}
+			else {
+				if ((size_t)(size + 1) > sizeof(the->nameBuffer))
+					mxSyntaxError("%ld: number overflow", theParser->line);
+				c_memcpy(the->nameBuffer, s, size);
+				the->nameBuffer[size] = 0;
+				theParser->number = fxStringToNumber(the->dtoa, the->nameBuffer, 0);
+			}
 			theParser->integer = (txInteger)theParser->number;
 			number = theParser->integer;
 			if ((theParser->number == number) && (theParser->number != -0))
@@ -317,10 +912,13 @@ void fxParseJSONToken(txMachine* the, txJSONParser* theParser)
 		case '"':
 			p++;
 			escaped = 0;
-			offset = mxPtrDiff(p - theParser->slot->value.string);
+			offset = mxPtrDiff(p - mxJSONSource(theParser));
 			size = 0;
 			for (;;) {
-				p = fxUTF8Decode(p, &character);
+				if (buffered)
+					p = fxParseJSONCharacter(p, limit, &character);
+				else
+					p = fxUTF8Decode(p, &character);
 				if (character < 32) {
 					goto error;
 				}
@@ -329,7 +927,7 @@ void fxParseJSONToken(txMachine* the, txJSONParser* theParser)
 				}
 				else if (character == '\\') {
 					escaped = 1;
-					switch (*p) {
+					switch (mxJSONPeek(p)) {
 					case '"':
 					case '/':
 					case '\\':
@@ -343,7 +941,9 @@ void fxParseJSONToken(txMachine* the, txJSONParser* theParser)
 						break;
 					case 'u':
 						p++;
-						if (fxParseUnicodeEscape(&p, &character, 0, '\\'))
+						if (theParser->streaming && (mxPtrDiff(limit - p) < 10))
+							goto more;
+						if (fxParseJSONUnicodeEscape(&p, limit, &character))
 							size += fxUTF8Length(character);
 						else
 							goto error;
@@ -357,15 +957,17 @@ void fxParseJSONToken(txMachine* the, txJSONParser* theParser)
 				}
 			}
 			s = theParser->string->value.string = fxNewChunk(the, size + 1);
-			p = theParser->slot->value.string + offset;
+			p = mxJSONSource(theParser);
+			limit = p + theParser->size;
+			p += offset;
 			if (escaped) {
 				for (;;) {
-					if (*p == '"') {
+					if (mxJSONPeek(p) == '"') {
 						p++;
 						*s = 0;
 						break;
 					}
-					else if (*p == '\\') {
+					else if (mxJSONPeek(p) == '\\') {
 						p++;
 						switch (*p) {
 						case '"':
@@ -395,7 +997,7 @@ void fxParseJSONToken(txMachine* the, txJSONParser* theParser)
 							break;
 						case 'u':
 							p++;
-							fxParseUnicodeEscape(&p, &character, 0, '\\');
+							fxParseJSONUnicodeEscape(&p, limit, &character);
 							s = fxUTF8Encode(s, character);
 							break;
 						}
@@ -414,43 +1016,108 @@ void fxParseJSONToken(txMachine* the, txJSONParser* theParser)
 			break;
 		case 'f':
 			p++;
-			if (*p != 'a') goto error;	
+			if (mxJSONPeek(p) != 'a') goto error;	
 			p++;
-			if (*p != 'l') goto error;	
+			if (mxJSONPeek(p) != 'l') goto error;	
 			p++;
-			if (*p != 's') goto error;	
+			if (mxJSONPeek(p) != 's') goto error;	
 			p++;
-			if (*p != 'e') goto error;	
+			if (mxJSONPeek(p) != 'e') goto error;	
 			p++;
 			theParser->token = XS_JSON_TOKEN_FALSE;
 			break;
 		case 'n':
 			p++;
-			if (*p != 'u') goto error;
+			if (mxJSONPeek(p) != 'u') goto error;
 			p++;
-			if (*p != 'l') goto error;
+			if (mxJSONPeek(p) != 'l') goto error;
 			p++;
-			if (*p != 'l') goto error;
+			if (mxJSONPeek(p) != 'l') goto error;
 			p++;
 			theParser->token = XS_JSON_TOKEN_NULL;
 			break;
 		case 't':
 			p++;
-			if (*p != 'r') goto error;
+			if (mxJSONPeek(p) != 'r') goto error;
 			p++;
-			if (*p != 'u') goto error;
+			if (mxJSONPeek(p) != 'u') goto error;
 			p++;
-			if (*p != 'e') goto error;
+			if (mxJSONPeek(p) != 'e') goto error;
 			p++;
 			theParser->token = XS_JSON_TOKEN_TRUE;
 			break;
 		default:
 		error:
+			/* near the end of a chunk, the next chunk can complete the token */
+			if (theParser->streaming && (mxPtrDiff(limit - p) < 10))
+				goto more;
 			mxSyntaxError("%ld: invalid character", theParser->line);	
 			break;
+		more:
+			theParser->token = XS_JSON_TOKEN_MORE;
+			p = q;
+			break;
 		}
 	}
-	theParser->offset = mxPtrDiff(p - theParser->slot->value.string);
+	theParser->offset = mxPtrDiff(p - mxJSONSource(theParser));
+	#undef mxJSONPeek
+}
+
+txBoolean fxParseJSONUnicodeEscape(txString* string, txString limit, txInteger* character)
+{
+	txString p = *string;
+	if (mxPtrDiff(limit - p) < 10) {
+		/* the escape and a trailing surrogate can take ten bytes, near the end of the source they are parsed from a terminated copy */
+		char buffer[11];
+		txSize size = mxPtrDiff(limit - p);
+		txString q = buffer;
+		c_memcpy(buffer, p, size);
+		buffer[size] = 0;
+		if (!fxParseUnicodeEscape(&q, character, 0, '\\'))
+			return 0;
+		*string = p + mxPtrDiff(q - buffer);
+		return 1;
+	}
+	return fxParseUnicodeEscape(string, character, 0, '\\');
+}
+
+void fxParseJSONName(txMachine* the, txJSONParser* theParser)
+{
+	txSlot* at;
+	txIndex index;
+	txID id;
+
+	mxPushString(theParser->string->value.string);
+	at = the->stack;
+	index = 0;
+	if (theParser->keys) {
+		at->kind = XS_UNDEFINED_KIND;
+		if (fxStringToIndex(the->dtoa, at->value.string, &index))
+			id = 0;
+		else
+			id = fxFindName(the, at->value.string);
+		if (id != XS_NO_ID) {
+			txSlot* item = theParser->keys->value.reference->next;
+			while (item) {
+				if ((item->value.at.id == id) && (item->value.at.index == index)) {
+					at->value.at.id = id;
+					at->value.at.index = index;
+					at->kind = XS_AT_KIND;
+					break;
+				}
+				item = item->next;
+			}
+		}
+	}
+	else {
+		if (fxStringToIndex(the->dtoa, at->value.string, &index))
+			id = 0;
+		else
+			id = fxNewCollectableName(the, at);
+		at->value.at.id = id;
+	at->value.at.index = index;
+		at->kind = XS_AT_KIND;
+	}
 }
 
 void fxParseJSONObject(txMachine* the, txJSONParser* theParser)
@@ -458,70 +1125,96 @@ void fxParseJSONObject(txMachine* the, txJSONParser* theParser)
 	txSlot* anObject;
 	txBoolean comma = 0;
 	txSlot* at;
-	txIndex index;
-	txID id;
 	txSlot* aProperty;
+#if mxJSONKeyCache
+	txJSONKeyCache* cache = C_NULL;
+	txInteger count = 0;
+	txSlot* last;
+#endif
 
 	mxCheckCStack();
-	fxParseJSONToken(the, theParser);
+	theParser->depth++;
 	mxPush(mxObjectPrototype);
 	anObject = fxNewObjectInstance(the);
+#if mxJSONKeyCache
+	/* while the keys are the keys of the former object at the same depth, they are new and their properties are appended */
+	if (!theParser->keys && (theParser->depth <= mxJSONKeyCacheDepth))
+		cache = &(theParser->keyCaches[theParser->depth - 1]);
+	last = anObject;
+#endif
 	for (;;) {
-		if (theParser->token == XS_JSON_TOKEN_RIGHT_BRACE)
-			break;
-		if (comma) {
-			if (theParser->token == XS_JSON_TOKEN_COMMA)
-				fxParseJSONToken(the, theParser);
-			else
-				mxSyntaxError("%ld: missing ,", theParser->line);	
-		}	
-		if (theParser->token != XS_JSON_TOKEN_STRING)
-			mxSyntaxError("%ld: missing name", theParser->line);
-		mxPushString(theParser->string->value.string);
-		at = the->stack;
-		index = 0;
-		if (theParser->keys) {
-			at->kind = XS_UNDEFINED_KIND;
-			if (fxStringToIndex(the->dtoa, at->value.string, &index))
-				id = 0;
-			else
-				id = fxFindName(the, at->value.string);
-			if (id != XS_NO_ID) {
-				txSlot* item = theParser->keys->value.reference->next;
-				while (item) {
-					if ((item->value.at.id == id) && (item->value.at.index == index)) {
-						at->value.at.id = id;
-						at->value.at.index = index;
-						at->kind = XS_AT_KIND;
-						break;
+#if mxJSONKeyCache
+		if (cache && (count < cache->count) && fxParseJSONCachedName(the, theParser, cache->ids[count], cache->lengths[count])) {
+			fxParseJSONToken(the, theParser);
+			if (theParser->token != XS_JSON_TOKEN_COLON)
+				mxSyntaxError("%ld: missing :", theParser->line);
+			fxParseJSONToken(the, theParser);
+			fxParseJSONValue(the, theParser);
+			aProperty = fxNewProperty(the, &(last->next), cache->ids[count], XS_NO_FLAG);
+			aProperty->kind = the->stack->kind;
+			aProperty->value = the->stack->value;
+		#if mxPropertyCacheKeys
+			if (mxInstanceIndex(anObject) > 0)
+				mxInstanceIndex(anObject) = fxNextPropertyCacheKey(the, mxInstanceIndex(anObject), count, aProperty->ID);
+		#endif
+			last = aProperty;
+			count++;
+			mxPop();
+		}
+		else
+#endif
+		{
+			fxParseJSONToken(the, theParser);
+			if (!comma && (theParser->token == XS_JSON_TOKEN_RIGHT_BRACE))
+				break;
+			if (theParser->token != XS_JSON_TOKEN_STRING)
+				mxSyntaxError("%ld: missing name", theParser->line);
+			fxParseJSONName(the, theParser);
+			at = the->stack;
+			fxParseJSONToken(the, theParser);
+			if (theParser->token != XS_JSON_TOKEN_COLON)
+				mxSyntaxError("%ld: missing :", theParser->line);
+			fxParseJSONToken(the, theParser);
+			fxParseJSONValue(the, theParser);
+			aProperty = C_NULL;
+			if ((at->kind == XS_AT_KIND) && (the->stack->kind != XS_UNDEFINED_KIND)) {
+				aProperty = mxBehaviorSetProperty(the, anObject, at->value.at.id, at->value.at.index, XS_OWN);
+				aProperty->kind = the->stack->kind;
+				aProperty->value = the->stack->value;
+			}
+#if mxJSONKeyCache
+			if (cache) {
+				/* the key replaces the rest of the cached keys if it is a new name that can be compared with the source */
+				cache->count = count;
+				if (aProperty && aProperty->ID && (aProperty == last->next) && (count < mxJSONKeyCacheLength)) {
+					txString string = fxGetKey(the, aProperty->ID)->value.key.string;
+					txSize length = 0;
+					txU1 c;
+					while ((c = (txU1)string[length]) && (c != '"') && (c != '\\') && (c >= 32))
+						length++;
+					if (c == 0) {
+						cache->ids[count] = aProperty->ID;
+						cache->lengths[count] = length;
+						cache->count = ++count;
+						last = aProperty;
 					}
-					item = item->next;
+					else
+						cache = C_NULL;
 				}
+				else
+					cache = C_NULL;
 			}
+#endif
+			mxPop();
+			mxPop();
 		}
-		else {
-			if (fxStringToIndex(the->dtoa, at->value.string, &index))
-				id = 0;
-			else
-				id = fxNewName(the, at);
-			at->value.at.id = id;
-            at->value.at.index = index;
-			at->kind = XS_AT_KIND;
-		}
-		fxParseJSONToken(the, theParser);
-		if (theParser->token != XS_JSON_TOKEN_COLON)
-			mxSyntaxError("%ld: missing :", theParser->line);
-		fxParseJSONToken(the, theParser);
-		fxParseJSONValue(the, theParser);
-		if ((at->kind == XS_AT_KIND) && (the->stack->kind != XS_UNDEFINED_KIND)) {
-			aProperty = mxBehaviorSetProperty(the, anObject, at->value.at.id, at->value.at.index, XS_OWN);
-			aProperty->kind = the->stack->kind;
-			aProperty->value = the->stack->value;
-		}
-		mxPop();
-		mxPop();
+		if (theParser->token == XS_JSON_TOKEN_RIGHT_BRACE)
+			break;
+		if (theParser->token != XS_JSON_TOKEN_COMMA)
+			mxSyntaxError("%ld: missing ,", theParser->line);	
 		comma = 1;
 	}
+	theParser->depth--;
 	fxParseJSONToken(the, theParser);
 }
 
@@ -628,13 +1321,23 @@ void fx_JSON_stringify(txMachine* the)
 	mxTry(the) {
 		c_memset((txJSONStringifier*)&aStringifier, 0, sizeof(aStringifier));
 		fxStringifyJSON(the, (txJSONStringifier*)&aStringifier);
-		if (aStringifier.offset) {
+		if (aStringifier.output) {
+			if (aStringifier.offset && aStringifier.write)
+				fxStringifyJSONFlush(the, (txJSONStringifier*)&aStringifier);
+			aStringifier.total += aStringifier.offset;
+			if (aStringifier.total) {
+				mxResult->value.number = aStringifier.total;
+				mxResult->kind = XS_NUMBER_KIND;
+			}
+		}
+		else if (aStringifier.offset) {
 			fxStringifyJSONChar(the, (txJSONStringifier*)&aStringifier, 0);
 			mxResult->value.string = (txString)fxNewChunk(the, aStringifier.offset);
 			c_memcpy(mxResult->value.string, aStringifier.buffer, aStringifier.offset);
 			mxResult->kind = XS_STRING_KIND;
 		}
-		c_free(aStringifier.buffer);
+		if (aStringifier.buffer)
+			c_free(aStringifier.buffer);
 	}
 	mxCatch(the) {
 		if (aStringifier.buffer)
@@ -651,10 +1354,43 @@ void fxStringifyJSON(txMachine* the, txJSONStringifier* theStringifier)
 	
 	aSlot = fxGetInstance(the, mxThis);
 	theStringifier->offset = 0;
-	theStringifier->size = 1024;
-	theStringifier->buffer = c_malloc(1024);
-	if (!theStringifier->buffer)
-		fxAbort(the, XS_NOT_ENOUGH_MEMORY_EXIT);
+	if ((mxArgc > 3) && mxIsReference(mxArgv(3))) {
+		/* the text is written into the bytes of the buffer, the write function empties the buffer when it is full */
+		mxPushSlot(mxArgv(3));
+		mxGetID(mxID(_buffer));
+		theStringifier->target = the->stack;
+		mxPushSlot(mxArgv(3));
+		mxGetID(mxID(_write));
+		theStringifier->write = the->stack;
+		if (mxIsUndefined(theStringifier->target) && mxIsUndefined(theStringifier->write)) {
+			/* options without buffer nor write are ignored */
+			mxPop();
+			mxPop();
+			theStringifier->target = C_NULL;
+			theStringifier->write = C_NULL;
+		}
+		else {
+			if (mxIsUndefined(theStringifier->write))
+				theStringifier->write = C_NULL;
+			else if (!fxIsCallable(the, theStringifier->write))
+				mxTypeError("write is no function");
+			if (mxIsUndefined(theStringifier->target))
+				fxArrayBuffer(the, theStringifier->target, C_NULL, mxJSONBlockSize);
+			aSlot = theStringifier->target;
+			if (!mxIsReference(aSlot) || !(aSlot = aSlot->value.reference->next) || !(aSlot->flag & XS_INTERNAL_FLAG) 
+					|| ((aSlot->kind != XS_ARRAY_BUFFER_KIND) && (aSlot->kind != XS_TYPED_ARRAY_KIND) && (aSlot->kind != XS_DATA_VIEW_KIND)))
+				mxTypeError("buffer is no ArrayBuffer, TypedArray or DataView instance");
+			theStringifier->output = fxGetJSONBuffer(the, aSlot, &(theStringifier->base), &(theStringifier->size));
+			if (theStringifier->size == 0)
+				mxRangeError("empty buffer");
+		}
+	}
+	if (!theStringifier->output) {
+		theStringifier->size = 1024;
+		theStringifier->buffer = c_malloc(1024);
+		if (!theStringifier->buffer)
+			fxAbort(the, XS_NOT_ENOUGH_MEMORY_EXIT);
+	}
 
 	if (mxArgc > 1) {
 		aSlot = mxArgv(1);
@@ -706,6 +1442,10 @@ void fxStringifyJSON(txMachine* the, txJSONStringifier* theStringifier)
 void fxStringifyJSONChar(txMachine* the, txJSONStringifier* theStringifier, char c)
 {
     //fprintf(stderr, "%c", c);
+	if (theStringifier->output) {
+		fxStringifyJSONWrite(the, theStringifier, &c, 1);
+		return;
+	}
 	if (theStringifier->offset == theStringifier->size) {
 		char* aBuffer;
 		theStringifier->size += 1024;
@@ -723,6 +1463,10 @@ void fxStringifyJSONChars(txMachine* the, txJSONStringifier* theStringifier, cha
     //fprintf(stderr, "%s", s);
     if (!theSize)
     	theSize = mxStringLength(s);
+	if (theStringifier->output) {
+		fxStringifyJSONWrite(the, theStringifier, s, theSize);
+		return;
+	}
 	if ((theStringifier->offset + theSize) >= theStringifier->size) {
 		char* aBuffer;
 		theStringifier->size += ((theSize / 1024) + 1) * 1024;
@@ -735,6 +1479,25 @@ void fxStringifyJSONChars(txMachine* the, txJSONStringifier* theStringifier, cha
 	theStringifier->offset += theSize;
 }
 
+void fxStringifyJSONFlush(txMachine* the, txJSONStringifier* theStringifier)
+{
+	if (!theStringifier->write)
+		mxRangeError("buffer full");
+	/* THIS */
+	mxPushUndefined();
+	/* FUNCTION */
+	mxPushSlot(theStringifier->write);
+	mxCall();
+	/* ARGUMENTS */
+	mxPushSlot(theStringifier->target);
+	mxPushInteger(theStringifier->offset);
+	/* COUNT */
+	mxRunCount(2);
+	mxPop();
+	theStringifier->total += theStringifier->offset;
+	theStringifier->offset = 0;
+}
+
 void fxStringifyJSONIndent(txMachine* the, txJSONStringifier* theStringifier)
 {
 	txInteger aLevel;
@@ -768,7 +1531,7 @@ void fxStringifyJSONName(txMachine* the, txJSONStringifier* theStringifier, txIn
 			fxStringifyJSONChar(the, theStringifier, '"');
 		}
 		else
-			fxStringifyJSONString(the, theStringifier, aSlot->value.string);
+			fxStringifyJSONString(the, theStringifier, aSlot);
 		fxStringifyJSONChar(the, theStringifier, ':');
 		if (theStringifier->indent[0])
 			fxStringifyJSONChar(the, theStringifier, ' ');
@@ -867,7 +1630,7 @@ void fxStringifyJSONProperty(txMachine* the, txJSONStringifier* theStringifier,
 	}
 	else if ((aValue->kind == XS_STRING_KIND) || (aValue->kind == XS_STRING_X_KIND)) {
 		fxStringifyJSONName(the, theStringifier, theFlag);
-		fxStringifyJSONString(the, theStringifier, aValue->value.string);
+		fxStringifyJSONString(the, theStringifier, aValue);
 	}
 	else if ((aValue->kind == XS_BIGINT_KIND) || (aValue->kind == XS_BIGINT_X_KIND)) {
 		mxTypeError("stringify bigint");
@@ -959,12 +1722,21 @@ void fxStringifyJSONProperty(txMachine* the, txJSONStringifier* theStringifier,
 	mxPop(); // POP VALUE
 }
 
-void fxStringifyJSONString(txMachine* the, txJSONStringifier* theStringifier, txString theString)
+void fxStringifyJSONString(txMachine* the, txJSONStringifier* theStringifier, txSlot* theSlot)
 {
+	txSize offset = 0;
+	txString theString;
 	txString string;
 	txInteger character;	
+	char buffer[4];
 	fxStringifyJSONChar(the, theStringifier, '"');
-	while (((string = fxUTF8Decode(theString, &character))) && (character != C_EOF)) {
+	/* the write function can move the string, which is addressed from its slot */
+	for (;;) {
+		theString = theSlot->value.string + offset;
+		string = fxUTF8Decode(theString, &character);
+		if (character == C_EOF)
+			break;
+		offset += mxPtrDiff(string - theString);
 		if (character < 8)
 			fxStringifyJSONUnicodeEscape(the, theStringifier, character);
 		else if (character == 8)
@@ -993,9 +1765,10 @@ void fxStringifyJSONString(txMachine* the, txJSONStringifier* theStringifier, tx
 			fxStringifyJSONChar(the, theStringifier, (char)character);
 		else if ((0xD800 <= character) && (character <= 0xDFFF))
 			fxStringifyJSONUnicodeEscape(the, theStringifier, character);
-		else
-			fxStringifyJSONChars(the, theStringifier, theString, mxPtrDiff(string - theString));
-		theString = string;
+		else {
+			c_memcpy(buffer, theString, mxPtrDiff(string - theString));
+			fxStringifyJSONChars(the, theStringifier, buffer, mxPtrDiff(string - theString));
+		}
 	}
 	fxStringifyJSONChar(the, theStringifier, '"');
 }
@@ -1010,6 +1783,30 @@ void fxStringifyJSONUnicodeEscape(txMachine* the, txJSONStringifier* theStringif
 	fxStringifyJSONChars(the, theStringifier, buffer, mxPtrDiff(p - buffer));
 }
 
+void fxStringifyJSONWrite(txMachine* the, txJSONStringifier* theStringifier, char* s, txSize theSize)
+{
+	txSlot* output = theStringifier->output;
+	txSize size;
+	while (theSize) {
+		size = theStringifier->size - theStringifier->offset;
+		if (size == 0) {
+			fxStringifyJSONFlush(the, theStringifier);
+			continue;
+		}
+		if (size > theSize)
+			size = theSize;
+		/* the write function can detach the buffer */
+		if (output->value.arrayBuffer.address == C_NULL)
+			mxTypeError("detached buffer");
+		if (output->value.arrayBuffer.length < theStringifier->base + theStringifier->size)
+			mxRangeError("out of range buffer");
+		c_memcpy(output->value.arrayBuffer.address + theStringifier->base + theStringifier->offset, s, size);
+		theStringifier->offset += size;
+		s += size;
+		theSize -= size;
+	}
+}
+
 txSlot* fxToJSONKeys(txMachine* the, txSlot* reference)
 {
 	txSlot* list = fxNewInstance(the);
@@ -41,7 +41,7 @@
 	#define mxTableMinLength (1)
 #endif
 #ifndef mxTableMaxLength
-	#define mxTableMaxLength (1024 * 1024)
+	#define mxTableMaxLength (16 * 1024 * 1024)
 #endif
 #define mxTableThreshold(LENGTH) (((LENGTH) >> 1) + ((LENGTH) >> 2))
 
@@ -56,7 +56,6 @@ static txSlot* fxNewSetIteratorInstance(txMachine* the, txSlot* iterable, txInte
 static void fxClearEntries(txMachine* the, txSlot* table, txSlot* list, txBoolean paired);
 static txBoolean fxDeleteEntry(txMachine* the, txSlot* table, txSlot* list, txSlot* slot, txBoolean paired); 
 static txSlot* fxGetEntry(txMachine* the, txSlot* table, txSlot* slot);
-//static void fxPurgeEntries(txMachine* the, txSlot* list);
 static void fxResizeEntries(txMachine* the, txSlot* table, txSlot* list);
 static void fxSetEntry(txMachine* the, txSlot* table, txSlot* list, txSlot* slot, txSlot* pair); 
 static txBoolean fxTestEntry(txMachine* the, txSlot* a, txSlot* b);
@@ -214,7 +213,7 @@ txSlot* fxNewMapInstance(txMachine* the)
 	txSlot* table;
 	txSlot* list;
 	txSlot* size;
-	txSlot** address;
+	txHashEntry* entries;
 	map = fxNewSlot(the);
 	map->kind = XS_INSTANCE_KIND;
 	map->value.instance.garbage = C_NULL;
@@ -224,12 +223,12 @@ txSlot* fxNewMapInstance(txMachine* the)
 	table = map->next = fxNewSlot(the);
 	list = table->next = fxNewSlot(the);
 	size = list->next = fxNewSlot(the);
-	address = (txSlot**)fxNewChunk(the, mxTableMinLength * sizeof(txSlot*));
-	c_memset(address, 0, mxTableMinLength * sizeof(txSlot*));
+	entries = (txHashEntry*)fxNewChunk(the, mxTableSize(mxTableMinLength));
+	c_memset(entries, 0, mxTableSize(mxTableMinLength));
 	/* TABLE */
 	table->flag = XS_INTERNAL_FLAG | XS_DONT_DELETE_FLAG | XS_DONT_ENUM_FLAG | XS_DONT_SET_FLAG;
 	table->kind = XS_MAP_KIND;
-	table->value.table.address = address;
+	table->value.table.address = (txSlot**)entries;
 	table->value.table.length = mxTableMinLength;
 	/* LIST */
 	list->flag = XS_INTERNAL_FLAG | XS_DONT_DELETE_FLAG | XS_DONT_ENUM_FLAG | XS_DONT_SET_FLAG;
@@ -314,12 +313,17 @@ void fx_Map_prototype_entries(txMachine* the)
 void fx_Map_prototype_forEach(txMachine* the)
 {
 	txSlot* instance = fxCheckMapInstance(the, mxThis, XS_IMMUTABLE);
-	txSlot* table = instance->next;
-	txSlot* list = table->next;
+	txSlot* list = instance->next->next;
 	txSlot* function = fxArgToCallback(the, 0);
 	txSlot* key = list->value.list.first;
+	txSlot* cursor;
+	/* the entry on the stack is not purged, even if the callback deletes it */
+	mxPushClosure(key);
+	cursor = the->stack;
 	while (key) {
 		txSlot* value = key->next;
+		cursor->value.closure = key;
+		key->flag |= XS_VISITED_FLAG;
 		if (!(key->flag & XS_DONT_ENUM_FLAG)) {
 			/* THIS */
 			if (mxArgc > 1)
@@ -338,6 +342,7 @@ void fx_Map_prototype_forEach(txMachine* the)
 		}
 		key = value->next;
 	}
+	mxPop();
 }
 
 void fx_Map_prototype_get(txMachine* the)
@@ -419,11 +424,12 @@ void fx_MapIterator_prototype_next(txMachine* the)
 	if (result->next->value.boolean == 0) {
 		txSlot* index = iterable->next;
 		txInteger kind = index->next->value.integer;
+		txSlot* table = iterable->value.reference->next;
 		txSlot* key = index->value.closure;
 		if (key)
 			key = key->next->next;
 		else
-			key = iterable->value.reference->next->next->value.list.first;
+			key = table->next->value.list.first;
 		while (key && (key->flag & XS_DONT_ENUM_FLAG))
 			key = key->next->next;
 		if (key) {
@@ -442,6 +448,7 @@ void fx_MapIterator_prototype_next(txMachine* the)
 				result->value = key->value;
 			}
 			index->value.closure = key;
+			key->flag |= XS_VISITED_FLAG;
 		}
 		else {
 			result->kind = XS_UNDEFINED_KIND;
@@ -481,7 +488,7 @@ txSlot* fxNewSetInstance(txMachine* the)
 	txSlot* table;
 	txSlot* list;
 	txSlot* size;
-	txSlot** address;
+	txHashEntry* entries;
 	set = fxNewSlot(the);
 	set->kind = XS_INSTANCE_KIND;
 	set->value.instance.garbage = C_NULL;
@@ -491,12 +498,12 @@ txSlot* fxNewSetInstance(txMachine* the)
 	table = set->next = fxNewSlot(the);
 	list = table->next = fxNewSlot(the);
 	size = list->next = fxNewSlot(the);
-	address = (txSlot**)fxNewChunk(the, mxTableMinLength * sizeof(txSlot*));
-	c_memset(address, 0, mxTableMinLength * sizeof(txSlot*));
+	entries = (txHashEntry*)fxNewChunk(the, mxTableSize(mxTableMinLength));
+	c_memset(entries, 0, mxTableSize(mxTableMinLength));
 	/* TABLE */
 	table->flag = XS_INTERNAL_FLAG | XS_DONT_DELETE_FLAG | XS_DONT_ENUM_FLAG | XS_DONT_SET_FLAG;
 	table->kind = XS_SET_KIND;
-	table->value.table.address = address;
+	table->value.table.address = (txSlot**)entries;
 	table->value.table.length = mxTableMinLength;
 	/* LIST */
 	list->flag = XS_INTERNAL_FLAG | XS_DONT_DELETE_FLAG | XS_DONT_ENUM_FLAG | XS_DONT_SET_FLAG;
@@ -586,11 +593,16 @@ void fx_Set_prototype_entries(txMachine* the)
 void fx_Set_prototype_forEach(txMachine* the)
 {
 	txSlot* instance = fxCheckSetInstance(the, mxThis, XS_IMMUTABLE);
-	txSlot* table = instance->next;
-	txSlot* list = table->next;
+	txSlot* list = instance->next->next;
 	txSlot* function = fxArgToCallback(the, 0);
 	txSlot* value = list->value.list.first;
+	txSlot* cursor;
+	/* the entry on the stack is not purged, even if the callback deletes it */
+	mxPushClosure(value);
+	cursor = the->stack;
 	while (value) {
+		cursor->value.closure = value;
+		value->flag |= XS_VISITED_FLAG;
 		if (!(value->flag & XS_DONT_ENUM_FLAG)) {
 			/* THIS */
 			if (mxArgc > 1)
@@ -609,6 +621,7 @@ void fx_Set_prototype_forEach(txMachine* the)
 		}
 		value = value->next;
 	}
+	mxPop();
 }
 
 void fx_Set_prototype_has(txMachine* the)
@@ -661,11 +674,12 @@ void fx_SetIterator_prototype_next(txMachine* the)
 	if (result->next->value.boolean == 0) {
 		txSlot* index = iterable->next;
 		txInteger kind = index->next->value.integer;
+		txSlot* table = iterable->value.reference->next;
 		txSlot* value = index->value.closure;
 		if (value)
 			value = value->next;
 		else
-			value = iterable->value.reference->next->next->value.list.first;
+			value = table->next->value.list.first;
 		while (value && (value->flag & XS_DONT_ENUM_FLAG))
 			value = value->next;
 		if (value) {
@@ -679,6 +693,7 @@ void fx_SetIterator_prototype_next(txMachine* the)
 				result->value = value->value;
 			}
 			index->value.closure = value;
+			value->flag |= XS_VISITED_FLAG;
 		}
 		else {
 			result->kind = XS_UNDEFINED_KIND;
@@ -692,80 +707,131 @@ void fxClearEntries(txMachine* the, txSlot* table, txSlot* list, txBoolean paire
 {
 	txSlot* slot = list->value.list.first;
 	while (slot) {
-		slot->flag = XS_DONT_ENUM_FLAG;
+		txSlot* last = (paired) ? slot->next : slot;
+		if (!(slot->flag & (XS_DONT_ENUM_FLAG | XS_VISITED_FLAG)))
+			mxTableDeleted(table)++;
+		slot->flag |= XS_DONT_ENUM_FLAG;
 		slot->kind = XS_UNDEFINED_KIND;
-		slot = slot->next;
+		last->flag |= XS_DONT_ENUM_FLAG;
+		last->kind = XS_UNDEFINED_KIND;
+		slot = last->next;
 	}
+	c_memset(mxTableEntries(table), 0, table->value.table.length * sizeof(txHashEntry));
 	list->next->value.integer = 0;
+	if (mxTableDeleted(table))
+		fxPurgeEntries(the, table, XS_VISITED_FLAG);
 	fxResizeEntries(the, table, list);
 }
 
-txBoolean fxDeleteEntry(txMachine* the, txSlot* table, txSlot* list, txSlot* key, txBoolean paired) 
+txBoolean fxDeleteEntry(txMachine* the, txSlot* table, txSlot* list, txSlot* key, txBoolean paired)
 {
 	txU4 sum = fxSumEntry(the, key);
-	txU4 index = sum & (table->value.table.length - 1);
-	txSlot** address = &(table->value.table.address[index]);
-	txSlot* entry;
+	txU4 mask = table->value.table.length - 1;
+	txU4 index = sum & mask;
+	txHashEntry* entries = mxTableEntries(table);
 	txSlot* first;
 	txSlot* last;
-	while ((entry = *address)) {
-		if (entry->value.entry.sum == sum) {
-			first = entry->value.entry.slot;
-			if (fxTestEntry(the, first, key)) {
-				*address = entry->next;
-				entry->next = C_NULL;
-				first->flag = XS_DONT_ENUM_FLAG;
-				first->kind = XS_UNDEFINED_KIND;
-				if (paired) {
-					last = first->next;
-					last->flag = XS_DONT_ENUM_FLAG;
-					last->kind = XS_UNDEFINED_KIND;
+	while ((first = entries[index].slot)) {
+		if ((entries[index].sum == sum) && fxTestEntry(the, first, key)) {
+			txU4 next = (index + 1) & mask;
+			/* move back the entries that probed past the removed one */
+			while (entries[next].slot) {
+				if (((next - entries[next].sum) & mask) >= ((next - index) & mask)) {
+					entries[index] = entries[next];
+					index = next;
 				}
-				list->next->value.integer--;
-				fxResizeEntries(the, table, list);
-				return 1;
+				next = (next + 1) & mask;
+			}
+			entries[index].slot = C_NULL;
+			entries[index].sum = 0;
+			if (!(first->flag & XS_VISITED_FLAG))
+				mxTableDeleted(table)++;
+			first->flag |= XS_DONT_ENUM_FLAG;
+			first->kind = XS_UNDEFINED_KIND;
+			if (paired) {
+				last = first->next;
+				last->flag |= XS_DONT_ENUM_FLAG;
+				last->kind = XS_UNDEFINED_KIND;
 			}
+			list->next->value.integer--;
+			/* iterators and forEach can be on the visited entries, so only the collector unlinks them */
+			if (mxTableDeleted(table) > (txU4)(list->next->value.integer >> 1))
+				fxPurgeEntries(the, table, XS_VISITED_FLAG);
+			fxResizeEntries(the, table, list);
+			return 1;
 		}
-		address = &entry->next;
+		index = (index + 1) & mask;
 	}
 	return 0;
 }
 
-txSlot* fxGetEntry(txMachine* the, txSlot* table, txSlot* slot) 
+txSlot* fxGetEntry(txMachine* the, txSlot* table, txSlot* slot)
 {
 	txU4 sum = fxSumEntry(the, slot);
-	txU4 index = sum & (table->value.table.length - 1);
-	txSlot* entry = table->value.table.address[index];
+	txU4 mask = table->value.table.length - 1;
+	txU4 index = sum & mask;
+	txHashEntry* entries = mxTableEntries(table);
 	txSlot* result;
-	while (entry) {
-		if (entry->value.entry.sum == sum) {
-			result = entry->value.entry.slot;
-			if (fxTestEntry(the, result, slot))
-				return result;
-		}
-		entry = entry->next;
+	while ((result = entries[index].slot)) {
+		if ((entries[index].sum == sum) && fxTestEntry(the, result, slot))
+			return result;
+		index = (index + 1) & mask;
 	}
 	return C_NULL;
 }
 
-// void fxPurgeEntries(txMachine* the, txSlot* list) 
-// {
-// 	txSlot* former = C_NULL;
-// 	txSlot** address = &(list->value.list.first);
-// 	txSlot* slot;
-// 	while ((slot = *address)) {
-// 		if (slot->flag & XS_DONT_ENUM_FLAG) {
-// 			*address = slot->next;
-// 		}
-// 		else {
-// 			former = slot;
-// 			address = &slot->next;
-// 		}
-// 	}
-// 	list->value.list.last = former;
-// }
-
-void fxResizeEntries(txMachine* the, txSlot* table, txSlot* list) 
+void fxIndexEntry(txMachine* the, txSlot* table, txSlot* key, txU4 sum)
+{
+	txU4 mask = table->value.table.length - 1;
+	txU4 index = sum & mask;
+	txHashEntry* entries = mxTableEntries(table);
+	while (entries[index].slot)
+		index = (index + 1) & mask;
+	entries[index].slot = key;
+	entries[index].sum = sum;
+}
+
+void fxPurgeEntries(txMachine* the, txSlot* table, txFlag flag)
+{
+	txSlot* list = table->next;
+	txBoolean paired = (table->kind == XS_MAP_KIND) ? 1 : 0;
+	txSlot* former = C_NULL;
+	txSlot** address = &(list->value.list.first);
+	txSlot* slot;
+	txU4 deleted = 0;
+	while ((slot = *address)) {
+		txSlot* last = (paired) ? slot->next : slot;
+		if (slot->flag & XS_DONT_ENUM_FLAG) {
+			if (!(slot->flag & flag)) {
+				*address = last->next;
+				continue;
+			}
+			/* the collector marks the deleted entries that iterators and forEach are on, so they can continue from them */
+			last->flag |= slot->flag & XS_MARK_FLAG;
+			if (!(slot->flag & XS_VISITED_FLAG))
+				deleted++;
+		}
+		former = last;
+		address = &last->next;
+	}
+	list->value.list.last = former;
+	mxTableDeleted(table) = deleted;
+}
+
+void fxRehashEntries(txMachine* the, txSlot* table, txSlot* list)
+{
+	txBoolean paired = (table->kind == XS_MAP_KIND) ? 1 : 0;
+	txSlot* slot;
+	c_memset(mxTableEntries(table), 0, mxTableSize(table->value.table.length));
+	fxPurgeEntries(the, table, XS_NO_FLAG);
+	slot = list->value.list.first;
+	while (slot) {
+		fxIndexEntry(the, table, slot, fxSumEntry(the, slot));
+		slot = (paired) ? slot->next->next : slot->next;
+	}
+}
+
+void fxResizeEntries(txMachine* the, txSlot* table, txSlot* list)
 {
 	txSize size = list->next->value.integer;
 	txSize formerLength = table->value.table.length;
@@ -783,70 +849,47 @@ void fxResizeEntries(txMachine* the, txSlot* table, txSlot* list)
 			currentLength = mxTableMinLength;
 	}
 	if (formerLength != currentLength) {
-		txSlot** currentAddress = (txSlot**)fxNewChunk(the, currentLength * sizeof(txSlot*));
-		if (currentAddress) {
-			txSlot** formerAddress = table->value.table.address;
-
-            txSize currentMask = currentLength - 1;
-			c_memset(currentAddress, 0, currentLength * sizeof(txSlot*));
-			while (formerLength) {
-				txSlot* entry;
-				while ((entry = *formerAddress)) {
-					txU4 index = entry->value.entry.sum & currentMask;
-					 *formerAddress = entry->next;
-					entry->next = currentAddress[index];
-					currentAddress[index] = entry;
-				}
-				formerLength--;
-				formerAddress++;
+		txHashEntry* currentEntries = (txHashEntry*)fxNewChunk(the, mxTableSize(currentLength));
+		txHashEntry* formerEntries = mxTableEntries(table);
+		txU4 currentMask = currentLength - 1;
+		c_memset(currentEntries, 0, currentLength * sizeof(txHashEntry));
+		currentEntries[currentLength] = formerEntries[formerLength];
+		while (formerLength) {
+			if (formerEntries->slot) {
+				txU4 index = formerEntries->sum & currentMask;
+				while (currentEntries[index].slot)
+					index = (index + 1) & currentMask;
+				currentEntries[index] = *formerEntries;
 			}
-			table->value.table.address = currentAddress;
-			table->value.table.length = currentLength;
+			formerLength--;
+			formerEntries++;
 		}
+		table->value.table.address = (txSlot**)currentEntries;
+		table->value.table.length = currentLength;
 	}
-// 	{
-// 		txSize holes = 0;
-// 		txSize collisions = 0;
-// 		txSize i = 	0;
-// 		while (i < table->value.table.length) {
-// 			txSize j = 0;
-// 			txSlot* entry = table->value.table.address[i];
-// 			while (entry) {
-// 				j++;
-// 				entry = entry->next;
-// 			}
-// 			if (j == 0)
-// 				holes++;
-// 			else if (collisions < j)
-// 				collisions = j;
-// 			i++;
-// 		}
-// 		fprintf(stderr, "# size %d capacity %d holes %d collisions <%d\n", size, table->value.table.length, holes, collisions);
-// 	}
-}
-
-void fxSetEntry(txMachine* the, txSlot* table, txSlot* list, txSlot* key, txSlot* pair) 
+}
+
+void fxSetEntry(txMachine* the, txSlot* table, txSlot* list, txSlot* key, txSlot* pair)
 {
 	txU4 sum = fxSumEntry(the, key);
-	txU4 index = sum & (table->value.table.length - 1);
-	txSlot** address = &(table->value.table.address[index]);
-	txSlot* entry = *address;
+	txU4 mask = table->value.table.length - 1;
+	txU4 index = sum & mask;
+	txHashEntry* entries = mxTableEntries(table);
 	txSlot* first;
 	txSlot* last;
-	while (entry) {
-		if (entry->value.entry.sum == sum) {
-			first = entry->value.entry.slot;
-			if (fxTestEntry(the, first, key)) {
-				if (pair) {
-					last = first->next;
-					last->kind = pair->kind;
-					last->value = pair->value;
-				}
-				return;
+	while ((first = entries[index].slot)) {
+		if ((entries[index].sum == sum) && fxTestEntry(the, first, key)) {
+			if (pair) {
+				last = first->next;
+				last->kind = pair->kind;
+				last->value = pair->value;
 			}
+			return;
 		}
-		entry = entry->next;
+		index = (index + 1) & mask;
 	}
+	if (list->next->value.integer >= mxTableThreshold(mxTableMaxLength))
+		mxRangeError("too many entries");
 	first = fxNewSlot(the);
 	first->kind = key->kind;
 	first->value = key->value;
@@ -857,12 +900,10 @@ void fxSetEntry(txMachine* the, txSlot* table, txSlot* list, txSlot* key, txSlot
 		last->value = pair->value;
 		mxPushClosure(last);
 	}
-	entry = fxNewSlot(the);
-	entry->next = *address;
-	entry->kind = XS_ENTRY_KIND;
-	entry->value.entry.slot = first;
-	entry->value.entry.sum = sum;
-	*address = entry;
+	/* allocating slots can move the table chunk, not its entries */
+	entries = mxTableEntries(table);
+	entries[index].slot = first;
+	entries[index].sum = sum;
 	if (list->value.list.last)
 		list->value.list.last->next = first;
 	else
@@ -886,10 +927,22 @@ txU4 fxSumEntry(txMachine* the, txSlot* slot)
 	if ((XS_STRING_KIND == kind) || (XS_STRING_X_KIND == kind)) {
 		// Dan Bernstein: http://www.cse.yorku.ca/~oz/hash.html
 		txU1 *string = (txU1*)slot->value.string;
+	#if mxStringCache
+		txStringCacheEntry* entry = fxFindStringCacheEntry(the, slot);
+		if (entry && (entry->flag & XS_STRING_SUM_FLAG))
+			return entry->sum;
+	#endif
 		sum = 5381;
 		while ((kind = c_read8(string++))) {
 			sum = ((sum << 5) + sum) + kind;
 		}
+	#if mxStringCache
+		if (entry) {
+			entry->size = (txSize)(string - (txU1*)slot->value.string) - 1;
+			entry->sum = (txU4)(sum & 0xFFFFFFFF);
+			entry->flag |= XS_STRING_SIZE_FLAG | XS_STRING_SUM_FLAG;
+		}
+	#endif
 	}
 	else {
 		if (XS_REFERENCE_KIND == kind) {
@@ -897,12 +950,12 @@ txU4 fxSumEntry(txMachine* the, txSlot* slot)
 		}
 		else if (XS_INTEGER_KIND == kind) {
 			fxToNumber(the, slot);
-			sum = *((txU8*)&slot->value.number);
+			c_memcpy(&sum, &slot->value.number, sizeof(txU8));
 		}
 		else if (XS_NUMBER_KIND == kind) {
 			if (slot->value.number == 0)
 				slot->value.number = 0;
-			sum = *((txU8*)&slot->value.number);
+			c_memcpy(&sum, &slot->value.number, sizeof(txU8));
 		}
 		else if ((XS_BIGINT_KIND == kind) || (XS_BIGINT_X_KIND == kind)) {
 			sum = fxToBigUint64(the, slot);
@@ -110,9 +110,6 @@ void fxDemarshall(txMachine* the, void* theData, txBoolean alien)
 					id = fxNewNameC(the, (char *)p);
 				else {
 					aSymbolLength = aSymbolLength & mxSymbolMask;
-					id = the->keyIndex;
-					if (id == the->keyCount)
-						fxAbort(the, XS_NO_MORE_KEYS_EXIT);
 					if (aSymbolLength > 1) {
 						aSlot = fxNewSlot(the);
 						aSlot->kind = XS_STRING_KIND;
@@ -121,8 +118,7 @@ void fxDemarshall(txMachine* the, void* theData, txBoolean alien)
 					}
 					else
 						aSlot = C_NULL;
-					the->keyArray[id - the->keyOffset] = aSlot;
-					the->keyIndex++;
+					id = fxNewKey(the, aSlot);
 				}
 				*aSymbolPointer++ = id;
 				aSymbolCount--;
@@ -281,9 +277,8 @@ void fxDemarshallSlot(txMachine* the, txSlot* theSlot, txSlot* theResult, txID*
 	case XS_MAP_KIND:
 	case XS_SET_KIND:
         theResult->value.table.length = theSlot->value.table.length;
-		aSlotAddress = (txSlot**)fxNewChunk(the, theResult->value.table.length * sizeof(txSlot*));
-		c_memset(aSlotAddress, 0, theResult->value.table.length * sizeof(txSlot*));
-		theResult->value.table.address = aSlotAddress;
+		theResult->value.table.address = (txSlot**)fxNewChunk(the, mxTableSize(theResult->value.table.length));
+		c_memset(theResult->value.table.address, 0, mxTableSize(theResult->value.table.length));
 		theResult->kind = theSlot->kind;
 		break;	
 	case XS_TYPED_ARRAY_KIND:
@@ -343,39 +338,8 @@ void fxDemarshallSlot(txMachine* the, txSlot* theSlot, txSlot* theResult, txID*
 			aSlotAddress = &((*aSlotAddress)->next);
 		}
 		aSlot = theResult->next;
-		if (aSlot) {
-			if (aSlot->kind == XS_MAP_KIND) {
-				txSlot* key = aSlot->next->value.list.first;
-				while (key) {
-					txSlot* value = key->next;
-					txU4 sum = fxSumEntry(the, key);
-					txU4 modulo = sum % aSlot->value.table.length;
-					txSlot** address = &(aSlot->value.table.address[modulo]);
-					txSlot* entry = fxNewSlot(the);
-					entry->next = *address;
-					entry->kind = XS_ENTRY_KIND;
-					entry->value.entry.slot = key;
-					entry->value.entry.sum = sum;
-					*address = entry;
-					key = value->next;
-				}
-			}
-			else if (aSlot->kind == XS_SET_KIND) {
-				txSlot* key = aSlot->next->value.list.first;
-				while (key) {
-					txU4 sum = fxSumEntry(the, key);
-					txU4 modulo = sum % aSlot->value.table.length;
-					txSlot** address = &(aSlot->value.table.address[modulo]);
-					txSlot* entry = fxNewSlot(the);
-					entry->next = *address;
-					entry->kind = XS_ENTRY_KIND;
-					entry->value.entry.slot = key;
-					entry->value.entry.sum = sum;
-					*address = entry;
-					key = key->next;
-				}
-			}
-		}
+		if (aSlot && ((aSlot->kind == XS_MAP_KIND) || (aSlot->kind == XS_SET_KIND)))
+			fxRehashEntries(the, aSlot, aSlot->next);
 		break;	
 	case XS_ARRAY_KIND:
 		theResult->value.array.length = 0;
@@ -49,6 +49,13 @@
 #ifndef mxNoChunks
 #define mxNoChunks 0
 #endif
+#ifndef mxParallelSweep
+#define mxParallelSweep 0
+#endif
+#if mxParallelSweep && !defined(mxUsePOSIXThreads)
+#undef mxParallelSweep
+#define mxParallelSweep 0
+#endif
 
 #if mxStress
 int gxStress = 0;
@@ -63,13 +70,94 @@ static void* fxGrowChunk(txMachine* the, txSize size);
 static void* fxGrowChunks(txMachine* the, txSize theSize); 
 static void fxGrowSlots(txMachine* the, txSize theCount); 
 static void fxMark(txMachine* the, void (*theMarker)(txMachine*, txSlot*));
+static void fxMarkEntries(txMachine* the, txSlot* table, void (*theMarker)(txMachine*, txSlot*));
 static void fxMarkFinalizationRegistry(txMachine* the, txSlot* registry);
 static void fxMarkInstance(txMachine* the, txSlot* theCurrent, void (*theMarker)(txMachine*, txSlot*));
+#if mxCollectKeys
+static void fxMarkKey(txMachine* the, txID theID, void (*theMarker)(txMachine*, txSlot*));
+static void fxMarkKeys(txMachine* the, void (*theMarker)(txMachine*, txSlot*));
+static void fxMarkSlotKeys(txMachine* the, txSlot* theSlot, void (*theMarker)(txMachine*, txSlot*));
+#endif
 static void fxMarkReference(txMachine* the, txSlot* theSlot);
 static void fxMarkValue(txMachine* the, txSlot* theSlot);
 static void fxMarkWeakStuff(txMachine* the);
+static void fxReleaseSlot(txMachine* the, txSlot* theSlot);
 static void fxSweep(txMachine* the);
 static void fxSweepValue(txMachine* the, txSlot* theSlot);
+#if mxParallelSweep
+/* the number of slots swept by a task, and the size of the heap below which slots are swept serially */
+#define mxSweepStride 65536
+
+typedef struct sxSweepTask txSweepTask;
+typedef struct sxSweepThread txSweepThread;
+
+struct sxSweepTask {
+	txSlot* from;
+	txSlot* to;
+	txSize count;
+	txSlot* firstFree;
+	txSlot* lastFree;
+	txSlot* firstRelease;
+#ifdef mxDebug
+	txBoolean broken;
+#endif
+};
+
+struct sxSweepThread {
+	txMachine* the;
+	txSweepTask* tasks;
+	txSize taskCount;
+	txSize index;
+	pthread_t thread;
+	txBoolean running;
+};
+
+static void fxSweepSlotTask(txMachine* the, txSweepTask* task);
+static void* fxSweepSlotThread(void* it);
+static txBoolean fxSweepSlotsInParallel(txMachine* the);
+#endif
+#if mxParallelMark
+/* the size of the heap below which slots are marked serially, and the number of instances that a thread keeps for itself when it shares its mark stack */
+#define mxMarkThreshold 131072
+#define mxMarkShare 32
+
+typedef struct sxMarkState txMarkState;
+
+struct sxMarkThread {
+	txMarkState* state;
+	txInteger index;
+	txSlot* first;
+	txSize count;
+	pthread_mutex_t mutex;
+	txSlot* firstShared;
+	txSize sharedCount;
+	txSlot* firstHost;
+	txSlot* firstTableLink;
+	txSlot* firstWeakRefLink;
+	pthread_t thread;
+	txBoolean running;
+};
+
+struct sxMarkState {
+	txMachine* the;
+	txBoolean chunks;
+	txInteger threadCount;
+	txInteger idleCount;
+	txMarkThread threads[mxParallelMark];
+};
+
+static txBoolean fxClaimSlot(txSlot* slot);
+static void fxMarkEntriesInParallel(txMarkThread* thread, txSlot* table);
+static void fxMarkInstanceInParallel(txMarkThread* thread, txSlot* instance);
+static txBoolean fxMarkInParallel(txMachine* the, txBoolean chunks);
+static void fxMarkRoundInParallel(txMarkState* state);
+static void fxMarkRoot(txMachine* the, txSlot* slot);
+static void* fxMarkThread(void* it);
+static void fxMarkValueInParallel(txMarkThread* thread, txSlot* slot);
+static txSlot* fxPopMark(txMarkThread* thread);
+static void fxPushMark(txMarkThread* thread, txSlot* instance);
+static txBoolean fxStealMark(txMarkThread* thread);
+#endif
 
 #ifdef mxNever
 
@@ -200,6 +288,38 @@ void fxAllocate(txMachine* the, txCreation* theCreation)
 	the->cRoot = C_NULL;
 	the->parserBufferSize = theCreation->parserBufferSize;
 	the->parserTableModulo = theCreation->parserTableModulo;
+
+#if mxPropertyCache
+	the->propertyCache = (txPropertyCacheEntry*)c_calloc(mxPropertyCacheCount, sizeof(txPropertyCacheEntry));
+	if (!the->propertyCache)
+		fxAbort(the, XS_NOT_ENOUGH_MEMORY_EXIT);
+	the->propertyCacheEpoch = 1;
+	the->propertyCacheHits = 0;
+	the->propertyCacheMisses = 0;
+	c_memset(the->propertyCacheShadows, 0, sizeof(the->propertyCacheShadows));
+#endif
+#if mxStringCache
+	the->stringCache = (txStringCacheEntry*)c_calloc(mxStringCacheCount, sizeof(txStringCacheEntry));
+	if (!the->stringCache)
+		fxAbort(the, XS_NOT_ENOUGH_MEMORY_EXIT);
+#endif
+#if mxRegExpCache
+	the->regExpCacheHits = 0;
+	the->regExpCacheMisses = 0;
+#endif
+#if mxPropertyCacheKeys
+	the->propertyCacheKeyCount = 256;
+	the->propertyCacheKeyArray = (txPropertyCacheKey*)c_malloc(the->propertyCacheKeyCount * sizeof(txPropertyCacheKey));
+	if (!the->propertyCacheKeyArray)
+		fxAbort(the, XS_NOT_ENOUGH_MEMORY_EXIT);
+	the->propertyCacheKeyIndex = 1;
+	c_memset(the->propertyCacheKeyRoots, 0, sizeof(the->propertyCacheKeyRoots));
+#endif
+#if mxDictionaries
+	the->dictionaryArray = C_NULL;
+	the->dictionaryCount = 0;
+	the->dictionaryFree = 1;
+#endif
 }
 
 void* fxCheckChunk(txMachine* the, txChunk* chunk, txSize size)
@@ -247,8 +367,14 @@ void fxCollect(txMachine* the, txBoolean theFlag)
 		txSize total = 0;
 		txChunk** address;
 		txChunk* chunk;
-		fxMark(the, fxMarkValue);
+	#if mxParallelMark
+		if (!fxMarkInParallel(the, 1))
+	#endif
+			fxMark(the, fxMarkValue);
 		fxMarkWeakStuff(the);
+	#if mxCollectKeys
+		fxMarkKeys(the, fxMarkValue);
+	#endif
 		address = (txChunk**)&(the->firstBlock);
 		while ((chunk = *address)) {
 			txSize size = chunk->size;
@@ -266,64 +392,72 @@ void fxCollect(txMachine* the, txBoolean theFlag)
 		the->currentChunksSize = total;
 	}
 	else {
-		fxMark(the, fxMarkReference);
+	#if mxParallelMark
+		if (!fxMarkInParallel(the, 0))
+	#endif
+			fxMark(the, fxMarkReference);
 		fxMarkWeakStuff(the);
+	#if mxCollectKeys
+		fxMarkKeys(the, fxMarkReference);
+	#endif
 	}
 	{		
 #else
 	if (theFlag) {
-		fxMark(the, fxMarkValue);
+	#if mxParallelMark
+		if (!fxMarkInParallel(the, 1))
+	#endif
+			fxMark(the, fxMarkValue);
 		fxMarkWeakStuff(the);
+	#if mxCollectKeys
+		fxMarkKeys(the, fxMarkValue);
+	#endif
 		fxSweep(the);
 	}
 	else {
-		fxMark(the, fxMarkReference);
+	#if mxParallelMark
+		if (!fxMarkInParallel(the, 0))
+	#endif
+			fxMark(the, fxMarkReference);
 		fxMarkWeakStuff(the);
+	#if mxCollectKeys
+		fxMarkKeys(the, fxMarkReference);
+	#endif
 #endif
 	#ifdef mxNever
 		startTime(&gxSweepSlotTime);
 	#endif
-		aCount = 0;
-		freeSlot = C_NULL;
-		aSlot = the->firstHeap;
-		while (aSlot) {
-			bSlot = aSlot + 1;
-			cSlot = aSlot->value.reference;
-			while (bSlot < cSlot) {
-				if (bSlot->flag & XS_MARK_FLAG) {
-					bSlot->flag &= ~XS_MARK_FLAG; 
+	#if mxParallelSweep
+		if (!fxSweepSlotsInParallel(the))
+	#endif
+		{
+			aCount = 0;
+			freeSlot = C_NULL;
+			aSlot = the->firstHeap;
+			while (aSlot) {
+				bSlot = aSlot + 1;
+				cSlot = aSlot->value.reference;
+				while (bSlot < cSlot) {
+					if (bSlot->flag & XS_MARK_FLAG) {
+						bSlot->flag &= ~XS_MARK_FLAG; 
 					
-					if (bSlot->kind == XS_REFERENCE_KIND)
-						mxCheck(the, bSlot->value.reference->kind == XS_INSTANCE_KIND);
+						if (bSlot->kind == XS_REFERENCE_KIND)
+							mxCheck(the, bSlot->value.reference->kind == XS_INSTANCE_KIND);
 					
-					aCount++;
-				}
-				else {
-					if (bSlot->kind == XS_HOST_KIND) {
-						if (bSlot->flag & XS_HOST_HOOKS_FLAG) {
-							if (bSlot->value.host.variant.hooks->destructor)
-								(*(bSlot->value.host.variant.hooks->destructor))(bSlot->value.host.data);
-						}
-						else if (bSlot->value.host.variant.destructor)
-							(*(bSlot->value.host.variant.destructor))(bSlot->value.host.data);
+						aCount++;
+					}
+					else {
+						fxReleaseSlot(the, bSlot);
+						bSlot->next = freeSlot;
+						freeSlot = bSlot;
 					}
-				#if mxInstrument
-					if (bSlot->kind == XS_MODULE_KIND)
-						the->loadedModulesCount--;
-				#endif
-				#if mxFill
-					c_memset(bSlot, 0xFF, sizeof(txSlot));
-				#endif
-					bSlot->kind = XS_UNDEFINED_KIND;
-					bSlot->next = freeSlot;
-					freeSlot = bSlot;
+					bSlot++;
 				}
-				bSlot++;
+				aSlot = aSlot->next;
 			}
-			aSlot = aSlot->next;
+			the->currentHeapCount = aCount;
+			the->freeHeap = freeSlot;
 		}
-		the->currentHeapCount = aCount;
-		the->freeHeap = freeSlot;
 	#ifdef mxNever
 		stopTime(&gxSweepSlotTime);
 	#endif
@@ -342,6 +476,16 @@ void fxCollect(txMachine* the, txBoolean theFlag)
 				the->collectFlag &= ~XS_TRASHING_FLAG;
 	}
 	
+#if mxPropertyCacheKeys
+	if (the->propertyCacheKeyIndex == mxPropertyCacheKeyCount)
+		fxEmptyPropertyCacheKeys(the);
+#endif
+#if mxPropertyCache
+	fxInvalidatePropertyCache(the);
+#endif
+#if mxStringCache
+	fxInvalidateStringCache(the);
+#endif
 #if mxReport
 	if (theFlag)
 		fxReport(the, "# Chunk collection: reserved %ld used %ld peak %ld bytes\n", 
@@ -351,6 +495,17 @@ void fxCollect(txMachine* the, txBoolean theFlag)
 		(long)(the->currentHeapCount * sizeof(txSlot)),
 		(long)(the->peakHeapCount * sizeof(txSlot)),
 		the->collectFlag & XS_TRASHING_FLAG);
+#if mxPropertyCache
+	fxReport(the, "# Property cache: hits %lu misses %lu\n",
+		(unsigned long)the->propertyCacheHits, (unsigned long)the->propertyCacheMisses);
+#endif
+#if mxRegExpCache
+	fxReport(the, "# RegExp cache: hits %lu misses %lu\n",
+		(unsigned long)the->regExpCacheHits, (unsigned long)the->regExpCacheMisses);
+#endif
+#if mxPropertyCacheKeys
+	fxReport(the, "# Property cache keys: used %ld reserved %ld\n", (long)the->propertyCacheKeyIndex, (long)the->propertyCacheKeyCount);
+#endif
 #endif
 #ifdef mxInstrument
 	the->garbageCollectionCount++;
@@ -415,6 +570,33 @@ void fxFree(txMachine* the)
 	txSlot* aHeap;
 	txBlock* aBlock;
 
+#if mxPropertyCache
+	if (the->propertyCache)
+		c_free(the->propertyCache);
+	the->propertyCache = C_NULL;
+#endif
+#if mxStringCache
+	if (the->stringCache)
+		c_free(the->stringCache);
+	the->stringCache = C_NULL;
+#endif
+#if mxPropertyCacheKeys
+	if (the->propertyCacheKeyArray)
+		c_free(the->propertyCacheKeyArray);
+	the->propertyCacheKeyArray = C_NULL;
+#endif
+#if mxDictionaries
+	if (the->dictionaryArray) {
+		txInteger index;
+		for (index = 1; index < the->dictionaryCount; index++) {
+			if (the->dictionaryArray[index])
+				c_free(the->dictionaryArray[index]);
+		}
+		c_free(the->dictionaryArray);
+	}
+	the->dictionaryArray = C_NULL;
+	the->dictionaryCount = 0;
+#endif
 	if (the->aliasArray)
 		c_free_uint32(the->aliasArray);
 	the->aliasArray = C_NULL;
@@ -428,6 +610,9 @@ void fxFree(txMachine* the)
 	if (the->keyArray)
 		c_free_uint32(the->keyArray);
 	the->keyArray = C_NULL;
+	if (the->keyFreeArray)
+		c_free_uint32(the->keyFreeArray);
+	the->keyFreeArray = C_NULL;
 
 	if (the->stackBottom)
 		fxFreeSlots(the, the->stackBottom);
@@ -591,8 +776,21 @@ void fxMark(txMachine* the, void (*theMarker)(txMachine*, txSlot*))
 //#endif
 	while (anIndex) {
 		if ((aSlot = *anArray)) {
+		#if mxCollectKeys
+			if (aSlot->flag & XS_COLLECTABLE_FLAG) {
+				if (aSlot->flag & XS_RECENT_FLAG)
+					aSlot->flag &= ~XS_RECENT_FLAG;
+				else
+					aSlot = C_NULL;
+			}
+			if (aSlot) {
+				aSlot->flag |= XS_MARK_FLAG;
+				(*theMarker)(the, aSlot);
+			}
+		#else
 			aSlot->flag |= XS_MARK_FLAG;
 			(*theMarker)(the, aSlot);
+		#endif
 		}
 		anArray++;
 		anIndex--;
@@ -626,6 +824,30 @@ void fxMark(txMachine* the, void (*theMarker)(txMachine*, txSlot*))
 #endif
 }
 
+void fxMarkEntries(txMachine* the, txSlot* table, void (*theMarker)(txMachine*, txSlot*))
+{
+	txSlot* list = table->next;
+	txSlot* slot;
+	txBoolean deleted = 0;
+	if (!list || (list->kind != XS_LIST_KIND) || (list->flag & XS_MARK_FLAG))
+		return;
+	list->flag |= XS_MARK_FLAG;
+	slot = list->value.list.first;
+	while (slot) {
+		if (slot->flag & XS_DONT_ENUM_FLAG)
+			deleted = 1;
+		else if (!(slot->flag & XS_MARK_FLAG)) {
+			slot->flag |= XS_MARK_FLAG;
+			(*theMarker)(the, slot);
+		}
+		slot = slot->next;
+	}
+	if (deleted) {
+		mxTableLink(table) = the->firstTableLink;
+		the->firstTableLink = table;
+	}
+}
+
 void fxMarkFinalizationRegistry(txMachine* the, txSlot* registry) 
 {
 	txSlot* slot = registry->value.finalizationRegistry.callback->next;
@@ -700,6 +922,115 @@ void fxMarkInstance(txMachine* the, txSlot* theCurrent, void (*theMarker)(txMach
 	}
 }
 
+#if mxCollectKeys
+void fxMarkKey(txMachine* the, txID theID, void (*theMarker)(txMachine*, txSlot*))
+{
+	txSlot* key;
+	if ((the->keyOffset <= theID) && (theID < the->keyIndex)) {
+		key = the->keyArray[theID - the->keyOffset];
+		if (key && !(key->flag & XS_MARK_FLAG)) {
+			key->flag |= XS_MARK_FLAG;
+			(*theMarker)(the, key);
+		}
+	}
+}
+
+void fxMarkKeys(txMachine* the, void (*theMarker)(txMachine*, txSlot*))
+{
+	txSlot** keys = the->keyArray;
+	txID count = the->keyIndex - the->keyOffset;
+	txID index;
+	txSlot* key;
+	txSlot* heap;
+	txSlot* slot;
+	txSlot* limit;
+	txSlot** address;
+	
+	for (index = 0; index < count; index++) {
+		key = keys[index];
+		if (key && ((key->flag & (XS_COLLECTABLE_FLAG | XS_MARK_FLAG)) == XS_COLLECTABLE_FLAG))
+			break;
+	}
+	if (index == count)
+		return;
+	
+	/* collectable keys are kept alive by live properties, variables and property keys, whatever their kind */
+	heap = the->firstHeap;
+	while (heap) {
+		slot = heap + 1;
+		limit = heap->value.reference;
+		while (slot < limit) {
+			if (slot->flag & XS_MARK_FLAG)
+				fxMarkSlotKeys(the, slot, theMarker);
+			slot++;
+		}
+		heap = heap->next;
+	}
+	slot = the->stack;
+	while (slot < the->stackTop) {
+		fxMarkSlotKeys(the, slot, theMarker);
+		slot++;
+	}
+	
+	for (index = 0; index < count; index++) {
+		key = keys[index];
+		if (key && ((key->flag & (XS_COLLECTABLE_FLAG | XS_MARK_FLAG)) == XS_COLLECTABLE_FLAG)) {
+			address = &(the->nameTable[key->value.key.sum % the->nameModulo]);
+			while ((slot = *address)) {
+				if (slot == key) {
+					*address = key->next;
+					break;
+				}
+				address = &(slot->next);
+			}
+			keys[index] = C_NULL;
+			the->nameCount--;
+			if (the->keyFreeCount == the->keyFreeSize) {
+				txID size = the->keyFreeSize ? the->keyFreeSize << 1 : 64;
+				txID* array = (txID*)c_malloc_uint32(size * sizeof(txID));
+				if (!array)
+					continue;
+				if (the->keyFreeArray) {
+					c_memcpy(array, the->keyFreeArray, the->keyFreeCount * sizeof(txID));
+					c_free_uint32(the->keyFreeArray);
+				}
+				the->keyFreeArray = array;
+				the->keyFreeSize = size;
+			}
+			the->keyFreeArray[the->keyFreeCount] = the->keyOffset + index;
+			the->keyFreeCount++;
+		}
+	}
+}
+
+void fxMarkSlotKeys(txMachine* the, txSlot* theSlot, void (*theMarker)(txMachine*, txSlot*))
+{
+	txSlot* item;
+	txIndex length;
+	fxMarkKey(the, theSlot->ID, theMarker);
+	switch (theSlot->kind) {
+	case XS_AT_KIND:
+		fxMarkKey(the, theSlot->value.at.id, theMarker);
+		break;
+	case XS_ARGUMENTS_SLOPPY_KIND:
+	case XS_ARGUMENTS_STRICT_KIND:
+	case XS_ARRAY_KIND:
+	case XS_STACK_KIND:
+		if ((item = theSlot->value.array.address)) {
+			length = ((((txChunk*)(((txByte*)item) - sizeof(txChunk)))->size) & ~mxChunkFlag) / sizeof(txSlot);
+			while (length) {
+				fxMarkKey(the, item->ID, theMarker);
+				if (item->kind == XS_AT_KIND)
+					fxMarkKey(the, item->value.at.id, theMarker);
+				item++;
+				length--;
+			}
+		}
+		break;
+	}
+}
+#endif
+
 void fxMarkReference(txMachine* the, txSlot* theSlot)
 {
 	txSlot* aSlot;
@@ -801,6 +1132,10 @@ void fxMarkReference(txMachine* the, txSlot* theSlot)
 			aSlot = aSlot->next;
 		}
 		break;
+	case XS_MAP_KIND:
+	case XS_SET_KIND:
+		fxMarkEntries(the, theSlot, fxMarkReference);
+		break;
 		
 	case XS_PRIVATE_KIND:
 		aSlot = theSlot->value.private.check;
@@ -814,22 +1149,6 @@ void fxMarkReference(txMachine* the, txSlot* theSlot)
 		}
 		break;
 
-	case XS_MAP_KIND:
-	case XS_SET_KIND:
-		{
-			txSlot** anAddress = theSlot->value.table.address;
-			txInteger aLength = theSlot->value.table.length;
-			while (aLength) {
-				aSlot = *anAddress;
-				while (aSlot) {
-					aSlot->flag |= XS_MARK_FLAG; 
-					aSlot = aSlot->next;
-				}
-				anAddress++;
-				aLength--;
-			}
-		}
-		break;
 	case XS_WEAK_MAP_KIND:
 	case XS_WEAK_SET_KIND:
 		aSlot = theSlot->value.weakList.first;
@@ -1037,20 +1356,8 @@ void fxMarkValue(txMachine* the, txSlot* theSlot)
 
 	case XS_MAP_KIND:
 	case XS_SET_KIND:
-		{
-			txSlot** anAddress = theSlot->value.table.address;
-			txInteger aLength = theSlot->value.table.length;
-			while (aLength) {
-				aSlot = *anAddress;
-				while (aSlot) {
-					aSlot->flag |= XS_MARK_FLAG; 
-					aSlot = aSlot->next;
-				}
-				anAddress++;
-				aLength--;
-			}
-		}
 		mxMarkChunk(theSlot->value.table.address);
+		fxMarkEntries(the, theSlot, fxMarkValue);
 		break;
 
 	case XS_WEAK_MAP_KIND:
@@ -1112,6 +1419,12 @@ void fxMarkWeakStuff(txMachine* the)
 	txSlot* slot;
 	txSlot** address;
 
+	/* unlink the deleted entries that no iterator or forEach is on */
+	while ((slot = the->firstTableLink)) {
+		the->firstTableLink = mxTableLink(slot);
+		mxTableLink(slot) = C_NULL;
+		fxPurgeEntries(the, slot, XS_MARK_FLAG);
+	}
 	{
 		txSlot* list;
 		txSlot** listAddress = &the->firstWeakListLink;
@@ -1171,6 +1484,451 @@ void fxMarkWeakStuff(txMachine* the)
 	}
 }
 
+#if mxParallelMark
+
+txBoolean fxClaimSlot(txSlot* slot)
+{
+	if (__atomic_load_n(&slot->flag, __ATOMIC_RELAXED) & XS_MARK_FLAG)
+		return 0;
+	return (__atomic_fetch_or(&slot->flag, XS_MARK_FLAG, __ATOMIC_SEQ_CST) & XS_MARK_FLAG) ? 0 : 1;
+}
+
+void fxMarkEntriesInParallel(txMarkThread* thread, txSlot* table)
+{
+	txSlot* list = table->next;
+	txSlot* slot;
+	txBoolean deleted = 0;
+	if (!list || (list->kind != XS_LIST_KIND) || !fxClaimSlot(list))
+		return;
+	slot = list->value.list.first;
+	while (slot) {
+		if (slot->flag & XS_DONT_ENUM_FLAG)
+			deleted = 1;
+		else if (fxClaimSlot(slot))
+			fxMarkValueInParallel(thread, slot);
+		slot = slot->next;
+	}
+	if (deleted) {
+		mxTableLink(table) = thread->firstTableLink;
+		thread->firstTableLink = table;
+	}
+}
+
+txBoolean fxMarkInParallel(txMachine* the, txBoolean chunks)
+{
+	txMarkState state;
+	txMarkThread* thread;
+	txInteger index;
+	txSlot* instance;
+	txSlot* property;
+	txSlot* slot;
+
+	if (the->maximumHeapCount < mxMarkThreshold)
+		return 0;
+	state.the = the;
+	state.chunks = chunks;
+	for (index = 0; index < mxParallelMark; index++) {
+		thread = &state.threads[index];
+		c_memset(thread, 0, sizeof(txMarkThread));
+		thread->state = &state;
+		thread->index = index;
+		pthread_mutex_init(&thread->mutex, NULL);
+	}
+	thread = the->markThread = &state.threads[0];
+	fxMark(the, fxMarkRoot);
+	for (;;) {
+		fxMarkRoundInParallel(&state);
+		/* host markers are not thread safe: the collecting thread calls them between rounds, then marks what they reach in another round */
+		for (index = 0; index < mxParallelMark; index++) {
+			while ((instance = state.threads[index].firstHost)) {
+				state.threads[index].firstHost = instance->value.instance.garbage;
+				instance->value.instance.garbage = C_NULL;
+				property = instance->next;
+				while (property) {
+					if ((property->kind == XS_HOST_KIND) && (property->flag & XS_HOST_HOOKS_FLAG) && property->value.host.data && property->value.host.variant.hooks->marker)
+						(*property->value.host.variant.hooks->marker)(the, property->value.host.data, fxMarkRoot);
+					property = property->next;
+				}
+			}
+		}
+		if (!thread->first && !thread->sharedCount)
+			break;
+	}
+	the->markThread = C_NULL;
+	for (index = 0; index < mxParallelMark; index++) {
+		thread = &state.threads[index];
+		while ((slot = thread->firstTableLink)) {
+			thread->firstTableLink = mxTableLink(slot);
+			mxTableLink(slot) = the->firstTableLink;
+			the->firstTableLink = slot;
+		}
+		while ((slot = thread->firstWeakRefLink)) {
+			thread->firstWeakRefLink = slot->value.weakRef.link;
+			slot->value.weakRef.link = the->firstWeakRefLink;
+			the->firstWeakRefLink = slot;
+		}
+		pthread_mutex_destroy(&thread->mutex);
+	}
+	return 1;
+}
+
+void fxMarkInstanceInParallel(txMarkThread* thread, txSlot* instance)
+{
+	txSlot* property = instance->value.instance.prototype;
+	txBoolean host = 0;
+	if (property)
+		fxPushMark(thread, property);
+	property = instance->next;
+	while (property) {
+		if (fxClaimSlot(property)) {
+			if ((property->kind == XS_HOST_KIND) && (property->flag & XS_HOST_HOOKS_FLAG) && property->value.host.data && property->value.host.variant.hooks->marker)
+				host = 1;
+			fxMarkValueInParallel(thread, property);
+		}
+		property = property->next;
+	}
+	if (host) {
+		instance->value.instance.garbage = thread->firstHost;
+		thread->firstHost = instance;
+	}
+}
+
+void fxMarkRoot(txMachine* the, txSlot* slot)
+{
+	fxMarkValueInParallel(the->markThread, slot);
+}
+
+void fxMarkRoundInParallel(txMarkState* state)
+{
+	txInteger index;
+	state->threadCount = mxParallelMark;
+	state->idleCount = 0;
+	for (index = 1; index < mxParallelMark; index++) {
+		txMarkThread* thread = &state->threads[index];
+		thread->running = (pthread_create(&thread->thread, NULL, fxMarkThread, thread) == 0);
+		if (!thread->running)
+			__atomic_sub_fetch(&state->threadCount, 1, __ATOMIC_SEQ_CST);
+	}
+	fxMarkThread(&state->threads[0]);
+	for (index = 1; index < mxParallelMark; index++) {
+		txMarkThread* thread = &state->threads[index];
+		if (thread->running)
+			pthread_join(thread->thread, NULL);
+	}
+}
+
+void* fxMarkThread(void* it)
+{
+	txMarkThread* thread = it;
+	txMarkState* state = thread->state;
+	txSlot* instance;
+	txInteger index;
+	for (;;) {
+		while ((instance = fxPopMark(thread)))
+			fxMarkInstanceInParallel(thread, instance);
+		if (fxStealMark(thread))
+			continue;
+		/* only working threads push instances, so the marking is over when every thread is idle */
+		__atomic_add_fetch(&state->idleCount, 1, __ATOMIC_SEQ_CST);
+		for (;;) {
+			if (__atomic_load_n(&state->idleCount, __ATOMIC_SEQ_CST) == __atomic_load_n(&state->threadCount, __ATOMIC_SEQ_CST))
+				return NULL;
+			for (index = 0; index < mxParallelMark; index++) {
+				if (__atomic_load_n(&state->threads[index].sharedCount, __ATOMIC_RELAXED))
+					break;
+			}
+			if (index < mxParallelMark) {
+				__atomic_sub_fetch(&state->idleCount, 1, __ATOMIC_SEQ_CST);
+				break;
+			}
+			sched_yield();
+		}
+	}
+}
+
+void fxMarkValueInParallel(txMarkThread* thread, txSlot* theSlot)
+{
+#define mxMarkChunkInParallel(_THE_DATA) \
+	if (chunks) \
+		__atomic_fetch_or(&(((txChunk*)(((txByte*)_THE_DATA) - sizeof(txChunk)))->size), (txSize)mxChunkFlag, __ATOMIC_RELAXED)
+
+	txBoolean chunks = thread->state->chunks;
+	txSlot* aSlot;
+	switch (theSlot->kind) {
+	case XS_STRING_KIND:
+		mxMarkChunkInParallel(theSlot->value.string);
+		break;
+	case XS_BIGINT_KIND:
+		mxMarkChunkInParallel(theSlot->value.bigint.data);
+		break;
+	case XS_REFERENCE_KIND:
+		fxPushMark(thread, theSlot->value.reference);
+		break;
+	case XS_CLOSURE_KIND:
+		aSlot = theSlot->value.closure;
+		if (aSlot && fxClaimSlot(aSlot))
+			fxMarkValueInParallel(thread, aSlot);
+		break;
+	case XS_INSTANCE_KIND:
+		fxPushMark(thread, theSlot);
+		break;
+		
+	case XS_ARGUMENTS_SLOPPY_KIND:
+	case XS_ARGUMENTS_STRICT_KIND:
+	case XS_ARRAY_KIND:
+	case XS_STACK_KIND:
+		if ((aSlot = theSlot->value.array.address)) {
+			txIndex aLength = ((((txChunk*)(((txByte*)aSlot) - sizeof(txChunk)))->size) & ~mxChunkFlag) / sizeof(txSlot);
+			while (aLength) {
+				fxMarkValueInParallel(thread, aSlot);
+				aSlot++;
+				aLength--;
+			}
+			mxMarkChunkInParallel(theSlot->value.array.address);
+		}
+		break;
+	case XS_ARRAY_BUFFER_KIND:
+		if (theSlot->value.arrayBuffer.address) {
+			mxMarkChunkInParallel(theSlot->value.arrayBuffer.address);
+		}
+		break;
+	case XS_CALLBACK_KIND:
+		if (theSlot->value.callback.IDs) {
+			mxMarkChunkInParallel(theSlot->value.callback.IDs);
+		}
+		break;
+	case XS_CODE_KIND:
+		mxMarkChunkInParallel(theSlot->value.code.address);
+		/* continue */
+	case XS_CODE_X_KIND:
+		aSlot = theSlot->value.code.closures;
+		if (aSlot)
+			fxPushMark(thread, aSlot);
+		break;
+	case XS_GLOBAL_KIND:
+		mxMarkChunkInParallel(theSlot->value.table.address);
+		break;
+	case XS_HOST_KIND:
+		/* the collecting thread calls the marker, see fxMarkInstanceInParallel */
+		if (theSlot->value.host.data && (theSlot->flag & XS_HOST_CHUNK_FLAG)) {
+			mxMarkChunkInParallel(theSlot->value.host.data);
+		}
+		break;
+	case XS_PROXY_KIND:
+		aSlot = theSlot->value.proxy.handler;
+		if (aSlot)
+			fxPushMark(thread, aSlot);
+		aSlot = theSlot->value.proxy.target;
+		if (aSlot)
+			fxPushMark(thread, aSlot);
+		break;
+	case XS_REGEXP_KIND:
+		if (theSlot->value.regexp.code) {
+			mxMarkChunkInParallel(theSlot->value.regexp.code);
+		}
+		if (theSlot->value.regexp.data) {
+			mxMarkChunkInParallel(theSlot->value.regexp.data);
+		}
+		break;
+		
+	case XS_ACCESSOR_KIND:
+		aSlot = theSlot->value.accessor.getter;
+		if (aSlot)
+			fxPushMark(thread, aSlot);
+		aSlot = theSlot->value.accessor.setter;
+		if (aSlot)
+			fxPushMark(thread, aSlot);
+		break;
+	case XS_HOME_KIND:
+		aSlot = theSlot->value.home.object;
+		if (aSlot)
+			fxPushMark(thread, aSlot);
+		aSlot = theSlot->value.home.module;
+		if (aSlot)
+			fxPushMark(thread, aSlot);
+		break;
+	case XS_MODULE_KIND:
+	case XS_PROGRAM_KIND:
+		aSlot = theSlot->value.module.realm;
+		if (aSlot)
+			fxPushMark(thread, aSlot);
+		break;
+	case XS_EXPORT_KIND:
+		aSlot = theSlot->value.export.closure;
+		if (aSlot && fxClaimSlot(aSlot))
+			fxMarkValueInParallel(thread, aSlot);
+		aSlot = theSlot->value.export.module;
+		if (aSlot)
+			fxPushMark(thread, aSlot);
+		break;
+	case XS_KEY_KIND:
+		if (theSlot->value.key.string) {
+			mxMarkChunkInParallel(theSlot->value.key.string);
+		}
+		break;
+		
+	case XS_ERROR_KIND:
+		aSlot = theSlot->value.error.info;
+		if (aSlot)
+			fxPushMark(thread, aSlot);
+		break;
+	case XS_LIST_KIND:
+		aSlot = theSlot->value.list.first;
+		while (aSlot) {
+			if (fxClaimSlot(aSlot))
+				fxMarkValueInParallel(thread, aSlot);
+			aSlot = aSlot->next;
+		}
+		break;
+		
+	case XS_PRIVATE_KIND:
+		fxPushMark(thread, theSlot->value.private.check);
+		aSlot = theSlot->value.private.first;
+		while (aSlot) {
+			if (fxClaimSlot(aSlot))
+				fxMarkValueInParallel(thread, aSlot);
+			aSlot = aSlot->next;
+		}
+		break;
+
+	case XS_MAP_KIND:
+	case XS_SET_KIND:
+		mxMarkChunkInParallel(theSlot->value.table.address);
+		fxMarkEntriesInParallel(thread, theSlot);
+		break;
+
+	case XS_WEAK_MAP_KIND:
+	case XS_WEAK_SET_KIND:
+		aSlot = theSlot->value.weakList.first;
+		while (aSlot) {
+			if (fxClaimSlot(aSlot))
+				fxMarkValueInParallel(thread, aSlot);
+			aSlot = aSlot->next;
+		}
+		break;
+	case XS_WEAK_ENTRY_KIND:
+		/* the list and the key are claimed before their entries are read, so either the thread that marks the list or the thread that marks the key sees both marked */
+		aSlot = theSlot->value.weakEntry.check;
+		if (__atomic_load_n(&aSlot->flag, __ATOMIC_SEQ_CST) & XS_MARK_FLAG) {
+			aSlot = theSlot->value.weakEntry.value;
+			if (fxClaimSlot(aSlot))
+				fxMarkValueInParallel(thread, aSlot);
+		}
+		break;
+	case XS_WEAK_REF_KIND:
+		if (theSlot->value.weakRef.target) {
+			theSlot->value.weakRef.link = thread->firstWeakRefLink;
+			thread->firstWeakRefLink = theSlot;
+		}
+		break;
+	case XS_FINALIZATION_REGISTRY_KIND:
+		aSlot = theSlot->value.finalizationRegistry.callback;
+		if (aSlot) {
+			fxClaimSlot(aSlot);
+			fxMarkValueInParallel(thread, aSlot);
+			aSlot = aSlot->next;
+			while (aSlot) {
+				fxClaimSlot(aSlot);
+				fxMarkValueInParallel(thread, aSlot); // holdings
+				aSlot = aSlot->next;
+				if (aSlot) {
+					fxClaimSlot(aSlot);
+					// weak target and token
+					aSlot = aSlot->next;
+				}
+			}
+		}
+		break;
+		
+	case XS_HOST_INSPECTOR_KIND:
+		fxPushMark(thread, theSlot->value.hostInspector.cache);
+		break;	
+	}
+}
+
+txSlot* fxPopMark(txMarkThread* thread)
+{
+	txSlot* instance = thread->first;
+	if (!instance && __atomic_load_n(&thread->sharedCount, __ATOMIC_RELAXED)) {
+		pthread_mutex_lock(&thread->mutex);
+		thread->first = thread->firstShared;
+		thread->count = __atomic_load_n(&thread->sharedCount, __ATOMIC_RELAXED);
+		thread->firstShared = C_NULL;
+		__atomic_store_n(&thread->sharedCount, 0, __ATOMIC_RELAXED);
+		pthread_mutex_unlock(&thread->mutex);
+		instance = thread->first;
+	}
+	if (instance) {
+		thread->first = instance->value.instance.garbage;
+		thread->count--;
+		instance->value.instance.garbage = C_NULL;
+	}
+	return instance;
+}
+
+void fxPushMark(txMarkThread* thread, txSlot* instance)
+{
+	txSlot* slot;
+	txSize count;
+	if (!fxClaimSlot(instance))
+		return;
+	/* mark stacks link instances by their garbage field, which only the serial marker uses */
+	instance->value.instance.garbage = thread->first;
+	thread->first = instance;
+	thread->count++;
+	/* keep the latest instances, share the others when the former ones have been stolen */
+	if ((thread->count > 2 * mxMarkShare) && !__atomic_load_n(&thread->sharedCount, __ATOMIC_RELAXED)) {
+		slot = thread->first;
+		count = mxMarkShare;
+		while (--count)
+			slot = slot->value.instance.garbage;
+		pthread_mutex_lock(&thread->mutex);
+		thread->firstShared = slot->value.instance.garbage;
+		__atomic_store_n(&thread->sharedCount, thread->count - mxMarkShare, __ATOMIC_RELAXED);
+		pthread_mutex_unlock(&thread->mutex);
+		slot->value.instance.garbage = C_NULL;
+		thread->count = mxMarkShare;
+	}
+}
+
+txBoolean fxStealMark(txMarkThread* thread)
+{
+	txMarkState* state = thread->state;
+	txInteger index;
+	txMarkThread* victim;
+	txSlot* first;
+	txSlot* last = C_NULL;
+	txSize count = 0, steps;
+	for (index = 1; index < mxParallelMark; index++) {
+		victim = &state->threads[(thread->index + index) % mxParallelMark];
+		if (!__atomic_load_n(&victim->sharedCount, __ATOMIC_RELAXED))
+			continue;
+		pthread_mutex_lock(&victim->mutex);
+		if ((first = victim->firstShared)) {
+			/* steal half of the shared instances, at most as many as a thread keeps */
+			count = (__atomic_load_n(&victim->sharedCount, __ATOMIC_RELAXED) + 1) >> 1;
+			if (count > mxMarkShare)
+				count = mxMarkShare;
+			last = first;
+			steps = count;
+			while (--steps)
+				last = last->value.instance.garbage;
+			victim->firstShared = last->value.instance.garbage;
+			__atomic_sub_fetch(&victim->sharedCount, count, __ATOMIC_RELAXED);
+		}
+		pthread_mutex_unlock(&victim->mutex);
+		if (first) {
+			last->value.instance.garbage = thread->first;
+			thread->first = first;
+			thread->count += count;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+#endif
+
 txSize fxMultiplyChunkSizes(txMachine* the, txSize a, txSize b)
 {
 	txSize c;
@@ -1235,6 +1993,9 @@ again:
 		aSlot->next = C_NULL;
 		aSlot->ID = XS_NO_ID;
 		aSlot->flag = XS_NO_FLAG;
+#if mxPropertyCacheKeys || mxDictionaries
+		mxInstanceIndex(aSlot) = 0;
+#endif
 		the->currentHeapCount++;
 		if (the->peakHeapCount < the->currentHeapCount)
 			the->peakHeapCount = the->currentHeapCount;
@@ -1263,6 +2024,9 @@ void* fxRenewChunk(txMachine* the, void* theData, txSize size)
 	txChunk* aChunk = (txChunk*)aData;
 	txSize capacity = (txSize)(aChunk->temporary - aData);
 	txBlock* aBlock = the->firstBlock;
+#if mxStringCache
+	fxInvalidateStringCacheEntry(the, theData);
+#endif
 	size = fxAdjustChunkSize(the, size);
 	if (size <= capacity) {
 		aChunk->size = size;
@@ -1318,6 +2082,13 @@ void fxShare(txMachine* the)
 		while (slot < limit) {
 			if (slot->kind == XS_INSTANCE_KIND) {
 				txBoolean frozen = (slot->flag & XS_DONT_PATCH_FLAG) ? 1 : 0;
+#if mxDictionaries
+				if (mxInstanceIndex(slot) < 0)
+					fxFreeDictionary(the, slot);
+#endif
+#if mxPropertyCacheKeys
+				mxInstanceIndex(slot) = 0;
+#endif
 				if (frozen) {
 					txSlot *property = slot->next;
 					while (property) {
@@ -1374,6 +2145,170 @@ void fxShare(txMachine* the)
 	*/
 }
 
+void fxReleaseSlot(txMachine* the, txSlot* theSlot)
+{
+	if (theSlot->kind == XS_HOST_KIND) {
+		if (theSlot->flag & XS_HOST_HOOKS_FLAG) {
+			if (theSlot->value.host.variant.hooks->destructor)
+				(*(theSlot->value.host.variant.hooks->destructor))(theSlot->value.host.data);
+		}
+		else if (theSlot->value.host.variant.destructor)
+			(*(theSlot->value.host.variant.destructor))(theSlot->value.host.data);
+	}
+#if mxInstrument
+	if (theSlot->kind == XS_MODULE_KIND)
+		the->loadedModulesCount--;
+#endif
+#if mxDictionaries
+	if ((theSlot->kind == XS_INSTANCE_KIND) && (mxInstanceIndex(theSlot) < 0))
+		fxFreeDictionary(the, theSlot);
+#endif
+#if mxFill
+	c_memset(theSlot, 0xFF, sizeof(txSlot));
+#endif
+	theSlot->kind = XS_UNDEFINED_KIND;
+}
+
+#if mxParallelSweep
+
+void fxSweepSlotTask(txMachine* the, txSweepTask* task)
+{
+	txSlot* slot = task->from;
+	txSlot* limit = task->to;
+	txSize count = 0;
+	txSlot* firstFree = C_NULL;
+	txSlot* lastFree = C_NULL;
+	txSlot* firstRelease = C_NULL;
+	while (slot < limit) {
+		if (slot->flag & XS_MARK_FLAG) {
+			slot->flag &= ~XS_MARK_FLAG; 
+		#ifdef mxDebug
+			/* fxCheck is not thread safe: the collecting thread checks the tasks */
+			if ((slot->kind == XS_REFERENCE_KIND) && (slot->value.reference->kind != XS_INSTANCE_KIND))
+				task->broken = 1;
+		#endif
+			count++;
+		}
+		else if ((slot->kind == XS_HOST_KIND)
+		#if mxInstrument
+			|| (slot->kind == XS_MODULE_KIND)
+		#endif
+		#if mxDictionaries
+			|| ((slot->kind == XS_INSTANCE_KIND) && (mxInstanceIndex(slot) < 0))
+		#endif
+		) {
+			/* destructors and the machine are not thread safe: such slots are released by the collecting thread */
+			slot->next = firstRelease;
+			firstRelease = slot;
+		}
+		else {
+		#if mxFill
+			c_memset(slot, 0xFF, sizeof(txSlot));
+		#endif
+			slot->kind = XS_UNDEFINED_KIND;
+			slot->next = firstFree;
+			firstFree = slot;
+			if (!lastFree)
+				lastFree = slot;
+		}
+		slot++;
+	}
+	task->count = count;
+	task->firstFree = firstFree;
+	task->lastFree = lastFree;
+	task->firstRelease = firstRelease;
+}
+
+void* fxSweepSlotThread(void* it)
+{
+	txSweepThread* thread = it;
+	txSize index = thread->index;
+	while (index < thread->taskCount) {
+		fxSweepSlotTask(thread->the, thread->tasks + index);
+		index += mxParallelSweep;
+	}
+	return NULL;
+}
+
+txBoolean fxSweepSlotsInParallel(txMachine* the)
+{
+	txSweepThread threads[mxParallelSweep];
+	txSweepTask* tasks;
+	txSweepTask* task;
+	txSize taskCount = 0, index;
+	txSlot* heap;
+	txSlot* slot;
+	txSlot* limit;
+	txSize count = 0;
+	txSlot* freeSlot = C_NULL;
+	
+	if (the->maximumHeapCount < 2 * mxSweepStride)
+		return 0;
+	heap = the->firstHeap;
+	while (heap) {
+		taskCount += ((txSize)(heap->value.reference - (heap + 1)) + mxSweepStride - 1) / mxSweepStride;
+		heap = heap->next;
+	}
+	tasks = c_malloc(taskCount * sizeof(txSweepTask));
+	if (!tasks)
+		return 0;
+	task = tasks;
+	heap = the->firstHeap;
+	while (heap) {
+		slot = heap + 1;
+		limit = heap->value.reference;
+		while (slot < limit) {
+			task->from = slot;
+			task->to = ((limit - slot) > mxSweepStride) ? slot + mxSweepStride : limit;
+		#ifdef mxDebug
+			task->broken = 0;
+		#endif
+			slot = task->to;
+			task++;
+		}
+		heap = heap->next;
+	}
+	
+	for (index = 0; index < mxParallelSweep; index++) {
+		txSweepThread* thread = &threads[index];
+		thread->the = the;
+		thread->tasks = tasks;
+		thread->taskCount = taskCount;
+		thread->index = index;
+		thread->running = (index > 0) && (index < taskCount) && (pthread_create(&thread->thread, NULL, fxSweepSlotThread, thread) == 0);
+	}
+	for (index = 0; index < mxParallelSweep; index++) {
+		txSweepThread* thread = &threads[index];
+		if (thread->running)
+			pthread_join(thread->thread, NULL);
+		else
+			fxSweepSlotThread(thread);
+	}
+	
+	for (index = 0, task = tasks; index < taskCount; index++, task++) {
+		mxCheck(the, !task->broken);
+		count += task->count;
+		if (task->firstFree) {
+			task->lastFree->next = freeSlot;
+			freeSlot = task->firstFree;
+		}
+		slot = task->firstRelease;
+		while (slot) {
+			txSlot* next = slot->next;
+			fxReleaseSlot(the, slot);
+			slot->next = freeSlot;
+			freeSlot = slot;
+			slot = next;
+		}
+	}
+	c_free(tasks);
+	the->currentHeapCount = count;
+	the->freeHeap = freeSlot;
+	return 1;
+}
+
+#endif
+
 void fxSweep(txMachine* the)
 {
 	txSize aTotal;
@@ -1408,6 +2343,12 @@ void fxSweep(txMachine* the)
 				((txChunk*)current)->temporary = temporary;
 				temporary += aSize;
 				aTotal += aSize;
+				if ((txSize)(next - current - aSize) >= (txSize)sizeof(txChunk)) {
+					/* split the unused capacity, so the chunk size is the size of the data while sweeping sparse arrays */
+					((txChunk*)current)->size = aSize;
+					current += aSize;
+					((txChunk*)current)->temporary = C_NULL;
+				}
 			}
 			else {
 				((txChunk*)current)->temporary = C_NULL;
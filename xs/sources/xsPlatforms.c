@@ -99,11 +99,9 @@ void fxBuildKeys(txMachine* the)
 {
 	int i;
 	for (i = 0; i < XS_SYMBOL_ID_COUNT; i++) {
-		txID id = the->keyIndex;
 		txSlot* description = fxNewSlot(the);
 		fxCopyStringC(the, description, gxIDStrings[i]);
-		the->keyArray[id] = description;
-		the->keyIndex++;
+		fxNewKey(the, description);
 	}
 	for (; i < XS_ID_COUNT; i++) {
 		fxID(the, gxIDStrings[i]);
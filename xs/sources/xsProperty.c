@@ -40,11 +40,28 @@
 txSlot* fxLastProperty(txMachine* the, txSlot* slot)
 {
 	txSlot* property;
+#if mxPropertyCacheKeys
+	if ((slot->kind == XS_INSTANCE_KIND) && (mxInstanceIndex(slot) > 0))
+		mxInstanceIndex(slot) = 0;
+#endif
 	while ((property = slot->next))
 		slot = property;
 	return slot;
 }
 
+txSlot* fxNewProperty(txMachine* the, txSlot** address, txID id, txFlag flag)
+{
+	txSlot* property = *address = fxNewSlot(the);
+	property->flag = flag;
+	property->ID = id;
+#if mxPropertyCache
+	/* every named property is created here, so the property cache forgets the lookups that found the ID on a prototype */
+	if (the->propertyCacheShadows[(((txU4)id) >> 5) % mxPropertyCacheShadowCount] & (1 << (id & 31)))
+		fxInvalidatePropertyCache(the);
+#endif
+	return property;
+}
+
 txSlot* fxNextHostAccessorProperty(txMachine* the, txSlot* property, txCallback get, txCallback set, txID id, txFlag flag)
 {
 	txSlot *getter = NULL, *setter = NULL, *home = the->stack, *slot;
@@ -60,9 +77,7 @@ txSlot* fxNextHostAccessorProperty(txMachine* the, txSlot* property, txCallback
 		slot->value.home.object = home->value.reference;
 		fxRenameFunction(the, setter, id, 0, id, "set ");
 	}
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	property->kind = XS_ACCESSOR_KIND;
 	property->value.accessor.getter = getter;
 	property->value.accessor.setter = setter;
@@ -80,9 +95,7 @@ txSlot* fxNextHostFunctionProperty(txMachine* the, txSlot* property, txCallback
 	function = fxNewHostFunction(the, call, length, id);
 	slot = mxFunctionInstanceHome(function);
 	slot->value.home.object = home->value.reference;
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	property->kind = the->stack->kind;
 	property->value = the->stack->value;
 	mxPop();
@@ -92,27 +105,21 @@ txSlot* fxNextHostFunctionProperty(txMachine* the, txSlot* property, txCallback
 
 txSlot* fxNextUndefinedProperty(txMachine* the, txSlot* property, txID id, txFlag flag)
 {
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	property->kind = XS_UNDEFINED_KIND;
 	return property;
 }
 
 txSlot* fxNextNullProperty(txMachine* the, txSlot* property, txID id, txFlag flag)
 {
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	property->kind = XS_NULL_KIND;
 	return property;
 }
 
 txSlot* fxNextBooleanProperty(txMachine* the, txSlot* property, txBoolean boolean, txID id, txFlag flag)
 {
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	property->kind = XS_BOOLEAN_KIND;
 	property->value.boolean = boolean;
 	return property;
@@ -120,9 +127,7 @@ txSlot* fxNextBooleanProperty(txMachine* the, txSlot* property, txBoolean boolea
 
 txSlot* fxNextIntegerProperty(txMachine* the, txSlot* property, txInteger integer, txID id, txFlag flag)
 {
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	property->kind = XS_INTEGER_KIND;
 	property->value.integer = integer;
 	return property;
@@ -130,9 +135,7 @@ txSlot* fxNextIntegerProperty(txMachine* the, txSlot* property, txInteger intege
 
 txSlot* fxNextNumberProperty(txMachine* the, txSlot* property, txNumber number, txID id, txFlag flag)
 {
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	property->kind = XS_NUMBER_KIND;
 	property->value.number = number;
 	return property;
@@ -140,9 +143,7 @@ txSlot* fxNextNumberProperty(txMachine* the, txSlot* property, txNumber number,
 
 txSlot* fxNextReferenceProperty(txMachine* the, txSlot* property, txSlot* slot, txID id, txFlag flag)
 {
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	property->kind = XS_REFERENCE_KIND;
 	property->value.reference = slot;
 	return property;
@@ -150,9 +151,7 @@ txSlot* fxNextReferenceProperty(txMachine* the, txSlot* property, txSlot* slot,
 
 txSlot* fxNextSlotProperty(txMachine* the, txSlot* property, txSlot* slot, txID id, txFlag flag)
 {
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	property->kind = slot->kind;
 	property->value = slot->value;
 	return property;
@@ -160,18 +159,14 @@ txSlot* fxNextSlotProperty(txMachine* the, txSlot* property, txSlot* slot, txID
 
 txSlot* fxNextStringProperty(txMachine* the, txSlot* property, txString string, txID id, txFlag flag)
 {
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	fxCopyStringC(the, property, string);
 	return property;
 }
 
 txSlot* fxNextStringXProperty(txMachine* the, txSlot* property, txString string, txID id, txFlag flag)
 {
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 #ifdef mxSnapshot
 	fxCopyStringC(the, property, string);
 #else
@@ -184,9 +179,7 @@ txSlot* fxNextStringXProperty(txMachine* the, txSlot* property, txString string,
 
 txSlot* fxNextSymbolProperty(txMachine* the, txSlot* property, txID symbol, txID id, txFlag flag)
 {
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	property->kind = XS_SYMBOL_KIND;
 	property->value.symbol = symbol;
 	return property;
@@ -194,9 +187,7 @@ txSlot* fxNextSymbolProperty(txMachine* the, txSlot* property, txID symbol, txID
 
 txSlot* fxNextTypeDispatchProperty(txMachine* the, txSlot* property, txTypeDispatch* dispatch, txTypeAtomics* atomics, txID id, txFlag flag)
 {
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	property->kind = XS_TYPED_ARRAY_KIND;
 	property->value.typedArray.dispatch = dispatch;
 	property->value.typedArray.atomics = atomics;
@@ -240,6 +231,21 @@ static txSize fxSizeToCapacity(txMachine* the, txSize size)
 	return fxAddChunkSizes(the, size, size / 3);
 }
 
+static txSlot* fxSearchIndexProperty(txMachine* the, txSlot* address, txIndex size, txIndex index)
+{
+	/* the items of sparse arrays are sorted by index, return the first item at or after the index */
+	txIndex low = 0;
+	txIndex high = size;
+	while (low < high) {
+		txIndex middle = low + ((high - low) >> 1);
+		if (*((txIndex*)(address + middle)) < index)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return address + low;
+}
+
 txBoolean fxDeleteIndexProperty(txMachine* the, txSlot* array, txIndex index) 
 {
 	txSlot* address = array->value.array.address;
@@ -252,15 +258,9 @@ txBoolean fxDeleteIndexProperty(txMachine* the, txSlot* array, txIndex index)
 		if (length == size)
 			result = address + index;
 		else {
-			txIndex at;
-			while (result < limit) {
-				at = *((txIndex*)result);
-				if (at == index)
-					break;
-				if (at > index)
-					return 1;
-				result++;
-			}
+			result = fxSearchIndexProperty(the, address, size, index);
+			if ((result < limit) && (*((txIndex*)result) != index))
+				return 1;
 		}
 		if (result < limit) {
 			if (result->flag & XS_DONT_DELETE_FLAG)
@@ -293,15 +293,9 @@ txSlot* fxGetIndexProperty(txMachine* the, txSlot* array, txIndex index)
 				return address + index;
 		}
 		else {
-			txSlot* result = address;
-			txSlot* limit = result + size;
-			txIndex at;
-			while (result < limit) {
-				at = *((txIndex*)result);
-				if (at == index)
-					return result;
-				result++;
-			}
+			txSlot* result = fxSearchIndexProperty(the, address, size, index);
+			if ((result < address + size) && (*((txIndex*)result) == index))
+				return result;
 		}
 	}
 	return C_NULL;
@@ -367,32 +361,31 @@ txSlot* fxSetIndexProperty(txMachine* the, txSlot* instance, txSlot* array, txIn
 			result = chunk + length;
 		}
 		else {
-			result = address;
-			limit = result + current;
-			while (result < limit) {
-				at = *((txIndex*)result);
-				if (at == index)
-					return result;
-				if (at > index)
-					break;
-				result++;
-			}
+			result = fxSearchIndexProperty(the, address, current, index);
+			limit = address + current;
+			if ((result < limit) && (*((txIndex*)result) == index))
+				return result;
 			if (instance->flag & XS_DONT_PATCH_FLAG)
 				return C_NULL;
 			if ((array->flag & XS_DONT_SET_FLAG) && (index >= length))
 				return C_NULL;
 			at = mxPtrDiff(result - address);
-			current++;
-			size = fxMultiplyChunkSizes(the, current, sizeof(txSlot));
-			chunk = (txSlot*)fxNewChunk(the, size);
-			address = array->value.array.address;
-			result = address + at;
-			limit = address + current - 1;
-			if (result > address)
-				c_memcpy(chunk, address, (result - address) * sizeof(txSlot));
-			if (result < limit)
-				c_memcpy(chunk + (result - address) + 1, result, (limit - result) * sizeof(txSlot));
-			result = chunk + (result - address);
+			size = fxMultiplyChunkSizes(the, current + 1, sizeof(txSlot));
+			/* like dense arrays, sparse arrays grow into the capacity of their chunk */
+			chunk = (txSlot*)fxRenewChunk(the, address, size);
+			if (!chunk) {
+			#ifndef mxNoArrayOverallocation
+				if (array->ID == XS_ARRAY_BEHAVIOR)
+					chunk = (txSlot*)fxNewGrowableChunk(the, size, fxSizeToCapacity(the, size));
+				else
+			#endif
+					chunk = (txSlot*)fxNewChunk(the, size);
+				address = array->value.array.address;
+				c_memcpy(chunk, address, at * sizeof(txSlot));
+			}
+			if (at < current)
+				c_memmove(chunk + at + 1, address + at, (current - at) * sizeof(txSlot));
+			result = chunk + at;
 		}
 	}
 	else {
@@ -606,9 +599,440 @@ txSlot* fxSetPrivateProperty(txMachine* the, txSlot* instance, txSlot* check, tx
 	return result;
 }
 
+#if mxPropertyCache
+
+/* Property caches remember, for a GET_PROPERTY or SET_PROPERTY site, the slot found by the last lookups. 
+   Entries are valid for the current epoch. The epoch changes when a property is deleted, when a prototype is modified, when an instance is aliased, 
+   when a property that would shadow a cached inherited property is created, and at every collection since slots and code can be freed or moved. 
+   With property cache keys, entries are also keyed by the key of the receiver, so that instances built the same way share entries. */
+
+static txPropertyCacheEntry* fxFindPropertyCacheEntry(txMachine* the, txByte* code, txSlot* instance);
+static txSlot* fxFindPropertyCacheOwner(txMachine* the, txSlot* instance, txID id, txSlot* property, txBoolean own, txInteger* position);
+static txSlot* fxLookupPropertyCache(txMachine* the, txPropertyCacheEntry* entry, txByte* code, txSlot* instance);
+static void fxUpdatePropertyCache(txMachine* the, txPropertyCacheEntry* entry, txByte* code, txSlot* instance, txSlot* property, txInteger position);
+
+txPropertyCacheEntry* fxFindPropertyCacheEntry(txMachine* the, txByte* code, txSlot* instance)
+{
+#if mxPropertyCacheKeys
+	txUnsigned hash = (txUnsigned)((size_t)code);
+#else
+	txUnsigned hash = (txUnsigned)(((size_t)code) ^ (((size_t)instance) >> 4));
+#endif
+	hash ^= hash >> 9;
+	return the->propertyCache + ((hash % (mxPropertyCacheCount / mxPropertyCacheWayCount)) * mxPropertyCacheWayCount);
+}
+
+txSlot* fxFindPropertyCacheOwner(txMachine* the, txSlot* instance, txID id, txSlot* property, txBoolean own, txInteger* position)
+{
+	txSlot* slot;
+	txInteger count;
+	*position = 0;
+	while (instance) {
+		if (instance->flag & XS_EXOTIC_FLAG)
+			break;
+		if (instance->ID) {
+			txSlot* alias = the->aliasArray[instance->ID];
+			if (alias)
+				instance = alias;
+		}
+		slot = instance->next;
+		while (slot && (slot->flag & XS_INTERNAL_FLAG)) {
+			if (slot == property)
+				return C_NULL;
+			slot = slot->next;
+		}
+		count = 0;
+		while (slot) {
+			if (slot == property) {
+				if (*position == 0)
+					*position = count;
+				return instance;
+			}
+			if ((slot->ID == id) && !(slot->flag & XS_INTERNAL_FLAG))
+				return C_NULL;
+			slot = slot->next;
+			count++;
+		}
+		if (own)
+			break;
+		*position = -1;
+		instance = instance->value.instance.prototype;
+	}
+	return C_NULL;
+}
+
+txSlot* fxLookupPropertyCache(txMachine* the, txPropertyCacheEntry* entry, txByte* code, txSlot* instance)
+{
+	txUnsigned epoch = the->propertyCacheEpoch;
+	txInteger way;
+#if mxPropertyCacheKeys
+	txInteger key = fxGetPropertyCacheKey(the, instance);
+#endif
+	for (way = 0; way < mxPropertyCacheWayCount; way++, entry++) {
+		if ((entry->code != code) || (entry->epoch != epoch))
+			continue;
+		if (entry->instance == instance)
+			return entry->property;
+#if mxPropertyCacheKeys
+		if (key && (entry->key == key)) {
+			txInteger position = entry->position;
+			/* own properties are cached by position, at most mxPropertyCacheKeyLimit slots after the internal slots */
+			if (position >= 0) {
+				txSlot* property = instance->next;
+				while (property->flag & XS_INTERNAL_FLAG)
+					property = property->next;
+				while (position) {
+					property = property->next;
+					position--;
+				}
+				entry->instance = instance;
+				entry->property = property;
+			}
+			return entry->property;
+		}
+#endif
+	}
+	return C_NULL;
+}
+
+void fxUpdatePropertyCache(txMachine* the, txPropertyCacheEntry* entry, txByte* code, txSlot* instance, txSlot* property, txInteger position)
+{
+	c_memmove(entry + 1, entry, (mxPropertyCacheWayCount - 1) * sizeof(txPropertyCacheEntry));
+	entry->code = code;
+	entry->instance = instance;
+	entry->property = property;
+	entry->epoch = the->propertyCacheEpoch;
+#if mxPropertyCacheKeys
+	entry->key = mxInstanceIndex(instance);
+	entry->position = position;
+	if ((entry->key < 0) || (entry->key && (position >= the->propertyCacheKeyArray[entry->key].count)))
+		entry->key = 0;
+#endif
+}
+
+txSlot* fxGetCachedProperty(txMachine* the, txByte* code, txSlot* instance, txID id)
+{
+	txPropertyCacheEntry* entry = fxFindPropertyCacheEntry(the, code, instance);
+	txUnsigned epoch = the->propertyCacheEpoch;
+	txSlot* result = fxLookupPropertyCache(the, entry, code, instance);
+	txSlot* owner;
+	txInteger position;
+	if (result) {
+		the->propertyCacheHits++;
+		return result;
+	}
+	the->propertyCacheMisses++;
+	result = mxBehaviorGetProperty(the, instance, id, 0, XS_ANY);
+	if (result && (epoch == the->propertyCacheEpoch)) {
+		owner = fxFindPropertyCacheOwner(the, instance, id, result, 0, &position);
+		if (owner) {
+			if (position < 0)
+				the->propertyCacheShadows[(((txU4)id) >> 5) % mxPropertyCacheShadowCount] |= 1 << (id & 31);
+			fxUpdatePropertyCache(the, entry, code, instance, result, position);
+		}
+	}
+	return result;
+}
+
+void fxInvalidatePropertyCache(txMachine* the)
+{
+	the->propertyCacheEpoch++;
+	if (the->propertyCacheEpoch == 0) {
+		c_memset(the->propertyCache, 0, mxPropertyCacheCount * sizeof(txPropertyCacheEntry));
+		the->propertyCacheEpoch = 1;
+	}
+	c_memset(the->propertyCacheShadows, 0, sizeof(the->propertyCacheShadows));
+}
+
+txSlot* fxSetCachedProperty(txMachine* the, txByte* code, txSlot* instance, txID id)
+{
+	txPropertyCacheEntry* entry = fxFindPropertyCacheEntry(the, code, instance);
+	txUnsigned epoch = the->propertyCacheEpoch;
+	txSlot* result = fxLookupPropertyCache(the, entry, code, instance);
+	txInteger position;
+	if (result) {
+		the->propertyCacheHits++;
+		return result;
+	}
+	the->propertyCacheMisses++;
+	result = mxBehaviorSetProperty(the, instance, id, 0, XS_ANY);
+	if (result && (epoch == the->propertyCacheEpoch)) {
+		if (fxFindPropertyCacheOwner(the, instance, id, result, 1, &position))
+			fxUpdatePropertyCache(the, entry, code, instance, result, position);
+	}
+	return result;
+}
+
+#endif
+
+#if mxPropertyCacheKeys
+
+/* Property cache keys only key the property caches: they identify the ordinary instances with the same prototype and the same sequence of IDs after their internal slots. 
+   Keys are shared and organized in transition trees, one tree by prototype. Instances get their key lazily, then keep it while properties are appended.
+   Properties stay in the slot chain: a hit on another instance with the same key still follows the chain to the cached position, but compares no IDs and walks no prototypes.
+   Since native code can append properties without updating the key, a key tells the position of the properties it knows, not the absence of others. */
 
+static txInteger fxNewPropertyCacheKey(txMachine* the, txInteger parent, txSlot* prototype, txID id, txInteger count);
 
+void fxEmptyPropertyCacheKeys(txMachine* the)
+{
+	txSlot *heap, *slot, *limit;
+	heap = the->firstHeap;
+	while (heap) {
+		slot = heap + 1;
+		limit = heap->value.reference;
+		while (slot < limit) {
+			if ((slot->kind == XS_INSTANCE_KIND) && (mxInstanceIndex(slot) > 0))
+				mxInstanceIndex(slot) = 0;
+			slot++;
+		}
+		heap = heap->next;
+	}
+	c_memset(the->propertyCacheKeyRoots, 0, sizeof(the->propertyCacheKeyRoots));
+	the->propertyCacheKeyIndex = 1;
+	fxInvalidatePropertyCache(the);
+}
 
+txInteger fxGetPropertyCacheKey(txMachine* the, txSlot* instance)
+{
+	txInteger key = mxInstanceIndex(instance);
+	txSlot* prototype = instance->value.instance.prototype;
+	txSlot* property;
+	txInteger count;
+	if (key > 0) {
+		if (the->propertyCacheKeyArray[key].prototype == prototype)
+			return key;
+	}
+	else if (key < 0)
+		return 0;
+	if ((instance->flag & XS_EXOTIC_FLAG) || instance->ID) {
+		mxInstanceIndex(instance) = 0;
+		return 0;
+	}
+	key = the->propertyCacheKeyRoots[((size_t)prototype >> 4) % mxPropertyCacheKeyRootModulo];
+	while (key) {
+		if ((the->propertyCacheKeyArray[key].prototype == prototype) && (the->propertyCacheKeyArray[key].parent == 0))
+			break;
+		key = the->propertyCacheKeyArray[key].next;
+	}
+	if (!key)
+		key = fxNewPropertyCacheKey(the, 0, prototype, XS_NO_ID, 0);
+	property = instance->next;
+	while (property && (property->flag & XS_INTERNAL_FLAG))
+		property = property->next;
+	count = 0;
+	while (property && key) {
+		key = fxNextPropertyCacheKey(the, key, count, property->ID);
+		property = property->next;
+		count++;
+	}
+	mxInstanceIndex(instance) = key;
+	return key;
+}
 
+txInteger fxNewPropertyCacheKey(txMachine* the, txInteger parent, txSlot* prototype, txID id, txInteger count)
+{
+	txPropertyCacheKey* key;
+	txInteger index = the->propertyCacheKeyIndex;
+	if (index == the->propertyCacheKeyCount) {
+		txPropertyCacheKey* array;
+		if (the->propertyCacheKeyCount == mxPropertyCacheKeyCount)
+			return 0;
+		array = (txPropertyCacheKey*)c_realloc(the->propertyCacheKeyArray, 2 * the->propertyCacheKeyCount * sizeof(txPropertyCacheKey));
+		if (!array)
+			return 0;
+		the->propertyCacheKeyArray = array;
+		the->propertyCacheKeyCount *= 2;
+	}
+	the->propertyCacheKeyIndex++;
+	key = the->propertyCacheKeyArray + index;
+	key->prototype = prototype;
+	key->parent = parent;
+	key->first = 0;
+	key->count = count;
+	key->id = id;
+	if (parent) {
+		key->next = the->propertyCacheKeyArray[parent].first;
+		the->propertyCacheKeyArray[parent].first = index;
+	}
+	else {
+		txInteger* address = &(the->propertyCacheKeyRoots[((size_t)prototype >> 4) % mxPropertyCacheKeyRootModulo]);
+		key->next = *address;
+		*address = index;
+	}
+	return index;
+}
 
+txInteger fxNextPropertyCacheKey(txMachine* the, txInteger key, txInteger count, txID id)
+{
+	txInteger child;
+	if (the->propertyCacheKeyArray[key].count != count)
+		return 0;
+	if (count == mxPropertyCacheKeyLimit)
+		return 0;
+	child = the->propertyCacheKeyArray[key].first;
+	while (child) {
+		if (the->propertyCacheKeyArray[child].id == id)
+			return child;
+		child = the->propertyCacheKeyArray[child].next;
+	}
+	return fxNewPropertyCacheKey(the, key, the->propertyCacheKeyArray[key].prototype, id, count + 1);
+}
 
+#endif
+
+#if mxDictionaries
+
+/* Dictionaries index the named properties of instances with many properties. The slot chain remains the reference, 
+   so enumeration order is preserved and native code can still walk or append to the chain: slots appended after the last indexed slot are indexed lazily. */
+
+#define mxDictionaryHash(ID) ((((txU4)(ID)) * 0x9E3779B1) >> 7)
+
+static txDictionary* fxGetDictionary(txMachine* the, txSlot* instance);
+static void fxGrowDictionary(txMachine* the, txSlot* instance, txDictionary* dictionary);
+static void fxIndexDictionaryProperty(txMachine* the, txDictionary* dictionary, txSlot* property);
+
+void fxFreeDictionary(txMachine* the, txSlot* instance)
+{
+	txInteger index = -mxInstanceIndex(instance);
+	c_free(the->dictionaryArray[index]);
+	the->dictionaryArray[index] = C_NULL;
+	if (the->dictionaryFree > index)
+		the->dictionaryFree = index;
+	mxInstanceIndex(instance) = 0;
+}
+
+txDictionary* fxGetDictionary(txMachine* the, txSlot* instance)
+{
+	txDictionary* dictionary = the->dictionaryArray[-mxInstanceIndex(instance)];
+	txSlot* property = dictionary->last;
+	while ((property = property->next)) {
+		if (!(property->flag & XS_INTERNAL_FLAG)) {
+			if (((dictionary->count + 1) * 4) > ((dictionary->mask + 1) * 3)) {
+				fxGrowDictionary(the, instance, dictionary);
+				dictionary = the->dictionaryArray[-mxInstanceIndex(instance)];
+			}
+			fxIndexDictionaryProperty(the, dictionary, property);
+		}
+		dictionary->last = property;
+	}
+	return dictionary;
+}
+
+txSlot* fxGetDictionaryProperty(txMachine* the, txSlot* instance, txID id)
+{
+	txDictionary* dictionary = fxGetDictionary(the, instance);
+	txInteger mask = dictionary->mask;
+	txInteger index = mxDictionaryHash(id) & mask;
+	txSlot* property;
+	while ((property = dictionary->table[index])) {
+		if (property->ID == id)
+			return property;
+		index = (index + 1) & mask;
+	}
+	return C_NULL;
+}
+
+txSlot** fxGetDictionaryTail(txMachine* the, txSlot* instance)
+{
+	txDictionary* dictionary = fxGetDictionary(the, instance);
+	return &(dictionary->last->next);
+}
+
+void fxGrowDictionary(txMachine* the, txSlot* instance, txDictionary* dictionary)
+{
+	txInteger size = 2 * (dictionary->mask + 1);
+	txDictionary* result = (txDictionary*)c_calloc(1, sizeof(txDictionary) + ((size - 1) * sizeof(txSlot*)));
+	txInteger index;
+	if (!result)
+		fxAbort(the, XS_NOT_ENOUGH_MEMORY_EXIT);
+	result->last = dictionary->last;
+	result->mask = size - 1;
+	for (index = 0; index <= dictionary->mask; index++) {
+		if (dictionary->table[index])
+			fxIndexDictionaryProperty(the, result, dictionary->table[index]);
+	}
+	c_free(dictionary);
+	the->dictionaryArray[-mxInstanceIndex(instance)] = result;
+}
+
+void fxIndexDictionaryProperty(txMachine* the, txDictionary* dictionary, txSlot* property)
+{
+	txInteger mask = dictionary->mask;
+	txInteger index = mxDictionaryHash(property->ID) & mask;
+	while (dictionary->table[index])
+		index = (index + 1) & mask;
+	dictionary->table[index] = property;
+	dictionary->count++;
+}
+
+void fxNewDictionary(txMachine* the, txSlot* instance)
+{
+	txInteger index = the->dictionaryFree;
+	txDictionary* dictionary;
+	txSlot* property;
+	txInteger size = 16;
+	while ((index < the->dictionaryCount) && the->dictionaryArray[index])
+		index++;
+	if (index >= the->dictionaryCount) {
+		txInteger count = the->dictionaryCount ? 2 * the->dictionaryCount : 16;
+		txDictionary** array;
+		if (count > mxDictionaryCount)
+			count = mxDictionaryCount;
+		if (index >= count)
+			return;
+		array = (txDictionary**)c_realloc(the->dictionaryArray, count * sizeof(txDictionary*));
+		if (!array)
+			return;
+		c_memset(array + the->dictionaryCount, 0, (count - the->dictionaryCount) * sizeof(txDictionary*));
+		the->dictionaryArray = array;
+		the->dictionaryCount = count;
+	}
+	while ((size * 3) < (mxDictionaryThreshold * 8))
+		size *= 2;
+	dictionary = (txDictionary*)c_calloc(1, sizeof(txDictionary) + ((size - 1) * sizeof(txSlot*)));
+	if (!dictionary)
+		return;
+	dictionary->last = instance;
+	dictionary->mask = size - 1;
+	the->dictionaryArray[index] = dictionary;
+	the->dictionaryFree = index + 1;
+	mxInstanceIndex(instance) = -index;
+	property = instance->next;
+	while (property && (property->flag & XS_INTERNAL_FLAG)) {
+		dictionary->last = property;
+		property = property->next;
+	}
+	fxGetDictionary(the, instance);
+}
+
+void fxRemoveDictionaryProperty(txMachine* the, txSlot* instance, txSlot* property, txSlot* previous)
+{
+	txDictionary* dictionary = fxGetDictionary(the, instance);
+	txInteger mask = dictionary->mask;
+	txInteger index = mxDictionaryHash(property->ID) & mask;
+	txInteger next, home;
+	while (dictionary->table[index] != property)
+		index = (index + 1) & mask;
+	next = index;
+	for (;;) {
+		next = (next + 1) & mask;
+		if (!dictionary->table[next])
+			break;
+		home = mxDictionaryHash(dictionary->table[next]->ID) & mask;
+		if ((index <= next) ? ((index < home) && (home <= next)) : ((index < home) || (home <= next)))
+			continue;
+		dictionary->table[index] = dictionary->table[next];
+		index = next;
+	}
+	dictionary->table[index] = C_NULL;
+	dictionary->count--;
+	if (dictionary->last == property)
+		dictionary->last = previous;
+#if mxDictionaryRevert
+	if (dictionary->count < (mxDictionaryThreshold / 2))
+		fxFreeDictionary(the, instance);
+#endif
+}
+
+#endif
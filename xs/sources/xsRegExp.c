@@ -39,6 +39,10 @@
 #if mxRegExp
 static txSlot* fxCheckRegExpInstance(txMachine* the, txSlot* slot);
 static void fxExecuteRegExp(txMachine* the, txSlot* regexp, txSlot* argument);
+#if mxRegExpCache
+static txSlot* fxFindRegExpCacheEntry(txMachine* the, txString pattern, txString modifier);
+static void fxInsertRegExpCacheEntry(txMachine* the, txSlot* regexp, txSlot* pattern, txSlot* modifier);
+#endif
 #endif
 
 static void fx_RegExp_prototype_get_flag(txMachine* the, txU4 flag);
@@ -113,6 +117,80 @@ void fxExecuteRegExp(txMachine* the, txSlot* regexp, txSlot* argument)
 	if ((the->stack->kind != XS_NULL_KIND) && (the->stack->kind != XS_REFERENCE_KIND))
 		mxTypeError("invalid exec result");
 }
+
+#if mxRegExpCache
+/* the cache list chains a regexp slot with its code, a key slot with its pattern and a key slot with its modifier for each entry, most recently used first */
+
+txSlot* fxFindRegExpCacheEntry(txMachine* the, txString pattern, txString modifier)
+{
+	txSlot* list = &mxRegExpCacheList;
+	txSlot* former = C_NULL;
+	txSlot* entry;
+	if (list->kind != XS_LIST_KIND)
+		return C_NULL;
+	entry = list->value.list.first;
+	while (entry) {
+		txSlot* source = entry->next;
+		txSlot* flags = source->next;
+		if (!c_strcmp(source->value.key.string, pattern) && !c_strcmp(flags->value.key.string, modifier)) {
+			if (former) {
+				former->next = flags->next;
+				if (list->value.list.last == flags)
+					list->value.list.last = former;
+				flags->next = list->value.list.first;
+				list->value.list.first = entry;
+			}
+			return entry;
+		}
+		former = flags;
+		entry = flags->next;
+	}
+	return C_NULL;
+}
+
+void fxInsertRegExpCacheEntry(txMachine* the, txSlot* regexp, txSlot* pattern, txSlot* modifier)
+{
+	txSlot* list = &mxRegExpCacheList;
+	txSlot* entry;
+	txSlot* source;
+	txSlot* flags;
+	txInteger count;
+	if (list->kind != XS_LIST_KIND)
+		return;
+	source = fxNewSlot(the);
+	mxPushClosure(source);
+	flags = fxNewSlot(the);
+	mxPushClosure(flags);
+	entry = fxNewSlot(the);
+	mxPop();
+	mxPop();
+	entry->kind = XS_REGEXP_KIND;
+	entry->value.regexp.code = regexp->value.regexp.code;
+	entry->value.regexp.data = C_NULL;
+	entry->next = source;
+	source->kind = (pattern->kind == XS_STRING_X_KIND) ? XS_KEY_X_KIND : XS_KEY_KIND;
+	source->value.key.string = pattern->value.string;
+	source->value.key.sum = 0;
+	source->next = flags;
+	flags->kind = (modifier->kind == XS_STRING_X_KIND) ? XS_KEY_X_KIND : XS_KEY_KIND;
+	flags->value.key.string = modifier->value.string;
+	flags->value.key.sum = 0;
+	flags->next = list->value.list.first;
+	list->value.list.first = entry;
+	if (!list->value.list.last)
+		list->value.list.last = flags;
+	count = 1;
+	while (flags->next) {
+		if (count == mxRegExpCache) {
+			flags->next = C_NULL;
+			list->value.list.last = flags;
+			break;
+		}
+		flags = flags->next->next->next;
+		count++;
+	}
+}
+#endif
 #endif
 
 void fxInitializeRegExp(txMachine* the) 
@@ -135,8 +213,24 @@ void fxInitializeRegExp(txMachine* the)
     key->kind = (mxArgv(0)->kind == XS_STRING_X_KIND) ? XS_KEY_X_KIND : XS_KEY_KIND;
     pattern = key->value.key.string = mxArgv(0)->value.string;
 	modifier = mxArgv(1)->value.string;
+#if mxRegExpCache
+	{
+		txSlot* entry = fxFindRegExpCacheEntry(the, pattern, modifier);
+		if (entry) {
+			regexp->value.regexp.data = fxNewChunk(the, fxMeasureRegExpData(entry->value.regexp.code));
+			regexp->value.regexp.code = entry->value.regexp.code;
+			the->regExpCacheHits++;
+			*mxResult = *mxThis;
+			return;
+		}
+		the->regExpCacheMisses++;
+	}
+#endif
 	if (!fxCompileRegExp(the, pattern, modifier, &regexp->value.regexp.code, &regexp->value.regexp.data, the->nameBuffer, sizeof(the->nameBuffer)))
 		mxSyntaxError("invalid regular expression: %s", the->nameBuffer);
+#if mxRegExpCache
+	fxInsertRegExpCacheEntry(the, regexp, mxArgv(0), mxArgv(1));
+#endif
 	*mxResult = *mxThis;
 #endif
 }
@@ -445,7 +539,7 @@ void fx_RegExp_prototype_exec(txMachine* the)
 	globalFlag = (flags & XS_REGEXP_G) ? 1 : 0;
 	namedFlag = (flags & XS_REGEXP_N) ? 1 : 0;
 	stickyFlag = (flags & XS_REGEXP_Y) ? 1 : 0;
-	offset = (globalFlag || stickyFlag) ? fxUnicodeToUTF8Offset(argument->value.string, lastIndex) : 0;
+	offset = (globalFlag || stickyFlag) ? fxGetStringOffset(the, argument, lastIndex) : 0;
 
 	if (fxMatchRegExp(the, regexp->value.regexp.code, regexp->value.regexp.data, argument->value.string, offset)) {
 		txSlot* resultArray;
@@ -460,7 +554,7 @@ void fx_RegExp_prototype_exec(txMachine* the)
 		txInteger index;
 		txInteger length;
 		if (globalFlag || stickyFlag) {
-			lastIndex = fxUTF8ToUnicodeOffset(argument->value.string, regexp->value.regexp.data[1]);
+			lastIndex = fxGetStringIndex(the, argument, regexp->value.regexp.data[1]);
 			mxPushInteger(lastIndex);
 			mxPushSlot(mxThis);
 			mxSetID(mxID(_lastIndex));
@@ -524,7 +618,7 @@ void fx_RegExp_prototype_exec(txMachine* the)
 		resultItem = resultItem->next = fxNewSlot(the);
 		resultItem->ID = mxID(_index);
 		resultItem->kind = XS_INTEGER_KIND;
-		resultItem->value.integer = fxUTF8ToUnicodeOffset(argument->value.string, regexp->value.regexp.data[0]);
+		resultItem->value.integer = fxGetStringIndex(the, argument, regexp->value.regexp.data[0]);
 		resultItem = resultItem->next = fxNewSlot(the);
 		resultItem->ID = mxID(_input);
 		resultItem->value.string = argument->value.string;
@@ -764,8 +858,8 @@ void fx_RegExp_prototype_replace(txMachine* the)
 	}
 	list = item = fxNewInstance(the);
 	mxPushSlot(list);
-	size = fxUnicodeLength(argument->value.string);
-	utf8Size = mxStringLength(argument->value.string);
+	size = fxGetStringLength(the, argument);
+	utf8Size = fxGetStringSize(the, argument);
 	former = 0;
 	for (;;) {
 		fxExecuteRegExp(the, mxThis, argument);
@@ -832,7 +926,7 @@ void fx_RegExp_prototype_replace(txMachine* the)
 				mxGetID(mxID(_groups));
 				if (!mxIsUndefined(the->stack))
 					fxToInstance(the, the->stack);
-				fxPushSubstitutionString(the, argument, utf8Size, fxUnicodeToUTF8Offset(argument->value.string, position), matched, mxStringLength(matched->value.string), i - 1, the->stack + 1, the->stack, replacement);
+				fxPushSubstitutionString(the, argument, utf8Size, fxGetStringOffset(the, argument, position), matched, mxStringLength(matched->value.string), i - 1, the->stack + 1, the->stack, replacement);
                 item = item->next = fxNewSlot(the);
                 mxPullSlot(item);
                 the->stack += 1 + i;			
@@ -969,7 +1063,7 @@ void fx_RegExp_prototype_split(txMachine* the)
 	item = fxLastProperty(the, array);
 	if (!limit)
 		goto bail;
-	size = fxUnicodeLength(argument->value.string);
+	size = fxGetStringLength(the, argument);
 	if (size == 0) {
 		fxExecuteRegExp(the, splitter, argument);
 		if (the->stack->kind == XS_NULL_KIND) {
@@ -1044,8 +1138,8 @@ bail:
 void fx_RegExp_prototype_split_aux(txMachine* the, txSlot* string, txIndex start, txIndex stop, txSlot* item)
 {
 #if mxRegExp
-	txInteger offset = fxUnicodeToUTF8Offset(string->value.string, start);
-	txInteger length = fxUnicodeToUTF8Offset(string->value.string + offset, stop - start);
+	txInteger offset = fxGetStringOffset(the, string, start);
+	txInteger length = fxGetStringOffset(the, string, stop) - offset;
 	if ((offset >= 0) && (length > 0)) {
 		item->value.string = (txString)fxNewChunk(the, length + 1);
 		c_memcpy(item->value.string, string->value.string + offset, length);
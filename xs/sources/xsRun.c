@@ -219,6 +219,9 @@ static txBoolean fxToNumericNumberBinary(txMachine* the, txSlot* a, txSlot* b, t
 		primitive = 0; \
 	}
 	
+#define mxArrayDense(ARRAY) \
+	((ARRAY)->value.array.address && ((((txChunk*)(((txByte*)((ARRAY)->value.array.address)) - sizeof(txChunk)))->size) / sizeof(txSlot) == (ARRAY)->value.array.length))
+
 #ifdef __ets__
 	#define mxUnalignedAccess 0
 #else
@@ -629,6 +632,8 @@ void fxRunID(txMachine* the, txSlot* generator, txInteger count)
 		&&XS_CODE_WITH,
 		&&XS_CODE_WITHOUT,
 		&&XS_CODE_YIELD,
+		&&XS_CODE_APPEND_LOCAL_1,
+		&&XS_CODE_APPEND_LOCAL_2,
 	};
 	register void * const *bytes = gxBytes;
 #endif
@@ -1555,6 +1560,9 @@ XS_CODE_JUMP:
 			if (variable->kind >= 0)
 				mxRunDebugID(XS_REFERENCE_ERROR, "set %s: already initialized", variable->ID);
 			variable->flag |= XS_DONT_SET_FLAG;
+		#if mxStringAppend
+			variable->flag &= ~(XS_STRING_OWNED_FLAG | XS_STRING_READ_FLAG);
+		#endif
 			variable->kind = mxStack->kind;
 			variable->value = mxStack->value;
 			mxBreak;
@@ -1603,6 +1611,36 @@ XS_CODE_JUMP:
 			#endif
 			if (variable->kind < 0)
 				mxRunDebugID(XS_REFERENCE_ERROR, "get %s: not initialized yet", variable->ID);
+		#if mxStringAppend
+			variable->flag &= ~(XS_STRING_OWNED_FLAG | XS_STRING_READ_FLAG);
+		#endif
+			mxPushKind(variable->kind);
+			mxStack->value = variable->value;
+			mxBreak;
+		mxCase(XS_CODE_APPEND_LOCAL_2)
+			index = mxRunU2(1);
+			mxNextCode(3);
+			goto XS_CODE_APPEND_LOCAL;
+		mxCase(XS_CODE_APPEND_LOCAL_1)
+			index = mxRunU1(1);
+			mxNextCode(2);
+		XS_CODE_APPEND_LOCAL:
+#ifdef mxTrace
+			if (gxDoTrace) fxTraceIndex(the, index - 1);
+#endif
+			variable = mxEnvironment - index;
+			#ifdef mxDebug
+				offset = variable->ID;
+			#endif
+			if (variable->kind < 0)
+				mxRunDebugID(XS_REFERENCE_ERROR, "get %s: not initialized yet", variable->ID);
+		#if mxStringAppend
+			/* the pushed copy is the left operand of the ADD that precedes PULL_LOCAL, so an owned string can be appended in place */
+			if (variable->flag & XS_STRING_OWNED_FLAG)
+				variable->flag = (variable->flag & ~XS_STRING_OWNED_FLAG) | XS_STRING_READ_FLAG;
+			else
+				variable->flag &= ~XS_STRING_READ_FLAG;
+		#endif
 			mxPushKind(variable->kind);
 			mxStack->value = variable->value;
 			mxBreak;
@@ -1635,6 +1673,9 @@ XS_CODE_JUMP:
 			if (gxDoTrace) fxTraceIndex(the, index - 1);
 #endif
 			variable = mxEnvironment - index;
+		#if mxStringAppend
+			variable->flag &= ~(XS_STRING_OWNED_FLAG | XS_STRING_READ_FLAG);
+		#endif
 			variable->kind = mxStack->kind;
 			variable->value = mxStack->value;
 			mxBreak;
@@ -1730,6 +1771,9 @@ XS_CODE_JUMP:
 				mxRunDebugID(XS_REFERENCE_ERROR, "set %s: not initialized yet", variable->ID);
 			if (variable->flag & XS_DONT_SET_FLAG)
 				mxRunDebugID(XS_TYPE_ERROR, "set %s: const", variable->ID);
+		#if mxStringAppend
+			variable->flag &= ~(XS_STRING_OWNED_FLAG | XS_STRING_READ_FLAG);
+		#endif
 			variable->kind = mxStack->kind;
 			variable->value = mxStack->value;
 			mxStack++;
@@ -1866,6 +1910,9 @@ XS_CODE_JUMP:
 				mxRunDebugID(XS_REFERENCE_ERROR, "set %s: not initialized yet", variable->ID);
 			if (variable->flag & XS_DONT_SET_FLAG)
 				mxRunDebugID(XS_TYPE_ERROR, "set %s: const", variable->ID);
+		#if mxStringAppend
+			variable->flag &= ~(XS_STRING_OWNED_FLAG | XS_STRING_READ_FLAG);
+		#endif
 			variable->kind = mxStack->kind;
 			variable->value = mxStack->value;
 			mxBreak;
@@ -1897,6 +1944,9 @@ XS_CODE_JUMP:
 			if (gxDoTrace) fxTraceIndex(the, index - 1);
 #endif
 			variable = mxEnvironment - index;
+		#if mxStringAppend
+			variable->flag &= ~(XS_STRING_OWNED_FLAG | XS_STRING_READ_FLAG);
+		#endif
 			variable->kind = mxStack->kind;
 			variable->value = mxStack->value;
 			mxBreak;
@@ -1990,6 +2040,9 @@ XS_CODE_JUMP:
 			mxRestoreState;
 			variable = mxEnvironment - index;
 			offset = slot->ID = variable->ID;
+		#if mxStringAppend
+			variable->flag &= ~(XS_STRING_OWNED_FLAG | XS_STRING_READ_FLAG);
+		#endif
             slot->flag = variable->flag;
             slot->kind = variable->kind;
 			slot->value = variable->value;
@@ -2076,10 +2129,7 @@ XS_CODE_JUMP:
 				else {
 					txID id;
 					mxSaveState;
-					if (mxStack->kind == XS_STRING_X_KIND)
-						id = fxNewNameX(the, mxStack->value.string);
-					else
-						id = fxNewName(the, mxStack);
+					id = fxNewCollectableName(the, mxStack);
 					mxRestoreState;
 					mxStack->kind = XS_AT_KIND;
 					mxStack->value.at.id = id;
@@ -2198,11 +2248,42 @@ XS_CODE_JUMP:
 			index = mxStack->value.at.index;
 			mxStack++;
 			mxNextCode(1);
+#if mxIndexFastPath
+			if ((offset == XS_NO_ID) && (variable->flag & XS_EXOTIC_FLAG)) {
+				slot = variable->next;
+				if (slot->ID == XS_ARRAY_BEHAVIOR) {
+					if (variable->ID && the->aliasArray[variable->ID])
+						slot = the->aliasArray[variable->ID]->next;
+					if ((index < slot->value.array.length) && mxArrayDense(slot)) {
+						slot = slot->value.array.address + index;
+						goto XS_CODE_GET_ALL;
+					}
+				}
+				else if (slot->ID == XS_TYPED_ARRAY_BEHAVIOR) {
+					txTypeDispatch* dispatch = slot->value.typedArray.dispatch;
+					txSlot* view = slot->next;
+					txSlot* data = view->next->value.reference->next;
+					if (data->value.arrayBuffer.address && (index < (txIndex)(view->value.dataView.size >> dispatch->shift))) {
+						mxSaveState;
+						(*dispatch->getter)(the, data, view->value.dataView.offset + (index << dispatch->shift), mxStack, EndianNative);
+						mxRestoreState;
+						mxBreak;
+					}
+				}
+			}
+#endif
 			goto XS_CODE_GET_PROPERTY_ALL;
 		mxCase(XS_CODE_GET_PROPERTY)
 			mxToInstance(mxStack);
 			offset = mxRunID(1);
 			index = 0;
+#if mxPropertyCache
+			if (!primitive) {
+				slot = fxGetCachedProperty(the, mxCode, variable, (txID)offset);
+				mxNextCode(1 + sizeof(txID));
+				goto XS_CODE_GET_ALL;
+			}
+#endif
 			mxNextCode(1 + sizeof(txID));
 			/* continue */
 		XS_CODE_GET_PROPERTY_ALL:	
@@ -2368,11 +2449,48 @@ XS_CODE_JUMP:
 			*(mxStack + 1) = *mxStack;
 			mxStack++;
 			mxNextCode(1);
+#if mxIndexFastPath
+			if ((offset == XS_NO_ID) && (variable->flag & XS_EXOTIC_FLAG)) {
+				slot = variable->next;
+				if (slot->ID == XS_ARRAY_BEHAVIOR) {
+					if (!variable->ID && (index < slot->value.array.length) && mxArrayDense(slot)) {
+						slot = slot->value.array.address + index;
+						goto XS_CODE_SET_ALL;
+					}
+				}
+				else if (slot->ID == XS_TYPED_ARRAY_BEHAVIOR) {
+					/* coercing numbers cannot run code, so the buffer cannot be detached or resized meanwhile */
+					if ((mxStack->kind == XS_INTEGER_KIND) || (mxStack->kind == XS_NUMBER_KIND)) {
+						txTypeDispatch* dispatch = slot->value.typedArray.dispatch;
+						txSlot* view = slot->next;
+						txSlot* data = view->next->value.reference->next;
+						if (data->value.arrayBuffer.address && !(data->flag & XS_MARK_FLAG) && (index < (txIndex)(view->value.dataView.size >> dispatch->shift))) {
+							scratch.kind = mxStack->kind;
+							scratch.value = mxStack->value;
+							mxSaveState;
+							(*dispatch->coerce)(the, &scratch);
+							(*dispatch->setter)(the, data, view->value.dataView.offset + (index << dispatch->shift), &scratch, EndianNative);
+							mxRestoreState;
+							goto XS_CODE_SET_SKIP;
+						}
+					}
+				}
+			}
+#endif
 			goto XS_CODE_SET_PROPERTY_ALL;
 		mxCase(XS_CODE_SET_PROPERTY)
 			mxToInstance(mxStack + 1);
 			offset = mxRunID(1);
 			index = 0;
+#if mxPropertyCache
+			if (!primitive) {
+				mxSaveState;
+				slot = fxSetCachedProperty(the, mxCode, variable, (txID)offset);
+				mxRestoreState;
+				mxNextCode(1 + sizeof(txID));
+				goto XS_CODE_SET_ALL;
+			}
+#endif
 			mxNextCode(1 + sizeof(txID));
 			/* continue */
 		XS_CODE_SET_PROPERTY_ALL:	
@@ -3210,6 +3328,17 @@ XS_CODE_JUMP:
 				if ((slot->kind == XS_STRING_KIND) || (slot->kind == XS_STRING_X_KIND) || (mxStack->kind == XS_STRING_KIND) || (mxStack->kind == XS_STRING_X_KIND)) {
 					fxToString(the, slot);
 					fxToString(the, mxStack);
+				#if mxStringAppend
+					if ((mxRunU1(1) == XS_CODE_PULL_LOCAL_1) || (mxRunU1(1) == XS_CODE_PULL_LOCAL_2)) {
+						index = (mxRunU1(1) == XS_CODE_PULL_LOCAL_1) ? mxRunU1(2) : mxRunU2(2);
+						if (fxAppendString(the, mxEnvironment - index, slot, mxStack)) {
+							mxRestoreState;
+							mxStack += 2;
+							mxNextCode((mxRunU1(1) == XS_CODE_PULL_LOCAL_1) ? 3 : 4);
+							mxBreak;
+						}
+					}
+				#endif
 					fxConcatString(the, slot, mxStack);
 				}
 				else {
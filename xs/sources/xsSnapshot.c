@@ -36,6 +36,7 @@ static txTypeDispatch* fxProjectTypeDispatch(txMachine* the, txTypeDispatch* dis
 static void fxReadAtom(txMachine* the, txSnapshot* snapshot, Atom* atom, txString type);
 static void fxReadSlot(txMachine* the, txSnapshot* snapshot, txSlot* slot, txFlag flag);
 static void fxReadSlotArray(txMachine* the, txSnapshot* snapshot, txSlot* address, txSize length);
+static void fxReadSlotEntries(txMachine* the, txSnapshot* snapshot, txHashEntry* address, txSize length);
 static void fxReadSlotTable(txMachine* the, txSnapshot* snapshot, txSlot** address, txSize length);
 
 #define mxUnprojectChunk(ADDRESS) (snapshot->firstChunk + ((size_t)ADDRESS));
@@ -46,10 +47,12 @@ static void fxUnprojectTable(txMachine* the, txSnapshot* snapshot, txSlot* table
 static void fxWriteChunk(txMachine* the, txSnapshot* snapshot, txSlot* slot);
 static void fxWriteChunkArray(txMachine* the, txSnapshot* snapshot, txSlot* address, txSize length);
 static void fxWriteChunkData(txMachine* the, txSnapshot* snapshot, void* address);
+static void fxWriteChunkEntries(txMachine* the, txSnapshot* snapshot, txHashEntry* address, txSize length);
 static void fxWriteChunkTable(txMachine* the, txSnapshot* snapshot, txSlot** address, txSize length);
 static void fxWriteChunkZero(txMachine* the, txSnapshot* snapshot, txSize size);
 static void fxWriteChunks(txMachine* the, txSnapshot* snapshot);
 static void fxWriteSlot(txMachine* the, txSnapshot* snapshot, txSlot* slot, txFlag flag);
+static void fxWriteSlotEntries(txMachine* the, txSnapshot* snapshot, txHashEntry* address, txSize length);
 static void fxWriteSlotTable(txMachine* the, txSnapshot* snapshot, txSlot** address, txSize length);
 static void fxWriteSlots(txMachine* the, txSnapshot* snapshot);
 static void fxWriteStack(txMachine* the, txSnapshot* snapshot);
@@ -57,7 +60,7 @@ static void fxWriteStack(txMachine* the, txSnapshot* snapshot);
 #define mxAssert(_ASSERTION,...) { if (!(_ASSERTION)) { fxReport(the, __VA_ARGS__); snapshot->error = C_EINVAL; fxJump(the); } }
 #define mxThrowIf(_ERROR) { if (_ERROR) { snapshot->error = _ERROR; fxJump(the); } }
 
-#define mxCallbacksLength 474
+#define mxCallbacksLength 477
 static txCallback gxCallbacks[mxCallbacksLength] = {
 	fx_AggregateError,
 	fx_Array_from,
@@ -243,6 +246,9 @@ static txCallback gxCallbacks[mxCallbacksLength] = {
 	fx_isNaN,
 	fx_Iterator_iterator,
 	fx_JSON_parse,
+	fx_JSON_parser,
+	fx_JSON_parser_close,
+	fx_JSON_parser_push,
 	fx_JSON_stringify,
 	fx_Map_prototype_clear,
 	fx_Map_prototype_delete,
@@ -681,40 +687,21 @@ txSlot* fxProjectSlot(txMachine* the, txProjection* firstProjection, txSlot* slo
 
 void fxProjectTable(txMachine* the, txSnapshot* snapshot, txSlot* table) 
 {
-	txSlot* first = C_NULL;
-	txSlot** last = &first;
-	txSlot** address = table->value.table.address;
-	txSize length = table->value.table.length;
-	txU4 modulo;
-	while (length > 0) {
-		txSlot* slot = *address;
-		if (slot) {
-			*last = slot;
-			last = &slot->next;
-			while ((slot = *last)) {
-				last = &slot->next;
+	txSlot* list = table->next;
+	txSlot* slot = list->value.list.first;
+	c_memset(table->value.table.address, 0, table->value.table.length * sizeof(txHashEntry));
+	while (slot) {
+		if (!(slot->flag & XS_DONT_ENUM_FLAG)) {
+			if (slot->kind == XS_REFERENCE_KIND) {
+				txSlot buffer;
+				buffer.kind = XS_REFERENCE_KIND;
+				buffer.value.reference = fxProjectSlot(the, snapshot->firstProjection, slot->value.reference);
+				fxIndexEntry(the, table, slot, fxSumEntry(the, &buffer));
 			}
+			else
+				fxIndexEntry(the, table, slot, fxSumEntry(the, slot));
 		}
-		address++;
-		length--;
-	}
-	address = table->value.table.address;
-	length = table->value.table.length;
-	c_memset(address, 0, length * sizeof(txSlot*));
-	while (first) {
-		txSlot* slot = first->value.entry.slot;
-		if (slot->kind == XS_REFERENCE_KIND) {
-			txSlot buffer;
-			buffer.kind = XS_REFERENCE_KIND;
-			buffer.value.reference = fxProjectSlot(the, snapshot->firstProjection, slot->value.reference);
-			first->value.entry.sum = fxSumEntry(the, &buffer);
-		}
-		modulo = first->value.entry.sum % length;
-		slot = first->next;
-		first->next = C_NULL;
-		first->next = *(address + modulo);
-		*(address + modulo) = first;
-		first = slot;
+		slot = (table->kind == XS_MAP_KIND) ? slot->next->next : slot->next;
 	}
 }
 
@@ -946,10 +933,13 @@ void fxReadSlot(txMachine* the, txSnapshot* snapshot, txSlot* slot, txFlag flag)
 		slot->value.typedArray.atomics = (txTypeAtomics*)&gxTypeAtomics[(size_t)slot->value.typedArray.atomics];
 		break;
 	case XS_GLOBAL_KIND:
+		slot->value.table.address = (txSlot**)mxUnprojectChunk(slot->value.table.address);
+		fxReadSlotTable(the, snapshot, slot->value.table.address, slot->value.table.length);
+		break;
 	case XS_MAP_KIND:
 	case XS_SET_KIND:
 		slot->value.table.address = (txSlot**)mxUnprojectChunk(slot->value.table.address);
-		fxReadSlotTable(the, snapshot, slot->value.table.address, slot->value.table.length);
+		fxReadSlotEntries(the, snapshot, mxTableEntries(slot), slot->value.table.length);
 		break;
 		
 	case XS_WEAK_MAP_KIND:
@@ -1029,6 +1019,15 @@ void fxReadSlotArray(txMachine* the, txSnapshot* snapshot, txSlot* address, txSi
 	}
 }
 
+void fxReadSlotEntries(txMachine* the, txSnapshot* snapshot, txHashEntry* address, txSize length)
+{
+	while (length > 0) {
+		address->slot = fxUnprojectSlot(the, snapshot, address->slot);
+		address++;
+		length--;
+	}
+}
+
 void fxReadSlotTable(txMachine* the, txSnapshot* snapshot, txSlot** address, txSize length)
 {
 	while (length > 0) {
@@ -1059,36 +1058,13 @@ txSlot* fxUnprojectSlot(txMachine* the, txSnapshot* snapshot, txSlot* slot)
 
 void fxUnprojectTable(txMachine* the, txSnapshot* snapshot, txSlot* table) 
 {
-	txSlot* first = C_NULL;
-	txSlot** last = &first;
-	txSlot** address = table->value.table.address;
-	txSize length = table->value.table.length;
-	txU4 modulo;
-	while (length > 0) {
-		txSlot* slot = *address;
-		if (slot) {
-			*last = slot;
-			last = &slot->next;
-			while ((slot = *last)) {
-				last = &slot->next;
-			}
-		}
-		address++;
-		length--;
-	}
-	address = table->value.table.address;
-	length = table->value.table.length;
-	c_memset(address, 0, length * sizeof(txSlot*));
-	while (first) {
-		txSlot* slot = first->value.entry.slot;
-		if (slot->kind == XS_REFERENCE_KIND)
-			first->value.entry.sum = fxSumEntry(the, slot);
-		modulo = first->value.entry.sum % length;
-		slot = first->next;
-		first->next = C_NULL;
-		first->next = *(address + modulo);
-		*(address + modulo) = first;
-		first = slot;
+	txSlot* list = table->next;
+	txSlot* slot = list->value.list.first;
+	c_memset(table->value.table.address, 0, table->value.table.length * sizeof(txHashEntry));
+	while (slot) {
+		if (!(slot->flag & XS_DONT_ENUM_FLAG))
+			fxIndexEntry(the, table, slot, fxSumEntry(the, slot));
+		slot = (table->kind == XS_MAP_KIND) ? slot->next->next : slot->next;
 	}
 }
 
@@ -1128,9 +1104,11 @@ void fxWriteChunk(txMachine* the, txSnapshot* snapshot, txSlot* slot)
 			fxWriteChunkData(the, snapshot, slot->value.key.string);
 		break;
 	case XS_GLOBAL_KIND:
+		fxWriteChunkTable(the, snapshot, slot->value.table.address, slot->value.table.length);
+		break;
 	case XS_MAP_KIND:
 	case XS_SET_KIND:
-		fxWriteChunkTable(the, snapshot, slot->value.table.address, slot->value.table.length);
+		fxWriteChunkEntries(the, snapshot, mxTableEntries(slot), slot->value.table.length);
 		break;
 		
 	case XS_HOST_KIND:
@@ -1172,6 +1150,17 @@ void fxWriteChunkData(txMachine* the, txSnapshot* snapshot, void* address)
 	chunk->temporary = temporary;
 }
 
+void fxWriteChunkEntries(txMachine* the, txSnapshot* snapshot, txHashEntry* address, txSize length)
+{
+	txChunk* chunk = (txChunk*)(((txByte*)(address)) - sizeof(txChunk));
+	txByte* temporary = chunk->temporary;
+	chunk->temporary = C_NULL;
+	mxThrowIf((*snapshot->write)(snapshot->stream, chunk, sizeof(txChunk)));
+	chunk->temporary = temporary;
+	fxWriteSlotEntries(the, snapshot, address, length + 1);
+	fxWriteChunkZero(the, snapshot, chunk->size - sizeof(txChunk) - mxTableSize(length));
+}
+
 void fxWriteChunkTable(txMachine* the, txSnapshot* snapshot, txSlot** address, txSize length)
 {
 	txChunk* chunk = (txChunk*)(((txByte*)(address)) - sizeof(txChunk));
@@ -1389,6 +1378,19 @@ void fxWriteSlot(txMachine* the, txSnapshot* snapshot, txSlot* slot, txFlag flag
 	mxThrowIf((*snapshot->write)(snapshot->stream, &buffer, sizeof(buffer)));
 }
 
+void fxWriteSlotEntries(txMachine* the, txSnapshot* snapshot, txHashEntry* address, txSize length)
+{
+	txHashEntry buffer;
+	c_memset(&buffer, 0, sizeof(txHashEntry));
+	while (length > 0) {
+		buffer.slot = fxProjectSlot(the, snapshot->firstProjection, address->slot);
+		buffer.sum = address->sum;
+		mxThrowIf((*snapshot->write)(snapshot->stream, &buffer, sizeof(txHashEntry)));
+		address++;
+		length--;
+	}
+}
+
 void fxWriteSlotTable(txMachine* the, txSnapshot* snapshot, txSlot** address, txSize length)
 {
 	while (length > 0) {
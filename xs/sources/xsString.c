@@ -160,10 +160,159 @@ txSlot* fxNewStringInstance(txMachine* the)
 	instance = fxNewObjectInstance(the);
 	instance->flag |= XS_EXOTIC_FLAG;
 	property = fxNextSlotProperty(the, instance, &mxEmptyString, XS_STRING_BEHAVIOR, XS_INTERNAL_FLAG | XS_GET_ONLY);
-	property->value.key.sum = 0;	
+	property->value.key.sum = 0;
 	return instance;
 }
 
+#if mxStringCache
+void fxCacheStringSize(txMachine* the, txString string, txSize size, txSize length)
+{
+	txStringCacheEntry* entry = the->stringCache + (((((size_t)string) >> 3) ^ (((size_t)string) >> 11)) & (mxStringCacheCount - 1));
+	entry->string = string;
+	entry->size = size;
+	entry->length = length;
+	entry->flag = (length >= 0) ? XS_STRING_SIZE_FLAG | XS_STRING_LENGTH_FLAG : XS_STRING_SIZE_FLAG;
+}
+
+txStringCacheEntry* fxFindStringCacheEntry(txMachine* the, txSlot* slot)
+{
+	txString string = slot->value.string;
+	txStringCacheEntry* entry;
+	/* only chunks are cached: the memory of other strings can be reused behind the back of the collector */
+	if (slot->kind != XS_STRING_KIND)
+		return C_NULL;
+	entry = the->stringCache + (((((size_t)string) >> 3) ^ (((size_t)string) >> 11)) & (mxStringCacheCount - 1));
+	if (entry->string != string) {
+		entry->string = string;
+		entry->flag = 0;
+	}
+	return entry;
+}
+
+void fxInvalidateStringCache(txMachine* the)
+{
+	c_memset(the->stringCache, 0, mxStringCacheCount * sizeof(txStringCacheEntry));
+}
+
+void fxInvalidateStringCacheEntry(txMachine* the, txString string)
+{
+	txStringCacheEntry* entry = the->stringCache + (((((size_t)string) >> 3) ^ (((size_t)string) >> 11)) & (mxStringCacheCount - 1));
+	if (entry->string == string)
+		entry->string = C_NULL;
+}
+#endif
+
+txSize fxGetStringIndex(txMachine* the, txSlot* slot, txSize offset)
+{
+#if mxStringCache
+	txStringCacheEntry* entry = fxFindStringCacheEntry(the, slot);
+	if (entry) {
+		txU1* string = (txU1*)slot->value.string;
+		txU1* p;
+		txU1* q;
+		txSize size = fxGetStringSize(the, slot);
+		txSize length = fxGetStringLength(the, slot);
+		txSize index;
+		if ((offset < 0) || (offset > size))
+			return -1;
+		if (length == size)
+			return offset;
+		if (((c_read8(string + offset) & 0xC0) == 0x80))
+			return -1;
+		if ((entry->flag & XS_STRING_CRUMB_FLAG) && (entry->crumbOffset <= offset)) {
+			p = string + entry->crumbOffset;
+			index = entry->crumbIndex;
+		}
+		else {
+			p = string;
+			index = 0;
+		}
+		q = string + offset;
+		while (p < q) {
+			if ((c_read8(++p) & 0xC0) != 0x80)
+				index++;
+		}
+		entry->crumbIndex = index;
+		entry->crumbOffset = offset;
+		entry->flag |= XS_STRING_CRUMB_FLAG;
+		return index;
+	}
+#endif
+	return fxUTF8ToUnicodeOffset(slot->value.string, offset);
+}
+
+txSize fxGetStringLength(txMachine* the, txSlot* slot)
+{
+#if mxStringCache
+	txStringCacheEntry* entry = fxFindStringCacheEntry(the, slot);
+	if (entry) {
+		if (!(entry->flag & XS_STRING_LENGTH_FLAG)) {
+			entry->length = fxUnicodeLength(slot->value.string);
+			entry->flag |= XS_STRING_LENGTH_FLAG;
+		}
+		return entry->length;
+	}
+#endif
+	return fxUnicodeLength(slot->value.string);
+}
+
+txSize fxGetStringOffset(txMachine* the, txSlot* slot, txSize index)
+{
+#if mxStringCache
+	txStringCacheEntry* entry = fxFindStringCacheEntry(the, slot);
+	if (entry) {
+		txU1* string = (txU1*)slot->value.string;
+		txU1* p;
+		txSize size = fxGetStringSize(the, slot);
+		txSize length = fxGetStringLength(the, slot);
+		txSize current;
+		if ((index < 0) || (index > length))
+			return -1;
+		if (length == size)
+			return index;
+		/* walk from the breadcrumb left by the previous access, or from the start if it is nearer */
+		if ((entry->flag & XS_STRING_CRUMB_FLAG) && ((index >= entry->crumbIndex) || ((entry->crumbIndex - index) < index))) {
+			p = string + entry->crumbOffset;
+			current = entry->crumbIndex;
+		}
+		else {
+			p = string;
+			current = 0;
+		}
+		while (current < index) {
+			while ((c_read8(++p) & 0xC0) == 0x80)
+				;
+			current++;
+		}
+		while (current > index) {
+			while ((c_read8(--p) & 0xC0) == 0x80)
+				;
+			current--;
+		}
+		entry->crumbIndex = index;
+		entry->crumbOffset = (txSize)(p - string);
+		entry->flag |= XS_STRING_CRUMB_FLAG;
+		return entry->crumbOffset;
+	}
+#endif
+	return fxUnicodeToUTF8Offset(slot->value.string, index);
+}
+
+txSize fxGetStringSize(txMachine* the, txSlot* slot)
+{
+#if mxStringCache
+	txStringCacheEntry* entry = fxFindStringCacheEntry(the, slot);
+	if (entry) {
+		if (!(entry->flag & XS_STRING_SIZE_FLAG)) {
+			entry->size = mxStringLength(slot->value.string);
+			entry->flag |= XS_STRING_SIZE_FLAG;
+		}
+		return entry->size;
+	}
+#endif
+	return mxStringLength(slot->value.string);
+}
+
 void fxStringAccessorGetter(txMachine* the)
 {
 	txSlot* string;
@@ -183,9 +332,9 @@ void fxStringAccessorGetter(txMachine* the)
 		mxResult->kind = XS_INTEGER_KIND;
 	}
 	else {
-		txInteger from = fxUnicodeToUTF8Offset(string->value.key.string, index);
+		txInteger from = fxGetStringOffset(the, string, index);
 		if (from >= 0) {
-			txInteger to = fxUnicodeToUTF8Offset(string->value.key.string, index + 1);
+			txInteger to = fxGetStringOffset(the, string, index + 1);
 			if (to >= 0) {
 				mxResult->value.string = fxNewChunk(the, to - from + 1);
 				c_memcpy(mxResult->value.string, string->value.key.string + from, to - from);
@@ -226,8 +375,8 @@ txBoolean fxStringGetOwnProperty(txMachine* the, txSlot* instance, txID id, txIn
 	}
 	if (!id && (mxStringInstanceLength(instance) > index)) {
 		txSlot* string = instance->next;
-		txInteger from = fxUnicodeToUTF8Offset(string->value.key.string, index);
-		txInteger to = fxUnicodeToUTF8Offset(string->value.key.string, index + 1);
+		txInteger from = fxGetStringOffset(the, string, index);
+		txInteger to = fxGetStringOffset(the, string, index + 1);
 		descriptor->value.string = fxNewChunk(the, to - from + 1);
 		c_memcpy(descriptor->value.string, string->value.key.string + from, to - from);
 		descriptor->value.string[to - from] = 0;
@@ -305,7 +454,7 @@ void fx_String(txMachine* the)
 	instance = fxNewStringInstance(the);
 	instance->next->kind = slot->kind; // @@
 	instance->next->value.key.string = slot->value.string;
-	instance->next->value.key.sum = fxUnicodeLength(slot->value.string);	
+	instance->next->value.key.sum = fxGetStringLength(the, slot);
 	mxPullSlot(mxResult);
 }
 
@@ -538,17 +687,18 @@ void fx_String_raw(txMachine* the)
 
 void fx_String_prototype_at(txMachine* the)
 {
-	txString string = fxCoerceToString(the, mxThis);
-	txNumber length = fxUnicodeLength(string);
-	txNumber index = (mxArgc > 0) ? c_trunc(fxToNumber(the, mxArgv(0))) : C_NAN;
+	txNumber length, index;
+	fxCoerceToString(the, mxThis);
+	length = fxGetStringLength(the, mxThis);
+	index = (mxArgc > 0) ? c_trunc(fxToNumber(the, mxArgv(0))) : C_NAN;
 	if (c_isnan(index) || (index == 0))
 		index = 0;
 	if (index < 0)
 		index = length + index;
 	if ((0 <= index) && (index < length)) {
-		txInteger from = fxUnicodeToUTF8Offset(string, (txIndex)index);
+		txInteger from = fxGetStringOffset(the, mxThis, (txIndex)index);
 		if (from >= 0) {
-			txInteger to = fxUnicodeToUTF8Offset(string, (txIndex)(index + 1));
+			txInteger to = fxGetStringOffset(the, mxThis, (txIndex)(index + 1));
 			if (to >= 0) {
 				mxResult->value.string = fxNewChunk(the, to - from + 1);
 				c_memcpy(mxResult->value.string, fxToString(the, mxThis) + from, to - from);
@@ -573,7 +723,7 @@ void fx_String_prototype_charAt(txMachine* the)
 	else
 		anOffset = 0;
 
-	anOffset = fxUnicodeToUTF8Offset(aString, anOffset);
+	anOffset = fxGetStringOffset(the, mxThis, anOffset);
 	if (anOffset < 0) goto fail;
 
 	aLength = fxUnicodeToUTF8Offset(aString + anOffset, 1);
@@ -603,7 +753,7 @@ void fx_String_prototype_charCodeAt(txMachine* the)
 	else
 		anOffset = 0;
 
-	anOffset = fxUnicodeToUTF8Offset(aString, anOffset);
+	anOffset = fxGetStringOffset(the, mxThis, anOffset);
 	if (anOffset < 0) goto fail;
 
 	if (fxUnicodeToUTF8Offset(aString + anOffset, 1) < 0)
@@ -627,12 +777,12 @@ void fx_String_prototype_compare(txMachine* the)
 void fx_String_prototype_codePointAt(txMachine* the)
 {
 	txString string = fxCoerceToString(the, mxThis);
-	txInteger length = fxUnicodeLength(string);
+	txInteger length = fxGetStringLength(the, mxThis);
 	txNumber at = (mxArgc > 0) ? fxToNumber(the, mxArgv(0)) : 0;
 	if (c_isnan(at))
 		at = 0;
 	if ((0 <= at) && (at < (txNumber)length)) {
-		txInteger offset = fxUnicodeToUTF8Offset(string, (txInteger)at);
+		txInteger offset = fxGetStringOffset(the, mxThis, (txInteger)at);
 		length = fxUnicodeToUTF8Offset(string + offset, 1);
 		if ((offset >= 0) && (length > 0)) {
 			fxUTF8Decode(string + offset, &mxResult->value.integer);
@@ -662,7 +812,7 @@ void fx_String_prototype_concat(txMachine* the)
 void fx_String_prototype_endsWith(txMachine* the)
 {
 	txString string = fxCoerceToString(the, mxThis);
-	txInteger length = fxUnicodeLength(string);
+	txInteger length = fxGetStringLength(the, mxThis);
 	txString searchString;
 	txInteger searchLength;
 	txInteger offset;
@@ -674,7 +824,7 @@ void fx_String_prototype_endsWith(txMachine* the)
 		mxTypeError("future editions");
 	searchString = fxToString(the, mxArgv(0));
 	searchLength = mxStringLength(searchString);
-	offset = fxUnicodeToUTF8Offset(string, fxArgToPosition(the, 1, length, length));
+	offset = fxGetStringOffset(the, mxThis, fxArgToPosition(the, 1, length, length));
 	if (offset < searchLength)
 		return;
 	if (!c_strncmp(string + offset - searchLength, searchString, searchLength))
@@ -684,7 +834,7 @@ void fx_String_prototype_endsWith(txMachine* the)
 void fx_String_prototype_includes(txMachine* the)
 {
 	txString string = fxCoerceToString(the, mxThis);
-	txInteger length = mxStringLength(string);
+	txInteger length = fxGetStringSize(the, mxThis);
 	txString searchString;
 	txInteger searchLength;
 	txInteger offset;
@@ -696,7 +846,7 @@ void fx_String_prototype_includes(txMachine* the)
 		mxTypeError("future editions");
 	searchString = fxToString(the, mxArgv(0));
 	searchLength = mxStringLength(searchString);
-	offset = fxUnicodeToUTF8Offset(string, fxArgToPosition(the, 1, 0, fxUnicodeLength(string)));
+	offset = fxGetStringOffset(the, mxThis, fxArgToPosition(the, 1, 0, fxGetStringLength(the, mxThis)));
 	if ((length - offset) < searchLength)
 		return;
 	if (c_strstr(string + offset, searchString))
@@ -722,15 +872,15 @@ void fx_String_prototype_indexOf(txMachine* the)
 		return;
 	}
 	aSubString = fxToString(the, mxArgv(0));
-	aLength = fxUnicodeLength(aString);
-	aSubLength = fxUnicodeLength(aSubString);
+	aLength = fxGetStringLength(the, mxThis);
+	aSubLength = fxGetStringLength(the, mxArgv(0));
 	anOffset = 0;
 	if ((mxArgc > 1) && (mxArgv(1)->kind != XS_UNDEFINED_KIND)) {
 		aNumber = fxToNumber(the, mxArgv(1));
 		anOffset = (c_isnan(aNumber)) ? 0 : (aNumber < 0) ? 0 : (aNumber > aLength) ? aLength : (txInteger)c_floor(aNumber);
 	}
 	if (anOffset + aSubLength <= aLength) {
-		anOffset = fxUnicodeToUTF8Offset(aString, anOffset);
+		anOffset = fxGetStringOffset(the, mxThis, anOffset);
 		aLimit = mxStringLength(aString) - mxStringLength(aSubString);
 		while (anOffset <= aLimit) {
 			p = aString + anOffset;
@@ -745,7 +895,7 @@ void fx_String_prototype_indexOf(txMachine* the)
 				break;
 		}
 		if (anOffset <= aLimit)
-			anOffset = fxUTF8ToUnicodeOffset(aString, anOffset);
+			anOffset = fxGetStringIndex(the, mxThis, anOffset);
 		else
 			anOffset = -1;
 	}
@@ -799,8 +949,8 @@ void fx_String_prototype_lastIndexOf(txMachine* the)
 		return;
 	}
 	aSubString = fxToString(the, mxArgv(0));
-	aLength = fxUnicodeLength(aString);
-	aSubLength = fxUnicodeLength(aSubString);
+	aLength = fxGetStringLength(the, mxThis);
+	aSubLength = fxGetStringLength(the, mxArgv(0));
 	anOffset = aLength;
 	if ((mxArgc > 1) && (mxArgv(1)->kind != XS_UNDEFINED_KIND)) {
 		aNumber = fxToNumber(the, mxArgv(1));
@@ -810,7 +960,7 @@ void fx_String_prototype_lastIndexOf(txMachine* the)
 			anOffset = aLength;
 	}
 	if (anOffset - aSubLength >= 0) {
-		anOffset = fxUnicodeToUTF8Offset(aString, anOffset - aSubLength);
+		anOffset = fxGetStringOffset(the, mxThis, anOffset - aSubLength);
 		while (anOffset >= 0) {
 			p = aString + anOffset;
 			q = aSubString;
@@ -823,7 +973,7 @@ void fx_String_prototype_lastIndexOf(txMachine* the)
 			else
 				break;
 		}		
-		anOffset = fxUTF8ToUnicodeOffset(aString, anOffset);
+		anOffset = fxGetStringIndex(the, mxThis, anOffset);
 	}
 	else
 		anOffset = -1;
@@ -864,7 +1014,7 @@ void fx_String_prototype_normalize(txMachine* the)
 	txString result = mxEmptyString.value.string;
 	#if (mxWindows && (WINVER >= 0x0600))
 	txString string = fxCoerceToString(the, mxThis);
-	txInteger stringLength = mxStringLength(string);
+	txInteger stringLength = fxGetStringSize(the, mxThis);
 	{
 		NORM_FORM form;
 		txInteger unicodeLength;
@@ -910,7 +1060,7 @@ void fx_String_prototype_normalize(txMachine* the)
 	}
 	#elif (mxMacOSX || mxiOS)
 	txString string = fxCoerceToString(the, mxThis);
-	txInteger stringLength = mxStringLength(string);
+	txInteger stringLength = fxGetStringSize(the, mxThis);
 	{
 		CFStringNormalizationForm form;
 		CFStringRef cfString = NULL;
@@ -966,8 +1116,8 @@ void fx_String_prototype_normalize(txMachine* the)
 void fx_String_prototype_pad(txMachine* the, txBoolean flag)
 {
 	txString string = fxCoerceToString(the, mxThis), filler;
-	txInteger stringLength = mxStringLength(string), fillerLength;
-	txInteger stringSize = fxUnicodeLength(string), fillerSize;
+	txInteger stringLength = fxGetStringSize(the, mxThis), fillerLength;
+	txInteger stringSize = fxGetStringLength(the, mxThis), fillerSize;
 	txInteger resultSize = (txInteger)fxArgToRange(the, 0, 0, 0, 0x7FFFFFFF);
 	*mxResult = *mxThis;
 	if (resultSize > stringSize) {
@@ -977,7 +1127,7 @@ void fx_String_prototype_pad(txMachine* the, txBoolean flag)
 			mxPushSlot(mxArgv(1));
 		filler = fxToString(the, the->stack);
 		fillerLength = mxStringLength(filler);
-		fillerSize = fxUnicodeLength(filler);
+		fillerSize = fxGetStringLength(the, the->stack);
 		if (fillerSize > 0) {
 			txInteger delta = resultSize - stringSize;
 			txInteger count = delta / fillerSize;
@@ -1022,7 +1172,7 @@ void fx_String_prototype_padStart(txMachine* the)
 void fx_String_prototype_repeat(txMachine* the)
 {
 	txString string = fxCoerceToString(the, mxThis), result;
-	txInteger length = mxStringLength(string);
+	txInteger length = fxGetStringSize(the, mxThis);
 	txInteger count = 0;
 	txSlot *arg = mxArgv(0);
 	if ((mxArgc > 0) && (arg->kind != XS_UNDEFINED_KIND)) {
@@ -1204,7 +1354,7 @@ void fx_String_prototype_replaceAux(txMachine* the, txInteger size, txInteger of
 		mxPushSlot(function);
 		mxCall();
 		mxPushSlot(match);
-		mxPushInteger(fxUTF8ToUnicodeOffset(mxThis->value.string, offset));
+		mxPushInteger(fxGetStringIndex(the, mxThis, offset));
 		mxPushSlot(mxThis);
 		mxRunCount(3);
 		fxToString(the, the->stack);
@@ -1222,13 +1372,15 @@ void fx_String_prototype_search(txMachine* the)
 
 void fx_String_prototype_slice(txMachine* the)
 {
-	txString string = fxCoerceToString(the, mxThis);
-	txInteger length = fxUnicodeLength(string);
-	txNumber start = fxArgToIndex(the, 0, 0, length);
-	txNumber end = fxArgToIndex(the, 1, length, length);
+	txInteger length;
+	txNumber start, end;
+	fxCoerceToString(the, mxThis);
+	length = fxGetStringLength(the, mxThis);
+	start = fxArgToIndex(the, 0, 0, length);
+	end = fxArgToIndex(the, 1, length, length);
 	if (start < end) {
-		txInteger offset = fxUnicodeToUTF8Offset(string, (txInteger)start);
-		length = fxUnicodeToUTF8Offset(string + offset, (txInteger)(end - start));
+		txInteger offset = fxGetStringOffset(the, mxThis, (txInteger)start);
+		length = fxGetStringOffset(the, mxThis, (txInteger)end) - offset;
 		if ((offset >= 0) && (length > 0)) {
 			mxResult->value.string = (txString)fxNewChunk(the, length + 1);
 			c_memcpy(mxResult->value.string, mxThis->value.string + offset, length);
@@ -1327,7 +1479,7 @@ txSlot* fx_String_prototype_split_aux(txMachine* the, txSlot* theString, txSlot*
 void fx_String_prototype_startsWith(txMachine* the)
 {
 	txString string = fxCoerceToString(the, mxThis);
-	txInteger length = mxStringLength(string);
+	txInteger length = fxGetStringSize(the, mxThis);
 	txString searchString;
 	txInteger searchLength;
 	txInteger offset;
@@ -1339,7 +1491,7 @@ void fx_String_prototype_startsWith(txMachine* the)
 		mxTypeError("future editions");
 	searchString = fxToString(the, mxArgv(0));
 	searchLength = mxStringLength(searchString);
-	offset = fxUnicodeToUTF8Offset(string, fxArgToPosition(the, 1, 0, fxUnicodeLength(string)));
+	offset = fxGetStringOffset(the, mxThis, fxArgToPosition(the, 1, 0, fxGetStringLength(the, mxThis)));
 	if (length - offset < searchLength)
 		return;
 	if (!c_strncmp(string + offset, searchString, searchLength))
@@ -1349,7 +1501,7 @@ void fx_String_prototype_startsWith(txMachine* the)
 void fx_String_prototype_substr(txMachine* the)
 {
 	txString string = fxCoerceToString(the, mxThis);
-	txInteger size = fxUnicodeLength(string);
+	txInteger size = fxGetStringLength(the, mxThis);
 	txInteger start = (txInteger)fxArgToIndex(the, 0, 0, size);
 	txInteger stop = size;
 	if ((mxArgc > 1) && (mxArgv(1)->kind != XS_UNDEFINED_KIND)) {
@@ -1359,8 +1511,8 @@ void fx_String_prototype_substr(txMachine* the)
 	}	
 	if (start < stop) {
 		txInteger length;
-		start = fxUnicodeToUTF8Offset(string, start);
-		stop = fxUnicodeToUTF8Offset(string, stop);
+		start = fxGetStringOffset(the, mxThis, start);
+		stop = fxGetStringOffset(the, mxThis, stop);
 		length = stop - start;
 		mxResult->value.string = (txString)fxNewChunk(the, length + 1);
 		c_memcpy(mxResult->value.string, string + start, length);
@@ -1375,15 +1527,14 @@ void fx_String_prototype_substr(txMachine* the)
 
 void fx_String_prototype_substring(txMachine* the)
 {
-	txString aString;
 	txInteger aLength;
 	txNumber aNumber;
 	txInteger aStart;
 	txInteger aStop;
 	txInteger anOffset;
 
-	aString = fxCoerceToString(the, mxThis);
-	aLength = fxUnicodeLength(aString);
+	fxCoerceToString(the, mxThis);
+	aLength = fxGetStringLength(the, mxThis);
 	aStart = 0;
 	aStop = aLength;
 	if ((mxArgc > 0) && (mxArgv(0)->kind != XS_UNDEFINED_KIND)) {
@@ -1400,8 +1551,8 @@ void fx_String_prototype_substring(txMachine* the)
 		aStop = aLength;
 	}
 	if (aStart < aStop) {
-		anOffset = fxUnicodeToUTF8Offset(aString, aStart);
-		aLength = fxUnicodeToUTF8Offset(aString + anOffset, aStop - aStart);
+		anOffset = fxGetStringOffset(the, mxThis, aStart);
+		aLength = fxGetStringOffset(the, mxThis, aStop) - anOffset;
 		if ((anOffset >= 0) && (aLength > 0)) {
 			mxResult->value.string = (txString)fxNewChunk(the, aLength + 1);
 			c_memcpy(mxResult->value.string, mxThis->value.string + anOffset, aLength);
@@ -1693,7 +1844,7 @@ void fx_String_prototype_iterator_next(txMachine* the)
 	txSlot* value = result->value.reference->next;
 	txSlot* done = value->next;
 	if (index->value.integer < length->value.integer) {
-		txInteger offset = fxUnicodeToUTF8Offset(iterable->value.string, index->value.integer);
+		txInteger offset = fxGetStringOffset(the, iterable, index->value.integer);
 		txInteger length = fxUnicodeToUTF8Offset(iterable->value.string + offset, 1);
 		value->value.string = (txString)fxNewChunk(the, length + 1);
 		c_memcpy(value->value.string, iterable->value.string + offset, length);
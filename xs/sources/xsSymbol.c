@@ -38,6 +38,11 @@
 #include "xsAll.h"
 
 static txSlot* fxCheckSymbol(txMachine* the, txSlot* it);
+static txSlot* fxFindNameSlot(txMachine* the, txString theString, txU4 theSum, txFlag theFlag);
+static void fxGrowKeys(txMachine* the);
+static void fxGrowNames(txMachine* the);
+static txSlot* fxNewNameSlot(txMachine* the, txU4 theSum, txKind theKind, txFlag theFlag);
+static txU4 fxSumName(txString theString);
 
 void fxBuildSymbol(txMachine* the)
 {
@@ -81,12 +86,9 @@ txSlot* fxNewSymbolInstance(txMachine* the)
 
 void fx_Symbol(txMachine* the)
 {
-	txID id = the->keyIndex;
 	txSlot* description;
 	if (mxTarget->kind != XS_UNDEFINED_KIND)
 		mxTypeError("new Symbol");
-	if (id == the->keyCount)
-		fxAbort(the, XS_NO_MORE_KEYS_EXIT);
 	if ((mxArgc > 0) && (mxArgv(0)->kind != XS_UNDEFINED_KIND)) {
 		fxToString(the, mxArgv(0));
 		description = fxNewSlot(the);
@@ -95,29 +97,20 @@ void fx_Symbol(txMachine* the)
 	}
 	else
 		description = C_NULL;
-	the->keyArray[id - the->keyOffset] = description;
-	the->keyIndex++;
+	mxResult->value.symbol = fxNewKey(the, description);
 	mxResult->kind = XS_SYMBOL_KIND;
-	mxResult->value.symbol = id;
 }
 
 void fx_Symbol_for(txMachine* the)
 {
 	txString string;
-	txU1* p;
 	txU4 sum;
 	txU4 modulo;
 	txSlot* result;
-	txID id;
 	if (mxArgc < 1)
 		mxSyntaxError("no key parameter");
 	string = fxToString(the, mxArgv(0));
-	p = (txU1*)string;
-	sum = 0;
-	while(*p != 0) {
-		sum = (sum << 1) + *p++;
-	}
-	sum &= 0x7FFFFFFF;
+	sum = fxSumName(string);
 	modulo = sum % the->symbolModulo;
 	result = the->symbolTable[modulo];
 	while (result != C_NULL) {
@@ -127,17 +120,12 @@ void fx_Symbol_for(txMachine* the)
 		result = result->next;
 	}
 	if (result == C_NULL) {
-		id = the->keyIndex;
-		if (id == the->keyCount)
-			fxAbort(the, XS_NO_MORE_KEYS_EXIT);
 		result = fxNewSlot(the);
 		result->next = the->symbolTable[modulo];
 		result->kind = (mxArgv(0)->kind == XS_STRING_X_KIND) ? XS_KEY_X_KIND : XS_KEY_KIND;
-		result->ID = id;
 		result->value.key.string = mxArgv(0)->value.string;
 		result->value.key.sum = sum;
-		the->keyArray[id - the->keyOffset] = result;
-		the->keyIndex++;
+		result->ID = fxNewKey(the, result);
 		the->symbolTable[modulo] = result;
 	}
 	mxResult->kind = XS_SYMBOL_KIND;
@@ -246,26 +234,88 @@ char* fxGetKeyName(txMachine* the, txID theID)
 
 txID fxFindName(txMachine* the, txString theString)
 {
-	txU1* aString;
-	txU4 aSum;
-	txU4 aModulo;
-	txSlot* result;
-	
-	aString = (txU1*)theString;
-	aSum = 0;
-	while (*aString != 0) {
-		aSum = (aSum << 1) + *aString++;
-	}
-	aSum &= 0x7FFFFFFF;
-	aModulo = aSum % the->nameModulo;
-	result = the->nameTable[aModulo];
+	txSlot* result = fxFindNameSlot(the, theString, fxSumName(theString), XS_NO_FLAG);
+	if (result)
+		return mxGetKeySlotID(result);
+	return 0;
+}
+
+txSlot* fxFindNameSlot(txMachine* the, txString theString, txU4 theSum, txFlag theFlag)
+{
+	txSlot* result = the->nameTable[theSum % the->nameModulo];
 	while (result != C_NULL) {
-		if (result->value.key.sum == aSum)
-			if (c_strcmp(result->value.key.string, theString) == 0)
-				return mxGetKeySlotID(result);
+		if (result->value.key.sum == theSum) {
+			if (c_strcmp(result->value.key.string, theString) == 0) {
+			#if mxCollectKeys
+				if ((result->flag & XS_COLLECTABLE_FLAG) && (mxGetKeySlotID(result) >= the->keyOffset)) {
+					if (theFlag & XS_COLLECTABLE_FLAG)
+						result->flag |= XS_RECENT_FLAG;
+					else
+						result->flag &= ~(XS_COLLECTABLE_FLAG | XS_RECENT_FLAG);
+				}
+			#endif
+				return result;
+			}
+		}
 		result = result->next;
 	}
-	return 0;
+	return C_NULL;
+}
+
+void fxGrowKeys(txMachine* the)
+{
+	txSize count = (txSize)the->keyCount - (txSize)the->keyOffset;
+	txSize size = (count < 256) ? 256 : count;
+	txSize limit = (txSize)mxKeyLimit - (txSize)the->keyCount;
+	txSlot** array;
+	if (size > limit)
+		size = limit;
+	if (size <= 0)
+		fxAbort(the, XS_NO_MORE_KEYS_EXIT);
+	size += count;
+	array = (txSlot **)c_malloc_uint32(size * sizeof(txSlot*));
+	if (!array)
+		fxAbort(the, XS_NOT_ENOUGH_MEMORY_EXIT);
+	if (count)
+		c_memcpy(array, the->keyArray, count * sizeof(txSlot*));
+	if (the->keyArray)
+		c_free_uint32(the->keyArray);
+	the->keyArray = array;
+	the->keyCount = (txID)(the->keyOffset + size);
+}
+
+void fxGrowNames(txMachine* the)
+{
+	txSize modulo = the->nameModulo;
+	txSize size = modulo << 1;
+	txSlot** table;
+	txSlot* slot;
+	txSlot* next;
+	txSize index;
+	if (modulo > (0x7FFFFFFF / (txSize)(2 * sizeof(txSlot*))))
+		return;
+	table = (txSlot **)c_malloc_uint32(size * sizeof(txSlot*));
+	if (!table)
+		return;
+	/* keys inherited from a shared machine are never moved: every new bucket starts with the shared chain of its old bucket */
+	for (index = 0; index < size; index++) {
+		slot = the->nameTable[index % modulo];
+		while (slot && (mxGetKeySlotID(slot) >= the->keyOffset))
+			slot = slot->next;
+		table[index] = slot;
+	}
+	for (index = 0; index < modulo; index++) {
+		slot = the->nameTable[index];
+		while (slot && (mxGetKeySlotID(slot) >= the->keyOffset)) {
+			next = slot->next;
+			slot->next = table[slot->value.key.sum % size];
+			table[slot->value.key.sum % size] = slot;
+			slot = next;
+		}
+	}
+	c_free_uint32(the->nameTable);
+	the->nameTable = table;
+	the->nameModulo = size;
 }
 
 txBoolean fxIsKeyName(txMachine* the, txID theID)
@@ -280,132 +330,110 @@ txBoolean fxIsKeySymbol(txMachine* the, txID theID)
 	return (!key || !(key->flag & XS_DONT_ENUM_FLAG)) ? 1 : 0;
 }
 
-txID fxNewName(txMachine* the, txSlot* theSlot)
+txID fxNewCollectableName(txMachine* the, txSlot* theSlot)
 {
-	txU1* string;
-	txU4 sum;
-	txU4 modulo;
-	txSlot* result;
-	txID id;
+#if mxCollectKeys
+	txU4 sum = fxSumName(theSlot->value.string);
+	txSlot* result = fxFindNameSlot(the, theSlot->value.string, sum, XS_COLLECTABLE_FLAG);
+	if (result == C_NULL) {
+		result = fxNewNameSlot(the, sum, (theSlot->kind == XS_STRING_X_KIND) ? XS_KEY_X_KIND : XS_KEY_KIND, XS_COLLECTABLE_FLAG | XS_RECENT_FLAG);
+		result->value.key.string = theSlot->value.string;
+	}
+	return mxGetKeySlotID(result);
+#else
+	if (theSlot->kind == XS_STRING_X_KIND)
+		return fxNewNameX(the, theSlot->value.string);
+	return fxNewName(the, theSlot);
+#endif
+}
 
-	string = (txU1*)theSlot->value.string;
-	sum = 0;
-	while(*string != 0) {
-		sum = (sum << 1) + *string++;
+txID fxNewKey(txMachine* the, txSlot* theSlot)
+{
+	txID id;
+	if (the->keyFreeCount) {
+		the->keyFreeCount--;
+		id = the->keyFreeArray[the->keyFreeCount];
 	}
-	sum &= 0x7FFFFFFF;
-	modulo = sum % the->nameModulo;
-	result = the->nameTable[modulo];
-	while (result != C_NULL) {
-		if (result->value.key.sum == sum) {
-			if (c_strcmp(result->value.key.string, theSlot->value.string) == 0)
-				return mxGetKeySlotID(result);
-		}
-		result = result->next;
+	else {
+		id = the->keyIndex;
+		if (id == the->keyCount)
+			fxGrowKeys(the);
+		the->keyIndex++;
 	}
+	the->keyArray[id - the->keyOffset] = theSlot;
+	return id;
+}
 
-	id = the->keyIndex;
-	if (id == the->keyCount)
-		fxAbort(the, XS_NO_MORE_KEYS_EXIT);
-	result = fxNewSlot(the);
-	result->next = the->nameTable[modulo];
-	result->flag = XS_DONT_ENUM_FLAG;
-	result->kind = XS_KEY_KIND;
-	result->ID = id;
-	result->value.key.string = theSlot->value.string;
-	result->value.key.sum = sum;
-	the->keyArray[id - the->keyOffset] = result;
-	the->keyIndex++;
-	the->nameTable[modulo] = result;
-	return result->ID;
+txID fxNewName(txMachine* the, txSlot* theSlot)
+{
+	txU4 sum = fxSumName(theSlot->value.string);
+	txSlot* result = fxFindNameSlot(the, theSlot->value.string, sum, XS_NO_FLAG);
+	if (result == C_NULL) {
+		result = fxNewNameSlot(the, sum, XS_KEY_KIND, XS_NO_FLAG);
+		result->value.key.string = theSlot->value.string;
+	}
+	return mxGetKeySlotID(result);
 }
 
 txID fxNewNameC(txMachine* the, txString theString)
 {
-	txU1* string;
-	txU4 sum;
-	txU4 modulo;
-	txSlot* result;
-	txID id;
-
-	string = (txU1*)theString;
-	sum = 0;
-	while(c_read8(string) != 0) {
-		sum = (sum << 1) + c_read8(string++);
-	}
-	sum &= 0x7FFFFFFF;
-	modulo = sum % the->nameModulo;
-	result = the->nameTable[modulo];
-	while (result != C_NULL) {
-		if (result->value.key.sum == sum) {
-			if (c_strcmp(result->value.key.string, theString) == 0)
-				return mxGetKeySlotID(result);
-		}
-		result = result->next;
+	txU4 sum = fxSumName(theString);
+	txSlot* result = fxFindNameSlot(the, theString, sum, XS_NO_FLAG);
+	if (result == C_NULL) {
+		result = fxNewNameSlot(the, sum, XS_KEY_KIND, XS_NO_FLAG);
+		result->value.key.string = (txString)fxNewChunk(the, mxStringLength(theString) + 1);
+		c_strcpy(result->value.key.string, theString);
 	}
+	return mxGetKeySlotID(result);
+}
 
-	id = the->keyIndex;
-	if (id == the->keyCount)
-		fxAbort(the, XS_NO_MORE_KEYS_EXIT);
+txSlot* fxNewNameSlot(txMachine* the, txU4 theSum, txKind theKind, txFlag theFlag)
+{
+	txSlot* result;
+	txU4 modulo;
 	result = fxNewSlot(the);
-	result->next = the->nameTable[modulo];
-	result->flag = XS_DONT_ENUM_FLAG;
-	result->kind = XS_KEY_KIND;
-	result->ID = id;
+	result->flag = XS_DONT_ENUM_FLAG | theFlag;
+	result->kind = theKind;
 	result->value.key.string = C_NULL;
-	result->value.key.sum = sum;
-	the->keyArray[id - the->keyOffset] = result;
-	the->keyIndex++;
+	result->value.key.sum = theSum;
+	result->ID = fxNewKey(the, result);
+	if (the->nameCount >= (the->nameModulo << 1))
+		fxGrowNames(the);
+	modulo = theSum % the->nameModulo;
+	result->next = the->nameTable[modulo];
 	the->nameTable[modulo] = result;
-	result->value.key.string = (txString)fxNewChunk(the, mxStringLength(theString) + 1);
-	c_strcpy(result->value.key.string, theString);
-	return result->ID;
+	the->nameCount++;
+	return result;
 }
 
 txID fxNewNameX(txMachine* the, txString theString)
 {
-	txU1* string;
-	txU4 sum;
-	txU4 modulo;
-	txSlot* result;
-	txID id;
-	
-	string = (txU1*)theString;
-	sum = 0;
-	while (c_read8(string) != 0) {
-		sum = (sum << 1) + c_read8(string++);
-	}
-	sum &= 0x7FFFFFFF;
-	modulo = sum % the->nameModulo;
-	result = the->nameTable[modulo];
-	while (result != C_NULL) {
-		if (result->value.key.sum == sum) {
-			if (c_strcmp(result->value.key.string, theString) == 0)
-				return mxGetKeySlotID(result);
-		}
-		result = result->next;
+	txU4 sum = fxSumName(theString);
+	txSlot* result = fxFindNameSlot(the, theString, sum, XS_NO_FLAG);
+	if (result == C_NULL) {
+		result = fxNewNameSlot(the, sum, XS_KEY_X_KIND, XS_NO_FLAG);
+		result->value.key.string = theString;
 	}
+	return mxGetKeySlotID(result);
+}
 
-	id = the->keyIndex;
-	if (id == the->keyCount)
-		fxAbort(the, XS_NO_MORE_KEYS_EXIT);
-	result = fxNewSlot(the);
-	result->next = the->nameTable[modulo];
-	result->flag = XS_DONT_ENUM_FLAG;
-	result->kind = XS_KEY_X_KIND;
-	result->ID = id;
-	result->value.key.string = theString;
-	result->value.key.sum = sum;
-	the->keyArray[id - the->keyOffset] = result;
-	the->keyIndex++;
-	the->nameTable[modulo] = result;
-	return result->ID;
+txU4 fxSumName(txString theString)
+{
+	txU1* string = (txU1*)theString;
+	txU4 sum = mxNameSumSeed;
+	txU1 c;
+	while ((c = c_read8(string++)))
+		sum = mxNameSum(sum, c);
+	return sum & mxNameSumMask;
 }
 
 txSlot* fxAt(txMachine* the, txSlot* slot)
 {
 	txIndex index;
 	txString string;
+#if mxStringCache
+	txStringCacheEntry* entry;
+#endif
 again:
 	if ((slot->kind == XS_INTEGER_KIND) && fxIntegerToIndex(the->dtoa, slot->value.integer, &index)) {
 		slot->value.at.id = XS_NO_ID;
@@ -425,19 +453,34 @@ again:
             goto again;
         }
         string = fxToString(the, slot);
+	#if mxStringCache
+		entry = fxFindStringCacheEntry(the, slot);
+		if (entry && (entry->flag & XS_STRING_AT_FLAG)) {
+			slot->value.at.id = entry->id;
+			slot->value.at.index = entry->index;
+			slot->kind = XS_AT_KIND;
+			return slot;
+		}
+	#endif
         if (fxStringToIndex(the->dtoa, string, &index)) {
             slot->value.at.id = XS_NO_ID;
             slot->value.at.index = index;
         }
         else {
-			txID id;
-            if (slot->kind == XS_STRING_X_KIND)
-                id = fxNewNameX(the, string);
-            else
-                id = fxNewName(the, slot);
+            txID id = fxNewCollectableName(the, slot);
+		#if mxStringCache
+			entry = fxFindStringCacheEntry(the, slot);
+		#endif
             slot->value.at.id = id;
             slot->value.at.index = 0;
         }
+	#if mxStringCache
+		if (entry) {
+			entry->id = slot->value.at.id;
+			entry->index = slot->value.at.index;
+			entry->flag |= XS_STRING_AT_FLAG;
+		}
+	#endif
     }
 	slot->kind = XS_AT_KIND;
 	return slot;
@@ -60,6 +60,9 @@ txSlot* fxAliasInstance(txMachine* the, txSlot* instance)
 	txSlot* alias;
 	txSlot* from;
 	txSlot* to;
+#if mxPropertyCache
+	fxInvalidatePropertyCache(the);
+#endif
 	the->aliasArray[instance->ID] = alias = fxNewSlot(the);
 	alias->flag = instance->flag & ~XS_MARK_FLAG;
 	alias->kind = XS_INSTANCE_KIND;
@@ -207,7 +210,7 @@ txSlot* fxToInstance(txMachine* the, txSlot* theSlot)
 		anInstance = fxNewStringInstance(the);
 		anInstance->next->kind = theSlot->kind;
 		anInstance->next->value.string = theSlot->value.string;
-		anInstance->next->value.key.sum = fxUnicodeLength(theSlot->value.string);
+		anInstance->next->value.key.sum = fxGetStringLength(the, theSlot);
 		if (the->frame->flag & XS_STRICT_FLAG)
 			anInstance->flag |= XS_DONT_PATCH_FLAG;
 		mxPullSlot(theSlot);
@@ -465,6 +468,9 @@ txBoolean fxOrdinaryDeleteProperty(txMachine* the, txSlot* instance, txID id, tx
 {
 	txSlot** address = &(instance->next);
 	txSlot* property;
+#if mxDictionaries
+	txSlot* previous;
+#endif
 	if (instance->ID) {
 		txSlot* alias = the->aliasArray[instance->ID];
 		if (alias)
@@ -472,18 +478,41 @@ txBoolean fxOrdinaryDeleteProperty(txMachine* the, txSlot* instance, txID id, tx
 	}
 	address = &(instance->next);
 	if (id) {
-		while ((property = *address) && (property->flag & XS_INTERNAL_FLAG))
+#if mxDictionaries
+		if ((mxInstanceIndex(instance) < 0) && !fxGetDictionaryProperty(the, instance, id))
+			return 1;
+		previous = instance;
+#endif
+		while ((property = *address) && (property->flag & XS_INTERNAL_FLAG)) {
+#if mxDictionaries
+			previous = property;
+#endif
 			address = &(property->next);
+		}
 		while ((property = *address)) {
 			if (property->ID == id) {
 				if (property->flag & XS_DONT_DELETE_FLAG)
 					return 0;
 				if (instance->ID)
 					return fxOrdinaryDeleteProperty(the, fxAliasInstance(the, instance), id, index);
+#if mxDictionaries
+				if (mxInstanceIndex(instance) < 0)
+					fxRemoveDictionaryProperty(the, instance, property, previous);
+#endif
 				*address = property->next;
 				property->next = C_NULL;
+#if mxPropertyCacheKeys
+				if (mxInstanceIndex(instance) > 0)
+					mxInstanceIndex(instance) = 0;
+#endif
+#if mxPropertyCache
+				fxInvalidatePropertyCache(the);
+#endif
 				return 1;
 			}
+#if mxDictionaries
+			previous = property;
+#endif
 			address = &(property->next);
 		}
 		return 1;
@@ -533,6 +562,14 @@ again:
 				}
 			}
 		}
+#if mxDictionaries
+		if (mxInstanceIndex(instance) < 0) {
+			result = fxGetDictionaryProperty(the, instance, id);
+			if (result)
+				return result;
+			goto prototype;
+		}
+#endif
 		result = instance->next;
 		while (result && (result->flag & XS_INTERNAL_FLAG))
 			result = result->next;
@@ -554,6 +591,9 @@ again:
 			result = result->next;
 		}		
 	}
+#if mxDictionaries
+prototype:
+#endif
 	if (flag) {
 		txSlot* prototype = fxGetPrototype(the, instance);
 		if (prototype) {
@@ -683,6 +723,9 @@ txSlot* fxOrdinarySetProperty(txMachine* the, txSlot* instance, txID id, txIndex
 	txSlot** address;
 	txSlot* property;
 	txSlot* result;
+#if mxPropertyCacheKeys || mxDictionaries
+	txInteger count = 0;
+#endif
 	if (instance->ID) {
 		txSlot* alias = the->aliasArray[instance->ID];
 		if (alias)
@@ -711,6 +754,15 @@ txSlot* fxOrdinarySetProperty(txMachine* the, txSlot* instance, txID id, txIndex
 				}
 			}
 		}
+#if mxDictionaries
+		if (mxInstanceIndex(instance) < 0) {
+			property = fxGetDictionaryProperty(the, instance, id);
+			if (property)
+				return property;
+			address = fxGetDictionaryTail(the, instance);
+			goto prototype;
+		}
+#endif
 		address = &(instance->next);
 		while ((property = *address) && (property->flag & XS_INTERNAL_FLAG))
 			address = &(property->next);
@@ -718,6 +770,9 @@ txSlot* fxOrdinarySetProperty(txMachine* the, txSlot* instance, txID id, txIndex
 			if (property->ID == id)
 				return property;
 			address = &(property->next);
+#if mxPropertyCacheKeys || mxDictionaries
+			count++;
+#endif
 		}
 	}
 	else {
@@ -732,6 +787,9 @@ txSlot* fxOrdinarySetProperty(txMachine* the, txSlot* instance, txID id, txIndex
 			address = &(property->next);
 		}		
 	}
+#if mxDictionaries
+prototype:
+#endif
 	if (flag) {
 		txSlot* prototype = fxGetPrototype(the, instance);
 		if (prototype) {
@@ -747,8 +805,15 @@ txSlot* fxOrdinarySetProperty(txMachine* the, txSlot* instance, txID id, txIndex
 	if (instance->flag & XS_DONT_PATCH_FLAG)
 		return C_NULL;
 	if (id) {
-		*address = result = fxNewSlot(the);
-		result->ID = id;
+		result = fxNewProperty(the, address, id, XS_NO_FLAG);
+#if mxPropertyCacheKeys
+		if (mxInstanceIndex(instance) > 0)
+			mxInstanceIndex(instance) = fxNextPropertyCacheKey(the, mxInstanceIndex(instance), count, id);
+#endif
+#if mxDictionaries
+		if ((mxInstanceIndex(instance) == 0) && (count >= mxDictionaryThreshold) && !(instance->flag & XS_EXOTIC_FLAG))
+			fxNewDictionary(the, instance);
+#endif
 	}
 	else {
 		if (property && (property->kind == XS_ARRAY_KIND)) {
@@ -837,6 +902,9 @@ txBoolean fxOrdinarySetPrototype(txMachine* the, txSlot* instance, txSlot* slot)
 		if (instance->ID)
 			instance = fxAliasInstance(the, instance);
 		instance->value.instance.prototype = prototype;
+#if mxPropertyCache
+		fxInvalidatePropertyCache(the);
+#endif
 	}
 	return 1;
 }
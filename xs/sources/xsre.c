@@ -53,6 +53,30 @@ enum {
 	cxWordContinueStep
 };
 
+enum {
+	cxPrefilterNone = 0,
+	cxPrefilterAnchored,
+	cxPrefilterFirst,
+	cxPrefilterLiteral
+};
+#define mxPrefilterLiteralSize 31
+
+enum {
+	cxNFACharSet = 0,
+	cxNFAJump,
+	cxNFALineBegin,
+	cxNFALineEnd,
+	cxNFAMatch,
+	cxNFAProgress,
+	cxNFAReset,
+	cxNFASave,
+	cxNFASplit,
+	cxNFAWordBreak,
+	cxNFAWordContinue
+};
+#define mxNFALength 1024
+#define mxNFALoops 4
+
 #define mxCharCaseFoldingCount 189
 static const txCharCase gxCharCaseFoldings[mxCharCaseFoldingCount] ICACHE_XS6RO_ATTR = {
 	{0x41,0x5A,32},{0xB5,0xB5,775},{0xC0,0xD6,32},{0xD8,0xDE,32},{0x100,0x12E,0},{0x132,0x136,0},{0x139,0x147,0},
@@ -158,6 +182,22 @@ typedef struct {
 	txTerm* right;
 } txSequence;
 
+typedef struct {
+	txInteger kind;
+	txInteger length;
+	txU4 bits[8];
+	char literal[mxPrefilterLiteralSize + 1];
+} txPrefilter;
+
+typedef struct {
+	txInteger* program;
+	txInteger length;
+	txInteger threads;
+	txInteger depth;
+	txInteger loops;
+	txInteger loopCount;
+} txNFA;
+
 struct sxPatternParser {
 	txMachine* the;
 	txTerm* first;
@@ -228,6 +268,17 @@ static void fxSequenceCode(txPatternParser* parser, void* it, txInteger directio
 static void fxWordBreakCode(txPatternParser* parser, void* it, txInteger direction, txInteger sequel);
 static void fxWordContinueCode(txPatternParser* parser, void* it, txInteger direction, txInteger sequel);
 
+static txInteger fxNFACode(txPatternParser* parser, txTerm* term, txNFA* nfa);
+static txInteger fxNFAMeasure(txPatternParser* parser, txTerm* term);
+static txInteger fxNFALoops(txTerm* term);
+static txBoolean fxNFANullable(txTerm* term);
+static txBoolean fxNFAProne(txTerm* term, txBoolean repeated);
+static txBoolean fxPrefilterAnchored(txPatternParser* parser, txTerm* term);
+static txBoolean fxPrefilterFirst(txPatternParser* parser, txTerm* term, txPrefilter* prefilter);
+static txBoolean fxPrefilterLiteral(txPatternParser* parser, txTerm* term, txPrefilter* prefilter);
+static void fxPrefilterCode(txPatternParser* parser, txPrefilter* prefilter, txInteger offset);
+static txInteger fxPrefilterMeasure(txPatternParser* parser, txTerm* term, txPrefilter* prefilter);
+
 static void fxPatternParserInitialize(txPatternParser* parser);
 static txBoolean fxPatternParserDecimal(txPatternParser* parser, txU4* value);
 static void fxPatternParserError(txPatternParser* parser, txString format, ...);
@@ -319,9 +370,26 @@ struct sxStateData {
 	txCaptureData captures[1];
 };
 
+typedef struct {
+	txInteger* program;
+	txInteger* marks;
+	txU4* visits;
+	txInteger* stack;
+	txInteger* slots;
+	txInteger slotCount;
+	txInteger loopSlot;
+	txInteger loopCount;
+	txString subject;
+	txInteger flags;
+} txNFAMatcher;
+
 static txInteger fxFindCharacter(txString input, txInteger offset, txInteger direction);
 static txInteger fxGetCharacter(txString input, txInteger offset, txInteger flags);
 static txBoolean fxMatchCharacter(txInteger* characters, txInteger character);
+static txInteger fxMatchRegExpNFA(void* the, txInteger* code, txInteger* data, txString subject, txInteger start);
+static txInteger fxNFAFollow(txNFAMatcher* matcher, txInteger pc, txInteger generation, txInteger offset, txInteger* list, txInteger count);
+static txBoolean fxNFAVisited(txNFAMatcher* matcher, txInteger pc, txInteger offset);
+static txInteger fxPrefilterSkip(txInteger* prefilter, txString subject, txInteger start);
 static txStateData* fxPopStates(txMachine* the, txStateData* fromState, txStateData* toState);
 static txStateData* fxPushState(txMachine* the, txStateData* firstState, txInteger step, txInteger offset, txCaptureData* captures, txInteger captureCount);
 
@@ -1481,6 +1549,347 @@ void fxWordContinueCode(txPatternParser* parser, void* it, txInteger direction,
 }
 
 
+txBoolean fxPrefilterAnchored(txPatternParser* parser, txTerm* term)
+{
+	txTermCode code = term->dispatch.code;
+	if (code == fxLineBeginCode)
+		return (parser->flags & XS_REGEXP_M) ? 0 : 1;
+	if (code == fxSequenceCode)
+		return fxPrefilterAnchored(parser, ((txSequence*)term)->left);
+	if (code == fxDisjunctionCode)
+		return fxPrefilterAnchored(parser, ((txDisjunction*)term)->left) && fxPrefilterAnchored(parser, ((txDisjunction*)term)->right);
+	if (code == fxCaptureCode)
+		return fxPrefilterAnchored(parser, ((txCapture*)term)->term);
+	if (code == fxQuantifierCode)
+		return (((txQuantifier*)term)->min > 0) ? fxPrefilterAnchored(parser, ((txQuantifier*)term)->term) : 0;
+	return 0;
+}
+
+txBoolean fxPrefilterFirst(txPatternParser* parser, txTerm* term, txPrefilter* prefilter)
+{
+	txTermCode code = term->dispatch.code;
+	if (code == fxCharSetCode) {
+		txInteger* characters = ((txCharSet*)term)->characters;
+		txInteger count = characters[0];
+		char buffer[2] = { 0, 0 };
+		txInteger c;
+		for (c = 1; c < 0x80; c++) {
+			buffer[0] = (char)c;
+			if (fxMatchCharacter(characters, fxGetCharacter(buffer, 0, parser->flags)))
+				prefilter->bits[c >> 5] |= (txU4)1 << (c & 31);
+		}
+		/* subjects encode other characters, including U+0000, with lead bytes from 0xC0 */
+		if ((parser->flags & XS_REGEXP_I) || fxMatchCharacter(characters, 0) || (count && (characters[count] > 0x80))) {
+			prefilter->bits[6] = 0xFFFFFFFF;
+			prefilter->bits[7] = 0xFFFFFFFF;
+		}
+		return 0;
+	}
+	if (code == fxSequenceCode) {
+		if (!fxPrefilterFirst(parser, ((txSequence*)term)->left, prefilter))
+			return 0;
+		return fxPrefilterFirst(parser, ((txSequence*)term)->right, prefilter);
+	}
+	if (code == fxDisjunctionCode) {
+		txBoolean left = fxPrefilterFirst(parser, ((txDisjunction*)term)->left, prefilter);
+		txBoolean right = fxPrefilterFirst(parser, ((txDisjunction*)term)->right, prefilter);
+		return left || right;
+	}
+	if (code == fxCaptureCode)
+		return fxPrefilterFirst(parser, ((txCapture*)term)->term, prefilter);
+	if (code == fxQuantifierCode) {
+		txQuantifier* quantifier = (txQuantifier*)term;
+		if (quantifier->max == 0)
+			return 1;
+		return fxPrefilterFirst(parser, quantifier->term, prefilter) || (quantifier->min == 0);
+	}
+	if (code == fxCaptureReferenceCode)
+		prefilter->kind = cxPrefilterNone;
+	return 1;
+}
+
+txBoolean fxPrefilterLiteral(txPatternParser* parser, txTerm* term, txPrefilter* prefilter)
+{
+	txTermCode code = term->dispatch.code;
+	if (code == fxCharSetCode) {
+		txInteger* characters = ((txCharSet*)term)->characters;
+		if ((characters[0] == 2) && (characters[2] == characters[1] + 1) && (0 < characters[1]) && (characters[1] < 0x80) && (prefilter->length < mxPrefilterLiteralSize)) {
+			prefilter->literal[prefilter->length++] = (char)characters[1];
+			return 1;
+		}
+		return 0;
+	}
+	if (code == fxSequenceCode)
+		return fxPrefilterLiteral(parser, ((txSequence*)term)->left, prefilter) && fxPrefilterLiteral(parser, ((txSequence*)term)->right, prefilter);
+	if (code == fxCaptureCode)
+		return fxPrefilterLiteral(parser, ((txCapture*)term)->term, prefilter);
+	if (code == fxQuantifierCode) {
+		if (((txQuantifier*)term)->min > 0)
+			fxPrefilterLiteral(parser, ((txQuantifier*)term)->term, prefilter);
+		return 0;
+	}
+	/* assertions do not consume characters */
+	if ((code == fxAssertionCode) || (code == fxEmptyCode) || (code == fxLineBeginCode) || (code == fxLineEndCode) || (code == fxWordBreakCode) || (code == fxWordContinueCode))
+		return 1;
+	return 0;
+}
+
+txInteger fxPrefilterMeasure(txPatternParser* parser, txTerm* term, txPrefilter* prefilter)
+{
+	c_memset(prefilter, 0, sizeof(txPrefilter));
+	if (parser->flags & XS_REGEXP_Y)
+		return 0;
+	if (fxPrefilterAnchored(parser, term)) {
+		prefilter->kind = cxPrefilterAnchored;
+		return sizeof(txInteger);
+	}
+	if (!(parser->flags & XS_REGEXP_I)) {
+		fxPrefilterLiteral(parser, term, prefilter);
+		if (prefilter->length) {
+			prefilter->kind = cxPrefilterLiteral;
+			return (2 * sizeof(txInteger)) + ((prefilter->length + sizeof(txInteger)) & ~(sizeof(txInteger) - 1));
+		}
+	}
+	prefilter->kind = cxPrefilterFirst;
+	if (fxPrefilterFirst(parser, term, prefilter) || (prefilter->kind == cxPrefilterNone)) {
+		prefilter->kind = cxPrefilterNone;
+		return 0;
+	}
+	return sizeof(txInteger) + sizeof(prefilter->bits);
+}
+
+void fxPrefilterCode(txPatternParser* parser, txPrefilter* prefilter, txInteger offset)
+{
+	txInteger* buffer = (txInteger*)(((txByte*)*(parser->code)) + offset);
+	*buffer++ = prefilter->kind;
+	if (prefilter->kind == cxPrefilterLiteral) {
+		*buffer++ = prefilter->length;
+		c_memcpy(buffer, prefilter->literal, prefilter->length + 1);
+	}
+	else if (prefilter->kind == cxPrefilterFirst)
+		c_memcpy(buffer, prefilter->bits, sizeof(prefilter->bits));
+}
+
+txInteger fxNFACode(txPatternParser* parser, txTerm* term, txNFA* nfa)
+{
+	txTermCode code = term->dispatch.code;
+	txInteger* program = nfa->program;
+	txInteger pc = nfa->length, index;
+	if (code == fxCharSetCode) {
+		txInteger* characters = ((txCharSet*)term)->characters;
+		program[pc++] = cxNFACharSet;
+		for (index = 0; index <= characters[0]; index++)
+			program[pc++] = characters[index];
+		nfa->threads++;
+	}
+	else if (code == fxSequenceCode) {
+		fxNFACode(parser, ((txSequence*)term)->left, nfa);
+		fxNFACode(parser, ((txSequence*)term)->right, nfa);
+		return nfa->length;
+	}
+	else if (code == fxDisjunctionCode) {
+		txInteger split = pc, jump;
+		nfa->length += 3;
+		jump = fxNFACode(parser, ((txDisjunction*)term)->left, nfa);
+		nfa->length += 2;
+		fxNFACode(parser, ((txDisjunction*)term)->right, nfa);
+		program[split] = cxNFASplit;
+		program[split + 1] = split + 3;
+		program[split + 2] = jump + 2;
+		program[jump] = cxNFAJump;
+		program[jump + 1] = nfa->length;
+		nfa->depth++;
+		return nfa->length;
+	}
+	else if (code == fxCaptureCode) {
+		txInteger captureIndex = ((txCapture*)term)->captureIndex;
+		program[pc++] = cxNFASave;
+		program[pc++] = 2 * captureIndex;
+		nfa->length = pc;
+		pc = fxNFACode(parser, ((txCapture*)term)->term, nfa);
+		program[pc++] = cxNFASave;
+		program[pc++] = (2 * captureIndex) + 1;
+		nfa->depth += 2;
+	}
+	else if (code == fxQuantifierCode) {
+		txQuantifier* self = (txQuantifier*)term;
+		txInteger from = self->captureIndex + 1;
+		txInteger to = self->captureIndex + self->captureCount + 1;
+		txInteger size = fxNFAMeasure(parser, self->term) + ((from < to) ? 3 : 0);
+		txInteger count = (self->max == 0x7FFFFFFF) ? self->min + 1 : self->max, end;
+		/* optional iterations that can match nothing save where they start in a loop slot, and die if they end there */
+		txInteger loop = ((self->max > self->min) && fxNFANullable(self->term)) ? nfa->loops : -1;
+		txInteger optional = size + ((loop >= 0) ? 4 : 0);
+		for (index = 0; index < count; index++) {
+			txInteger split = pc;
+			if (index >= self->min) {
+				if (self->max == 0x7FFFFFFF)
+					end = pc + 3 + optional + 2;
+				else
+					end = pc + ((self->max - index) * (3 + optional));
+				program[split] = cxNFASplit;
+				program[split + 1] = (self->greedy) ? split + 3 : end;
+				program[split + 2] = (self->greedy) ? end : split + 3;
+				pc += 3;
+				nfa->depth++;
+			}
+			if (from < to) {
+				program[pc++] = cxNFAReset;
+				program[pc++] = from;
+				program[pc++] = to;
+				nfa->depth += 2 * (to - from);
+			}
+			if ((index >= self->min) && (loop >= 0)) {
+				program[pc++] = cxNFASave;
+				program[pc++] = (2 * parser->captureIndex) + loop;
+				nfa->depth++;
+				nfa->loops++;
+				if (nfa->loopCount < nfa->loops)
+					nfa->loopCount = nfa->loops;
+			}
+			nfa->length = pc;
+			pc = fxNFACode(parser, self->term, nfa);
+			if ((index >= self->min) && (loop >= 0)) {
+				program[pc++] = cxNFAProgress;
+				program[pc++] = (2 * parser->captureIndex) + loop;
+				nfa->loops--;
+			}
+			if ((index >= self->min) && (self->max == 0x7FFFFFFF)) {
+				program[pc++] = cxNFAJump;
+				program[pc++] = split;
+			}
+		}
+	}
+	else if (code == fxLineBeginCode)
+		program[pc++] = cxNFALineBegin;
+	else if (code == fxLineEndCode)
+		program[pc++] = cxNFALineEnd;
+	else if (code == fxWordBreakCode)
+		program[pc++] = cxNFAWordBreak;
+	else if (code == fxWordContinueCode)
+		program[pc++] = cxNFAWordContinue;
+	nfa->length = pc;
+	return pc;
+}
+
+txInteger fxNFAMeasure(txPatternParser* parser, txTerm* term)
+{
+	txTermCode code = term->dispatch.code;
+	txInteger left, right;
+	if (code == fxCharSetCode)
+		return 2 + ((txCharSet*)term)->characters[0];
+	if (code == fxSequenceCode) {
+		if ((left = fxNFAMeasure(parser, ((txSequence*)term)->left)) < 0)
+			return -1;
+		if ((right = fxNFAMeasure(parser, ((txSequence*)term)->right)) < 0)
+			return -1;
+		return (left + right <= mxNFALength) ? left + right : -1;
+	}
+	if (code == fxDisjunctionCode) {
+		if ((left = fxNFAMeasure(parser, ((txDisjunction*)term)->left)) < 0)
+			return -1;
+		if ((right = fxNFAMeasure(parser, ((txDisjunction*)term)->right)) < 0)
+			return -1;
+		return (3 + left + 2 + right <= mxNFALength) ? 3 + left + 2 + right : -1;
+	}
+	if (code == fxCaptureCode) {
+		if ((left = fxNFAMeasure(parser, ((txCapture*)term)->term)) < 0)
+			return -1;
+		return (2 + left + 2 <= mxNFALength) ? 2 + left + 2 : -1;
+	}
+	if (code == fxQuantifierCode) {
+		txQuantifier* self = (txQuantifier*)term;
+		txInteger size, check = 0;
+		/* optional iterations that can match nothing need an empty check, each nested check doubles the states to follow */
+		if ((self->max > self->min) && fxNFANullable(self->term)) {
+			if (fxNFALoops(term) > mxNFALoops)
+				return -1;
+			check = 4;
+		}
+		if ((size = fxNFAMeasure(parser, self->term)) < 0)
+			return -1;
+		if (self->captureCount > 0)
+			size += 3;
+		if (self->min > mxNFALength)
+			return -1;
+		left = self->min * size;
+		if (self->max == 0x7FFFFFFF)
+			right = 3 + size + check + 2;
+		else if (self->max - self->min > mxNFALength)
+			return -1;
+		else
+			right = (self->max - self->min) * (3 + size + check);
+		return (left + right <= mxNFALength) ? left + right : -1;
+	}
+	if ((code == fxLineBeginCode) || (code == fxLineEndCode) || (code == fxWordBreakCode) || (code == fxWordContinueCode))
+		return 1;
+	if (code == fxEmptyCode)
+		return 0;
+	return -1;
+}
+
+txInteger fxNFALoops(txTerm* term)
+{
+	txTermCode code = term->dispatch.code;
+	txInteger left, right;
+	if (code == fxSequenceCode) {
+		left = fxNFALoops(((txSequence*)term)->left);
+		right = fxNFALoops(((txSequence*)term)->right);
+		return (left > right) ? left : right;
+	}
+	if (code == fxDisjunctionCode) {
+		left = fxNFALoops(((txDisjunction*)term)->left);
+		right = fxNFALoops(((txDisjunction*)term)->right);
+		return (left > right) ? left : right;
+	}
+	if (code == fxCaptureCode)
+		return fxNFALoops(((txCapture*)term)->term);
+	if (code == fxQuantifierCode) {
+		txQuantifier* self = (txQuantifier*)term;
+		return fxNFALoops(self->term) + (((self->max > self->min) && fxNFANullable(self->term)) ? 1 : 0);
+	}
+	return 0;
+}
+
+txBoolean fxNFANullable(txTerm* term)
+{
+	txTermCode code = term->dispatch.code;
+	if (code == fxCharSetCode)
+		return 0;
+	if (code == fxSequenceCode)
+		return fxNFANullable(((txSequence*)term)->left) && fxNFANullable(((txSequence*)term)->right);
+	if (code == fxDisjunctionCode)
+		return fxNFANullable(((txDisjunction*)term)->left) || fxNFANullable(((txDisjunction*)term)->right);
+	if (code == fxCaptureCode)
+		return fxNFANullable(((txCapture*)term)->term);
+	if (code == fxQuantifierCode)
+		return (((txQuantifier*)term)->min == 0) || fxNFANullable(((txQuantifier*)term)->term);
+	return 1;
+}
+
+txBoolean fxNFAProne(txTerm* term, txBoolean repeated)
+{
+	txTermCode code = term->dispatch.code;
+	if (code == fxSequenceCode)
+		return fxNFAProne(((txSequence*)term)->left, repeated) || fxNFAProne(((txSequence*)term)->right, repeated);
+	if (code == fxDisjunctionCode)
+		return repeated || fxNFAProne(((txDisjunction*)term)->left, repeated) || fxNFAProne(((txDisjunction*)term)->right, repeated);
+	if (code == fxCaptureCode)
+		return fxNFAProne(((txCapture*)term)->term, repeated);
+	if (code == fxQuantifierCode) {
+		/* the backtracking loops compare empty iterations with where the quantifier started, not with where the iteration started */
+		if ((((txQuantifier*)term)->max > ((txQuantifier*)term)->min) && fxNFANullable(((txQuantifier*)term)->term))
+			return 1;
+		if (((txQuantifier*)term)->max > 1) {
+			if (repeated)
+				return 1;
+			repeated = 1;
+		}
+		return fxNFAProne(((txQuantifier*)term)->term, repeated);
+	}
+	return 0;
+}
+
 void fxPatternParserInitialize(txPatternParser* parser)
 {
 	c_memset(parser, 0, sizeof(txPatternParser));
@@ -1612,6 +2021,8 @@ txBoolean fxCompileRegExp(void* the, txString pattern, txString modifier, txInte
 	txPatternParser _parser;
 	txPatternParser* parser = &_parser;
 	txTerm* term;
+	txPrefilter prefilter;
+	txNFA nfa;
 
 	fxPatternParserInitialize(parser);
 	if (c_setjmp(parser->jmp_buf) == 0) {
@@ -1655,7 +2066,7 @@ txBoolean fxCompileRegExp(void* the, txString pattern, txString modifier, txInte
 		parser->captureIndex++;
 		if (!term) 
 			fxPatternParserError(parser, gxErrors[mxInvalidPattern]);
-		parser->size = (4 + parser->captureIndex) * sizeof(txInteger);
+		parser->size = (6 + parser->captureIndex) * sizeof(txInteger);
 		(*term->dispatch.measure)(parser, term, 1);
 			
 		if (data) {
@@ -1672,10 +2083,17 @@ txBoolean fxCompileRegExp(void* the, txString pattern, txString modifier, txInte
 				fxPatternParserError(parser, gxErrors[mxNotEnoughMemory]);
 		}
 		if (code) {
-			txInteger offset;
+			txInteger offset, prefilterOffset, nfaOffset = 0;
 			txInteger* buffer;
 			offset = parser->size;
 			parser->size += sizeof(txInteger);
+			prefilterOffset = parser->size;
+			parser->size += fxPrefilterMeasure(parser, term, &prefilter);
+			nfa.length = (mxRegExpLinear) ? fxNFAMeasure(parser, term) : -1;
+			if ((nfa.length >= 0) && (nfa.length + 5 <= mxNFALength) && ((mxRegExpLinear > 1) || fxNFAProne(term, 0))) {
+				nfaOffset = parser->size;
+				parser->size += (4 + nfa.length + 5) * sizeof(txInteger);
+			}
 		#ifdef mxRun
 			if (the) {
 				*code = fxNewChunk(the, parser->size);
@@ -1691,6 +2109,33 @@ txBoolean fxCompileRegExp(void* the, txString pattern, txString modifier, txInte
 			buffer[1] = parser->captureIndex;
 			buffer[2 + parser->captureIndex] = parser->assertionIndex;
 			buffer[2 + parser->captureIndex + 1] = parser->quantifierIndex;
+			if (prefilter.kind) {
+				buffer[2 + parser->captureIndex + 2] = prefilterOffset;
+				fxPrefilterCode(parser, &prefilter, prefilterOffset);
+			}
+			else
+				buffer[2 + parser->captureIndex + 2] = 0;
+			buffer[2 + parser->captureIndex + 3] = nfaOffset;
+			if (nfaOffset) {
+				nfa.program = (txInteger*)(((txByte*)*code) + nfaOffset + (4 * sizeof(txInteger)));
+				nfa.length = 0;
+				nfa.threads = 1;
+				nfa.depth = 1;
+				nfa.loops = 0;
+				nfa.loopCount = 0;
+				nfa.program[nfa.length++] = cxNFASave;
+				nfa.program[nfa.length++] = 0;
+				fxNFACode(parser, term, &nfa);
+				nfa.program[nfa.length++] = cxNFASave;
+				nfa.program[nfa.length++] = 1;
+				nfa.program[nfa.length++] = cxNFAMatch;
+				nfa.depth += 2;
+				nfa.program[-4] = nfa.length;
+				nfa.program[-3] = nfa.threads;
+				/* a state can be followed again for each combination of the loops that started at the same offset */
+				nfa.program[-2] = nfa.depth << nfa.loopCount;
+				nfa.program[-1] = nfa.loopCount;
+			}
 			(*term->dispatch.code)(parser, term, 1, offset);
 			buffer = (txInteger*)(((txByte*)*code) + offset);
 			*buffer = cxMatchStep;
@@ -1718,6 +2163,14 @@ void fxDeleteRegExp(void* the, txInteger* code, txInteger* data)
 	}
 }
 
+txInteger fxMeasureRegExpData(txInteger* code)
+{
+	txInteger captureCount = code[1];
+	return captureCount * sizeof(txCaptureData)
+			+ code[2 + captureCount] * sizeof(txAssertionData)
+			+ code[2 + captureCount + 1] * sizeof(txQuantifierData);
+}
+
 // MATCH
 
 txInteger fxFindCharacter(txString input, txInteger offset, txInteger direction)
@@ -1864,7 +2317,7 @@ txBoolean fxMatchRegExp(void* the, txInteger* code, txInteger* data, txString su
 	};
 	register void * const *steps = gxSteps;
 #endif
-	txInteger stop = mxStringLength(subject);
+	txInteger stop = -1;
 	txInteger flags = code[0];
 	txCaptureData* captures = (txCaptureData*)data;
 	txCaptureData* capture;
@@ -1873,13 +2326,25 @@ txBoolean fxMatchRegExp(void* the, txInteger* code, txInteger* data, txString su
 	txAssertionData* assertion;
 	txQuantifierData* quantifiers = (txQuantifierData*)(assertions + code[2 + captureCount]);
 	txQuantifierData* quantifier;
+	txInteger* prefilter = (code[2 + captureCount + 2]) ? (txInteger*)(((txByte*)code) + code[2 + captureCount + 2]) : C_NULL;
 	txStateData* firstState = C_NULL;
 	txInteger from, to, e, f, g;
 	txBoolean result = 0;
-	if ((0 <= start) && (start <= stop)) {
+	if (code[2 + captureCount + 3]) {
+		txInteger matched = fxMatchRegExpNFA(the, code, data, subject, start);
+		if (matched >= 0)
+			return (txBoolean)matched;
+	}
+	if (0 <= start) {
 		for (;;) {
-			txInteger step = (2 + captureCount + 2) * sizeof(txInteger), sequel;
-			txInteger offset = start;
+			txInteger step = (2 + captureCount + 4) * sizeof(txInteger), sequel;
+			txInteger offset;
+			if (prefilter) {
+				start = fxPrefilterSkip(prefilter, subject, start);
+				if (start < 0)
+					break;
+			}
+			offset = start;
 		#ifdef mxMetering
 			txInteger former = step;
 		#endif
@@ -2020,6 +2485,8 @@ txBoolean fxMatchRegExp(void* the, txInteger* code, txInteger* data, txString su
 						if ((from >= 0) && (to >= 0)) {
 							e = offset;
 							f = e + (to - from);
+							if (stop < 0)
+								stop = mxStringLength(subject);
 							if (f > stop)
 								goto mxPopState;
 							g = e;
@@ -2045,7 +2512,7 @@ txBoolean fxMatchRegExp(void* the, txInteger* code, txInteger* data, txString su
 					mxCase(cxCharSetForwardStep):
 						step = *pointer++;
 						e = offset;
-						if (e == stop)
+						if (!c_read8(subject + e))
 							goto mxPopState;
 						if (!fxMatchCharacter(pointer, fxGetCharacter(subject, e, flags)))
 							goto mxPopState;
@@ -2071,7 +2538,7 @@ txBoolean fxMatchRegExp(void* the, txInteger* code, txInteger* data, txString su
 						goto mxPopState;
 					mxCase(cxLineEndStep):
 						step = *pointer;
-						if (offset == stop)
+						if (!c_read8(subject + offset))
 							mxBreak;
 						if ((flags & XS_REGEXP_M) && fxMatchCharacter((txInteger*)gxLineCharacters, fxGetCharacter(subject, offset, flags)))
 							mxBreak;
@@ -2162,14 +2629,14 @@ txBoolean fxMatchRegExp(void* the, txInteger* code, txInteger* data, txString su
 					mxCase(cxWordBreakStep):
 						step = *pointer;
 						e = (offset == 0) ? 0 : fxMatchCharacter((txInteger*)gxWordCharacters, fxGetCharacter(subject, fxFindCharacter(subject, offset, -1), flags));
-						f = (offset == stop) ? 0 : fxMatchCharacter((txInteger*)gxWordCharacters, fxGetCharacter(subject, offset, flags));
+						f = (!c_read8(subject + offset)) ? 0 : fxMatchCharacter((txInteger*)gxWordCharacters, fxGetCharacter(subject, offset, flags));
 						if (e != f)
 							mxBreak;
 						goto mxPopState;
 					mxCase(cxWordContinueStep):
 						step = *pointer;
 						e = (offset == 0) ? 0 : fxMatchCharacter((txInteger*)gxWordCharacters, fxGetCharacter(subject, fxFindCharacter(subject, offset, -1), flags));
-						f = (offset == stop) ? 0 : fxMatchCharacter((txInteger*)gxWordCharacters, fxGetCharacter(subject, offset, flags));
+						f = (!c_read8(subject + offset)) ? 0 : fxMatchCharacter((txInteger*)gxWordCharacters, fxGetCharacter(subject, offset, flags));
 						if (e == f)
 							mxBreak;
 						goto mxPopState;
@@ -2204,7 +2671,7 @@ txBoolean fxMatchRegExp(void* the, txInteger* code, txInteger* data, txString su
 				break;
 			if (result)
 				break;
-			if (start == stop)
+			if (!c_read8(subject + start))
 				break;
 			start = fxFindCharacter(subject, start, 1);
 		}
@@ -2212,6 +2679,254 @@ txBoolean fxMatchRegExp(void* the, txInteger* code, txInteger* data, txString su
 	return result;
 }
 
+txInteger fxNFAFollow(txNFAMatcher* matcher, txInteger pc, txInteger generation, txInteger offset, txInteger* list, txInteger count)
+{
+	txInteger* program = matcher->program;
+	txInteger* marks = matcher->marks;
+	txInteger* stack = matcher->stack;
+	txInteger* slots = matcher->slots;
+	txInteger slotCount = matcher->slotCount;
+	txString subject = matcher->subject;
+	txInteger flags = matcher->flags;
+	txInteger* thread;
+	txInteger depth = 0, slot, e, f;
+	stack[depth++] = pc;
+	stack[depth++] = 0;
+	while (depth) {
+		f = stack[--depth];
+		pc = stack[--depth];
+		if (pc < 0) {
+			slots[-1 - pc] = f;
+			continue;
+		}
+		for (;;) {
+			txInteger* instruction = program + pc;
+			if (marks[pc] == generation) {
+				/* a state is followed once for each set of the loops that started at this offset, since these loops die if they end here */
+				if (!matcher->loopCount || (*instruction == cxNFACharSet) || (*instruction == cxNFAMatch) || fxNFAVisited(matcher, pc, offset))
+					break;
+			}
+			else {
+				marks[pc] = generation;
+				if (matcher->loopCount) {
+					matcher->visits[pc] = 0;
+					fxNFAVisited(matcher, pc, offset);
+				}
+			}
+			switch (*instruction) {
+			case cxNFACharSet:
+			case cxNFAMatch:
+				thread = list + (count * (1 + slotCount));
+				*thread = pc;
+				c_memcpy(thread + 1, slots, slotCount * sizeof(txInteger));
+				count++;
+				break;
+			case cxNFAJump:
+				pc = instruction[1];
+				continue;
+			case cxNFASplit:
+				stack[depth++] = instruction[2];
+				stack[depth++] = 0;
+				pc = instruction[1];
+				continue;
+			case cxNFASave:
+				slot = instruction[1];
+				stack[depth++] = -1 - slot;
+				stack[depth++] = slots[slot];
+				slots[slot] = offset;
+				pc += 2;
+				continue;
+			case cxNFAProgress:
+				if (slots[instruction[1]] != offset) {
+					pc += 2;
+					continue;
+				}
+				break;
+			case cxNFAReset:
+				for (slot = 2 * instruction[1]; slot < 2 * instruction[2]; slot++) {
+					stack[depth++] = -1 - slot;
+					stack[depth++] = slots[slot];
+					slots[slot] = -1;
+				}
+				pc += 3;
+				continue;
+			case cxNFALineBegin:
+				if ((offset == 0) || ((flags & XS_REGEXP_M) && fxMatchCharacter((txInteger*)gxLineCharacters, fxGetCharacter(subject, fxFindCharacter(subject, offset, -1), flags)))) {
+					pc++;
+					continue;
+				}
+				break;
+			case cxNFALineEnd:
+				if (!c_read8(subject + offset) || ((flags & XS_REGEXP_M) && fxMatchCharacter((txInteger*)gxLineCharacters, fxGetCharacter(subject, offset, flags)))) {
+					pc++;
+					continue;
+				}
+				break;
+			case cxNFAWordBreak:
+			case cxNFAWordContinue:
+				e = (offset == 0) ? 0 : fxMatchCharacter((txInteger*)gxWordCharacters, fxGetCharacter(subject, fxFindCharacter(subject, offset, -1), flags));
+				f = (!c_read8(subject + offset)) ? 0 : fxMatchCharacter((txInteger*)gxWordCharacters, fxGetCharacter(subject, offset, flags));
+				if ((e != f) == (*instruction == cxNFAWordBreak)) {
+					pc++;
+					continue;
+				}
+				break;
+			}
+			break;
+		}
+	}
+	return count;
+}
+
+txBoolean fxNFAVisited(txNFAMatcher* matcher, txInteger pc, txInteger offset)
+{
+	txInteger* slots = matcher->slots + matcher->loopSlot;
+	txU4 loops = 0;
+	txInteger index;
+	for (index = 0; index < matcher->loopCount; index++) {
+		if (slots[index] == offset)
+			loops |= 1 << index;
+	}
+	/* a state reached again in other loops is not a duplicate: going around a loop starts it again at this offset, before the first visit has followed all its branches */
+	if (matcher->visits[pc] & ((txU4)1 << loops))
+		return 1;
+	matcher->visits[pc] |= (txU4)1 << loops;
+	return 0;
+}
+
+txInteger fxMatchRegExpNFA(void* the, txInteger* code, txInteger* data, txString subject, txInteger start)
+{
+	txInteger flags = code[0];
+	txInteger captureCount = code[1];
+	txInteger* prefilter = (code[2 + captureCount + 2]) ? (txInteger*)(((txByte*)code) + code[2 + captureCount + 2]) : C_NULL;
+	txInteger* nfa = (txInteger*)(((txByte*)code) + code[2 + captureCount + 3]);
+	txInteger length = nfa[0];
+	txInteger loopCount = nfa[3];
+	txInteger slotCount = (2 * captureCount) + loopCount;
+	txInteger threadSize = 1 + slotCount;
+	txInteger size = (length + ((loopCount) ? length : 0) + (2 * nfa[1] * threadSize) + (2 * nfa[2]) + slotCount) * sizeof(txInteger);
+	txByte* buffer;
+	txBoolean allocated = 0;
+	txNFAMatcher _matcher;
+	txNFAMatcher* matcher = &_matcher;
+	txInteger* current;
+	txInteger* next;
+	txInteger* list;
+	txInteger currentCount = 0, nextCount;
+	txInteger currentGeneration = 1, generation = 1;
+	txInteger offset = start, following, character, index;
+	txBoolean matched = 0;
+	if (start < 0)
+		return 0;
+	if (the && (((txByte*)(((txMachine*)the)->stackBottom) + size) < (txByte*)(((txMachine*)the)->stack)))
+		buffer = (txByte*)(((txMachine*)the)->stackBottom);
+	else {
+		buffer = c_malloc(size);
+		if (!buffer)
+			return -1;
+		allocated = 1;
+	}
+	matcher->program = nfa + 4;
+	matcher->marks = (txInteger*)buffer;
+	matcher->visits = (txU4*)(matcher->marks + length);
+	current = matcher->marks + ((loopCount) ? 2 * length : length);
+	next = current + (nfa[1] * threadSize);
+	matcher->stack = next + (nfa[1] * threadSize);
+	matcher->slots = matcher->stack + (2 * nfa[2]);
+	matcher->slotCount = slotCount;
+	matcher->loopSlot = 2 * captureCount;
+	matcher->loopCount = loopCount;
+	matcher->subject = subject;
+	matcher->flags = flags;
+	c_memset(matcher->marks, 0, length * sizeof(txInteger));
+	for (;;) {
+		if (!matched && ((offset == start) || !(flags & XS_REGEXP_Y))) {
+			if (!currentCount && prefilter) {
+				offset = fxPrefilterSkip(prefilter, subject, offset);
+				if (offset < 0)
+					break;
+			}
+			c_memset(matcher->slots, -1, matcher->slotCount * sizeof(txInteger));
+			currentCount = fxNFAFollow(matcher, 0, currentGeneration, offset, current, currentCount);
+			if (!currentCount) {
+				if ((flags & XS_REGEXP_Y) || !c_read8(subject + offset))
+					break;
+				currentGeneration = ++generation;
+				offset = fxFindCharacter(subject, offset, 1);
+				continue;
+			}
+		}
+		else if (!currentCount)
+			break;
+	#ifdef mxMetering
+		if (the) {
+			((txMachine*)the)->meterIndex += currentCount;
+			if (((txMachine*)the)->meterInterval && (((txMachine*)the)->meterIndex > ((txMachine*)the)->meterCount))
+				fxCheckMetering(the);
+		}
+	#endif
+		if (c_read8(subject + offset)) {
+			character = fxGetCharacter(subject, offset, flags);
+			following = fxFindCharacter(subject, offset, 1);
+		}
+		else {
+			character = -1;
+			following = offset;
+		}
+		generation++;
+		nextCount = 0;
+		for (index = 0, list = current; index < currentCount; index++, list += threadSize) {
+			txInteger* instruction = matcher->program + *list;
+			if (*instruction == cxNFAMatch) {
+				/* a match cuts the threads with a lower priority */
+				c_memcpy(data, list + 1, 2 * captureCount * sizeof(txInteger));
+				matched = 1;
+				break;
+			}
+			if ((character >= 0) && fxMatchCharacter(instruction + 1, character)) {
+				c_memcpy(matcher->slots, list + 1, matcher->slotCount * sizeof(txInteger));
+				nextCount = fxNFAFollow(matcher, *list + 2 + instruction[1], generation, following, next, nextCount);
+			}
+		}
+		list = current;
+		current = next;
+		next = list;
+		currentCount = nextCount;
+		currentGeneration = generation;
+		if (character < 0)
+			break;
+		offset = following;
+	}
+	if (allocated)
+		c_free(buffer);
+	return matched;
+}
+
+txInteger fxPrefilterSkip(txInteger* prefilter, txString subject, txInteger start)
+{
+	if (*prefilter == cxPrefilterAnchored) {
+		if (start > 0)
+			return -1;
+	}
+	else if (*prefilter == cxPrefilterLiteral) {
+		txString found = c_strstr(subject + start, (txString)(prefilter + 2));
+		if (!found)
+			return -1;
+		start = mxPtrDiff(found - subject);
+	}
+	else {
+		txU4* bits = (txU4*)(prefilter + 1);
+		txU1* p = (txU1*)subject + start;
+		txU1 c;
+		while ((c = c_read8(p)) && !(bits[c >> 5] & ((txU4)1 << (c & 31))))
+			p++;
+		if (!c)
+			return -1;
+		start = mxPtrDiff(p - (txU1*)subject);
+	}
+	return start;
+}
+
 #ifdef mxRegExpUnicodePropertyEscapes
 
 // character sets generated thanks to https://github.com/mathiasbynens/unicode-property-escapes-tests
@@ -0,0 +1,81 @@
+/*
+ * Measures BigInt arithmetic, and checks its results with identities.
+ *
+ *	xst -s bigint-benchmark.js
+ *
+ * To compare the variants, build xst with other options, then run the script with each build:
+ *
+ *	cd $MODDABLE/xs/makefiles/lin
+ *	GOAL=release BUILD_DIR=/tmp/limb32 CC="cc -DmxBigInt64=0" make -f xst.mk
+ *	GOAL=release BUILD_DIR=/tmp/schoolbook CC="cc -DmxBigIntKaratsuba=1000000" make -f xst.mk
+ *
+ * mxBigInt64 selects 64-bit limbs where the compiler has 128-bit integers, mxBigIntKaratsuba is the number of limbs from which multiplications split their operands.
+ */
+
+let seed = 0x3c6ef372 | 0;
+function random() {
+	seed ^= seed << 13;
+	seed ^= seed >>> 17;
+	seed ^= seed << 5;
+	return seed >>> 0;
+}
+function randomBigInt(bits) {
+	let result = 1n;
+	for (let i = 0; i < bits; i += 32)
+		result = (result << 32n) | BigInt(random());
+	return BigInt.asUintN(bits, result) | (1n << BigInt(bits - 1));
+}
+
+let failures = 0;
+function check(condition, message) {
+	if (!condition && (failures++ < 20))
+		print("FAIL " + message);
+}
+
+/* runs f for at least 200 milliseconds, returns microseconds per call */
+function measure(f) {
+	let count = 0, start = Date.now(), elapsed;
+	do {
+		f();
+		count++;
+		elapsed = Date.now() - start;
+	} while (elapsed < 200);
+	return (elapsed * 1000 / count).toFixed(1).padStart(12);
+}
+
+function modPow(base, exponent, modulus) {
+	let result = 1n;
+	base %= modulus;
+	while (exponent) {
+		if (exponent & 1n)
+			result = (result * base) % modulus;
+		base = (base * base) % modulus;
+		exponent >>= 1n;
+	}
+	return result;
+}
+
+print("bits".padEnd(6) + [ "mul", "square", "div", "modPow" ].map(name => (name + " µs").padStart(12)).join("") + "   " + "toString µs".padStart(12));
+for (const bits of [ 256, 1024, 2048, 4096, 16384 ]) {
+	const a = randomBigInt(bits), b = randomBigInt(bits), c = randomBigInt(bits >> 1) | 1n;
+	const product = a * b, square = a * a;
+	const quotient = product / c, remainder = product % c;
+	check(quotient * c + remainder == product, bits + " division");
+	check((remainder >= 0n) && (remainder < c), bits + " remainder");
+	check(square - b * b == (a + b) * (a - b), bits + " square");
+	check((a * (b + c)) - (a * b) == a * c, bits + " distributivity");
+	check(BigInt(a.toString()) == a, bits + " toString");
+	const modulus = randomBigInt(Math.min(bits, 2048)) | 1n;
+	const exponent = randomBigInt(Math.min(bits, 2048) >> 3);
+	const power = modPow(a, exponent, modulus);
+	check(modPow(a, exponent + 1n, modulus) == (power * a) % modulus, bits + " modPow");
+	print(String(bits).padEnd(6)
+		+ measure(() => a * b)
+		+ measure(() => a * a)
+		+ measure(() => product / c)
+		+ ((bits <= 2048) ? measure(() => modPow(a, exponent, modulus)) : "           -")
+		+ "   " + measure(() => a.toString()));
+}
+
+if (failures)
+	throw new Error(failures + " failures");
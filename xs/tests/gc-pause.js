@@ -0,0 +1,82 @@
+/*
+ * Measures the pauses of full collections on heaps of growing sizes, and checks that the collections keep what is reachable.
+ *
+ *	xst -s gc-pause.js
+ *
+ * The Linux xst marks and sweeps large heaps with several threads. To compare with a collection on the calling thread alone, build xst without them, then run the script with each build:
+ *
+ *	cd $MODDABLE/xs/makefiles/lin
+ *	GOAL=release BUILD_DIR=/tmp/serial COLLECT_THREADS=0 make -f xst.mk
+ *
+ * Each heap mixes records, arrays, linked lists, maps, closures and weak collections. The pauses are in milliseconds.
+ */
+
+if (typeof $262 != "object")
+	throw new Error("gc-pause needs $262.gc");
+const gc = $262.gc;
+
+let failures = 0;
+function check(condition, message) {
+	if (!condition && (failures++ < 20))
+		print("FAIL " + message);
+}
+
+function build(count) {
+	const records = [], keys = [], weakMap = new WeakMap, weakSet = new WeakSet, map = new Map;
+	let list = null;
+	for (let i = 0; i < count; i++) {
+		const record = { index: i, name: "r" + i, values: [ i, i + 1, i + 2 ], next: null };
+		records.push(record);
+		list = { record, next: list };
+		if (i % 4 == 0)
+			map.set(i, record);
+		if (i % 12 == 0)
+			map.delete(i);
+		if (i % 8 == 0) {
+			const key = {};
+			keys.push(key);
+			weakMap.set(key, { index: i });
+			weakSet.add(record);
+		}
+		if (i % 16 == 0)
+			record.get = () => record.index;
+		else
+			weakMap.set({}, i);
+	}
+	return { records, keys, weakMap, weakSet, map, list };
+}
+
+function verify(heap, count) {
+	let length = 0, sum = 0;
+	for (let node = heap.list; node; node = node.next) {
+		length++;
+		sum += node.record.values[2] - node.record.index;
+	}
+	check(length == count, count + " list length");
+	check(sum == 2 * count, count + " list values");
+	check(heap.records.every((record, i) => (record.name == "r" + i) && (!record.get || (record.get() == i))), count + " records");
+	check(heap.map.size == Math.ceil(count / 4) - Math.ceil(count / 12), count + " map size");
+	check(heap.keys.every((key, i) => heap.weakMap.get(key).index == i * 8), count + " weak map");
+	check(heap.records.every((record, i) => heap.weakSet.has(record) == (i % 8 == 0)), count + " weak set");
+}
+
+function pause() {
+	const start = Date.now();
+	gc();
+	return Date.now() - start;
+}
+
+print("records".padEnd(10) + [ "min", "median", "max" ].map(name => (name + " ms").padStart(10)).join(""));
+for (const count of [ 10000, 50000, 200000, 500000 ]) {
+	const heap = build(count);
+	const pauses = [];
+	for (let i = 0; i < 7; i++)
+		pauses.push(pause());
+	verify(heap, count);
+	pauses.sort((a, b) => a - b);
+	print(String(count).padEnd(10) + [ pauses[0], pauses[3], pauses[6] ].map(value => String(value).padStart(10)).join(""));
+}
+
+if (failures)
+	throw new Error(failures + " failures");
+print("gc-pause: ok");
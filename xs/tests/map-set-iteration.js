@@ -0,0 +1,145 @@
+/*
+ * Checks that Map and Set iterators and forEach survive deletions, clears and collections.
+ *
+ *	xst -s map-set-iteration.js
+ *
+ * The collector unlinks deleted entries, except the ones that iterators and forEach are on.
+ */
+
+let failures = 0;
+function check(actual, expected, message) {
+	if (actual !== expected) {
+		if (failures++ < 20)
+			print("FAIL " + message + ": " + actual + " instead of " + expected);
+	}
+}
+const gc = (typeof $262 == "object") ? $262.gc : function() {};
+
+let seed = 0x2468ace1 | 0;
+function random(n) {
+	seed ^= seed << 13;
+	seed ^= seed >>> 17;
+	seed ^= seed << 5;
+	return (seed >>> 0) % n;
+}
+
+/* a model of insertion order that iterates the way the specification does */
+class Model {
+	constructor() {
+		this.keys = [];
+		this.values = [];
+	}
+	add(key, value) {
+		const index = this.keys.indexOf(key);
+		if (index < 0) {
+			this.keys.push(key);
+			this.values.push(value);
+		}
+		else
+			this.values[index] = value;
+	}
+	delete(key) {
+		const index = this.keys.indexOf(key);
+		if (index >= 0)
+			this.keys[index] = this.values[index] = this;
+	}
+	clear() {
+		this.keys.fill(this);
+		this.values.fill(this);
+	}
+	*entries() {
+		for (let index = 0; index < this.keys.length; index++) {
+			if (this.keys[index] !== this)
+				yield [ this.keys[index], this.values[index] ];
+		}
+	}
+}
+
+function mutate(map, set, model) {
+	const key = random(64);
+	switch (random(8)) {
+	case 0:
+	case 1:
+	case 2:
+		map.set(key, key * 2);
+		set.add(key);
+		model.add(key, key * 2);
+		break;
+	case 3:
+	case 4:
+		map.delete(key);
+		set.delete(key);
+		model.delete(key);
+		break;
+	case 5:
+		if (random(16) == 0) {
+			map.clear();
+			set.clear();
+			model.clear();
+		}
+		break;
+	case 6:
+		gc();
+		break;
+	}
+}
+
+for (let round = 0; round < 200; round++) {
+	const map = new Map, set = new Set, model = new Model;
+	for (let i = 0; i < 48; i++)
+		mutate(map, set, model);
+	const mapIterator = map.entries(), setIterator = set.values(), modelIterator = model.entries();
+	const abandoned = [ map.keys(), set.keys() ];
+	abandoned.forEach(iterator => iterator.next());
+	for (let step = 0; step < 200; step++) {
+		const expected = modelIterator.next();
+		const mapResult = mapIterator.next(), setResult = setIterator.next();
+		check(mapResult.done, expected.done, "map done " + round + "/" + step);
+		check(setResult.done, expected.done, "set done " + round + "/" + step);
+		if (expected.done)
+			break;
+		check(mapResult.value[0], expected.value[0], "map key " + round + "/" + step);
+		check(mapResult.value[1], expected.value[1], "map value " + round + "/" + step);
+		check(setResult.value, expected.value[0], "set value " + round + "/" + step);
+		mutate(map, set, model);
+		mutate(map, set, model);
+	}
+	check(map.size, [ ...model.entries() ].length, "map size " + round);
+	check(set.size, [ ...model.entries() ].length, "set size " + round);
+
+	const seen = [];
+	map.forEach((value, key) => {
+		seen.push(key);
+		if (seen.length < 100)
+			mutate(map, set, model);
+	});
+	const count = seen.length;
+	try {
+		set.forEach(value => {
+			set.delete(value);
+			gc();
+			throw value;
+		});
+	}
+	catch {
+	}
+	check(count >= map.size, true, "map forEach " + round);
+}
+
+/* deleted entries do not accumulate, even with abandoned iterators */
+const map = new Map;
+for (let i = 0; i < 100000; i++) {
+	map.set(i, i);
+	const iterator = map.keys();
+	iterator.next();
+	map.delete(i);
+	if (i % 1000 == 0)
+		gc();
+	check(map.size, 0, "map size");
+}
+map.set("last", 1);
+check([ ...map.keys() ].join(), "last", "map keys");
+
+if (failures)
+	throw new Error(failures + " failures");
+print("map-set-iteration: ok");
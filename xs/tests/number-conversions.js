@@ -0,0 +1,93 @@
+/*
+ * Checks conversions between numbers and strings.
+ *
+ *	xst -s number-conversions.js
+ *
+ * Number, parseFloat and JSON.parse round half to even, String and JSON.stringify print the shortest string that converts back to the same number.
+ * toFixed, toExponential and toPrecision pick the larger n on ties.
+ */
+
+let failures = 0;
+function fail(message) {
+	if (failures++ < 20)
+		print("FAIL " + message);
+}
+function check(actual, expected, message) {
+	if (!Object.is(actual, expected))
+		fail(message + ": " + actual + " instead of " + expected);
+}
+
+let seed = 0x13579bdf | 0;
+function random() {
+	seed ^= seed << 13;
+	seed ^= seed >>> 17;
+	seed ^= seed << 5;
+	return seed >>> 0;
+}
+const view = new DataView(new ArrayBuffer(8));
+function roundTrip(x) {
+	check(Number(String(x)), x, "Number(String(" + x + "))");
+	check(JSON.parse(JSON.stringify(x)), x, "JSON.parse(JSON.stringify(" + x + "))");
+	check(parseFloat(x.toExponential()), x, "parseFloat(" + x + ".toExponential())");
+	check(Number(x.toPrecision(17)), x, "Number(" + x + ".toPrecision(17))");
+}
+for (let i = 0; i < 100000; i++) {
+	view.setUint32(0, random());
+	view.setUint32(4, random());
+	const x = view.getFloat64(0);
+	if (isFinite(x))
+		roundTrip(x);
+	view.setUint32(0, 0x43300000 + (random() & 0x3FFFFF));
+	view.setUint32(4, random());
+	roundTrip(view.getFloat64(0));
+	roundTrip(random() * 4294967296 + random());
+	roundTrip(-(random() * 2097152 + (random() & 0x1FFFFF)) * 2 ** ((random() % 40) - 20));
+}
+[ 0, 5e-324, 2.2250738585072014e-308, 2.225073858507201e-308, 0.1, 0.3, 1e21, 1e23, 2 ** 53, 2 ** 53 + 2, 22355055810082772, Number.MAX_VALUE ].forEach(roundTrip);
+
+[
+	[ "9007199254740993", 9007199254740992 ],
+	[ "9007199254740993.0", 9007199254740992 ],
+	[ "9007199254740995", 9007199254740996 ],
+	[ "9007199254740993.0000000001", 9007199254740994 ],
+	[ "22355055810082770", 22355055810082768 ],
+	[ "2.4703282292062327e-324", 0 ],
+	[ "2.4703282292062328e-324", 5e-324 ],
+	[ "1.7976931348623158e308", Number.MAX_VALUE ],
+	[ "1.7976931348623159e308", Infinity ],
+].forEach(([ string, expected ]) => {
+	check(Number(string), expected, "Number(\"" + string + "\")");
+	check(parseFloat(string), expected, "parseFloat(\"" + string + "\")");
+	check(JSON.parse(string), expected, "JSON.parse(\"" + string + "\")");
+});
+
+[
+	[ 22355055810082772, "22355055810082772" ],
+	[ 123456789012345680000, "123456789012345680000" ],
+	[ 0.1 + 0.2, "0.30000000000000004" ],
+	[ 5e-324, "5e-324" ],
+	[ -1e-7, "-1e-7" ],
+].forEach(([ x, expected ]) => check(String(x), expected, "String(" + expected + ")"));
+
+[
+	[ 2.5, "toFixed", 0, "3" ],
+	[ -2.5, "toFixed", 0, "-3" ],
+	[ 1.5, "toFixed", 0, "2" ],
+	[ 12.5, "toFixed", 0, "13" ],
+	[ 1.125, "toFixed", 2, "1.13" ],
+	[ -1.125, "toFixed", 2, "-1.13" ],
+	[ 0.125, "toFixed", 2, "0.13" ],
+	[ 0.0625, "toFixed", 3, "0.063" ],
+	[ 183791735853868.3125, "toFixed", 3, "183791735853868.313" ],
+	[ 2.5, "toPrecision", 1, "3" ],
+	[ 25, "toPrecision", 1, "3e+1" ],
+	[ 1.25, "toPrecision", 2, "1.3" ],
+	[ 1005, "toPrecision", 3, "1.01e+3" ],
+	[ 2.5, "toExponential", 0, "3e+0" ],
+	[ 4.5, "toExponential", 0, "5e+0" ],
+	[ 1015, "toExponential", 2, "1.02e+3" ],
+].forEach(([ x, method, digits, expected ]) => check(x[method](digits), expected, "(" + x + ")." + method + "(" + digits + ")"));
+
+if (failures)
+	throw new Error(failures + " failures");
+print("number-conversions: ok");
@@ -0,0 +1,141 @@
+/*
+ * Checks the shortest strings of numbers against an exact computation with BigInt.
+ *
+ *	xst -s number-to-string.js
+ *
+ * String and JSON.stringify go through Grisu3, or dtoa for the numbers Grisu3 rejects. Building XS with -DmxGrisu=0 checks dtoa alone.
+ * The expected digits are the fewest digits that convert back to the number, the closest to the number, the even ones on ties.
+ */
+
+let failures = 0;
+function fail(message) {
+	if (failures++ < 20)
+		print("FAIL " + message);
+}
+
+let seed = 0x1b873593 | 0;
+function random() {
+	seed ^= seed << 13;
+	seed ^= seed >>> 17;
+	seed ^= seed << 5;
+	return seed >>> 0;
+}
+
+const view = new DataView(new ArrayBuffer(8));
+const powers = [ 1n ];
+function power(n) {
+	while (powers.length <= n)
+		powers.push(powers[powers.length - 1] * 10n);
+	return powers[n];
+}
+
+/* x is m * 2^e, the numbers between low and high convert to x, all values are scaled by 4 * d to stay integral */
+function shortest(x) {
+	view.setFloat64(0, x);
+	const high = view.getUint32(0), low = view.getUint32(4);
+	const exponent = (high >>> 20) & 0x7FF;
+	let m = (BigInt(high & 0xFFFFF) << 32n) | BigInt(low);
+	let e;
+	if (exponent) {
+		m |= 1n << 52n;
+		e = exponent - 1075;
+	}
+	else
+		e = -1074;
+	const d = (e >= 0) ? 1n : 1n << BigInt(-e);
+	const n = (e >= 0) ? m << BigInt(e) : m;
+	const u = (e >= 0) ? 1n << BigInt(e) : 1n;
+	const value = 4n * n;
+	const upper = value + 2n * u;
+	const lower = value - (((m == (1n << 52n)) && (exponent > 1)) ? u : 2n * u);
+	const inclusive = (m & 1n) == 0n;
+	const scale = 4n * d;
+
+	/* 10^p <= x < 10^(p+1) */
+	let p = Math.floor(Math.log10(x));
+	const compare = (t) => (t >= 0) ? value - scale * power(t) : value * power(-t) - scale;
+	while (compare(p) < 0n)
+		p--;
+	while (compare(p + 1) >= 0n)
+		p++;
+
+	for (let k = 1; k <= 17; k++) {
+		const t = p - k + 1;
+		/* s * 10^t compared with v / scale is s * numerator compared with v * denominator */
+		const numerator = (t >= 0) ? scale * power(t) : scale;
+		const denominator = (t >= 0) ? 1n : power(-t);
+		const floor = (value * denominator) / numerator;
+		let best = null, bestDistance;
+		for (const s of [ floor, floor + 1n ]) {
+			const v = s * numerator;
+			const belowUpper = inclusive ? v <= upper * denominator : v < upper * denominator;
+			const aboveLower = inclusive ? v >= lower * denominator : v > lower * denominator;
+			if (belowUpper && aboveLower) {
+				let distance = v - value * denominator;
+				if (distance < 0n)
+					distance = -distance;
+				if ((best === null) || (distance < bestDistance) || ((distance == bestDistance) && ((s & 1n) == 0n))) {
+					best = s;
+					bestDistance = distance;
+				}
+			}
+		}
+		if (best !== null) {
+			let digits = best.toString();
+			let point = t + digits.length;
+			digits = digits.replace(/0+$/, "");
+			return { digits, point };
+		}
+	}
+	throw new Error("no digits for " + x);
+}
+
+/* the digits and the position of the decimal point in a string from String or JSON.stringify */
+function parse(string) {
+	const match = /^-?(\d+)(?:\.(\d+))?(?:e([+-]\d+))?$/.exec(string);
+	if (!match)
+		return null;
+	let digits = match[1] + (match[2] ?? "");
+	let point = match[1].length + Number(match[3] ?? 0);
+	const leading = /^0*/.exec(digits)[0].length;
+	digits = digits.slice(leading).replace(/0+$/, "");
+	point -= leading;
+	return { digits, point };
+}
+
+let count = 0;
+function check(x) {
+	if (!isFinite(x) || (x == 0))
+		return;
+	count++;
+	const expected = shortest(Math.abs(x));
+	for (const string of [ String(x), JSON.stringify(x) ]) {
+		const actual = parse(string);
+		if (!actual || (actual.digits !== expected.digits) || (actual.point !== expected.point))
+			fail(string + " instead of 0." + expected.digits + "e" + expected.point);
+	}
+}
+
+for (let i = 0; i < 20000; i++) {
+	view.setUint32(0, random());
+	view.setUint32(4, random());
+	check(view.getFloat64(0));
+	view.setUint32(0, random() & 0x000FFFFF);
+	view.setUint32(4, random());
+	check(view.getFloat64(0));
+	check((random() % 1000000) / 10 ** (random() % 10));
+	check((random() * 4294967296 + random()) * 2 ** ((random() % 64) - 32));
+}
+for (let e = -1074; e <= 1023; e++) {
+	const x = 2 ** e;
+	check(x);
+	check(x * (1 + Number.EPSILON));
+	check(x * (1 - Number.EPSILON / 2));
+}
+for (let e = -323; e <= 308; e++)
+	check(Number("1e" + e));
+[ 5e-324, 1e-323, 2.2250738585072014e-308, 2.225073858507201e-308, 9007199254740991, 9007199254740992, 18014398509481984, 1e21, 1e23, 5e-7, 1.7976931348623157e308 ].forEach(check);
+
+if (failures)
+	throw new Error(failures + " failures");
+print("number-to-string: ok (" + count + " numbers)");
@@ -0,0 +1,58 @@
+/*
+ * Checks the regexps whose repetitions can match nothing, which run on the NFA of fxMatchRegExpNFA.
+ *
+ *	xst -s regexp-empty-iterations.js
+ *
+ * An optional iteration that matches nothing fails, as in the RepeatMatcher of the specification. The NFA saves where such iterations start, and its threads die when they end there.
+ * The expected matches come from the specification. The long subjects check that the matches take linear time.
+ */
+
+let failures = 0;
+function check(actual, expected, message) {
+	if (actual !== expected) {
+		if (failures++ < 20)
+			print("FAIL " + message + ": " + actual + " instead of " + expected);
+	}
+}
+
+const subjects = [ "", "b", "ab", "aab", "aaab", "abab", "aabc", "cad", "abcabd", "aaax", "a b" ];
+const cases = [
+	[ "(a*)*b", [ null, ["b",null], ["ab","a"], ["aab","aa"], ["aaab","aaa"], ["ab","a"], ["aab","aa"], null, ["ab","a"], null, ["b",null] ] ],
+	[ "(a?)+b", [ null, ["b",""], ["ab","a"], ["aab","a"], ["aaab","a"], ["ab","a"], ["aab","a"], null, ["ab","a"], null, ["b",""] ] ],
+	[ "(a|a?)+b", [ null, ["b",""], ["ab","a"], ["aab","a"], ["aaab","a"], ["ab","a"], ["aab","a"], null, ["ab","a"], null, ["b",""] ] ],
+	[ "((a+)?)+b", [ null, ["b","",null], ["ab","a","a"], ["aab","aa","aa"], ["aaab","aaa","aaa"], ["ab","a","a"], ["aab","aa","aa"], null, ["ab","a","a"], null, ["b","",null] ] ],
+	[ "(a*)*", [ ["",null], ["",null], ["a","a"], ["aa","aa"], ["aaa","aaa"], ["a","a"], ["aa","aa"], ["",null], ["a","a"], ["aaa","aaa"], ["a","a"] ] ],
+	[ "(a?)+?b", [ null, ["b",""], ["ab","a"], ["aab","a"], ["aaab","a"], ["ab","a"], ["aab","a"], null, ["ab","a"], null, ["b",""] ] ],
+	[ "(?:a|())*b", [ null, ["b",null], ["ab",null], ["aab",null], ["aaab",null], ["ab",null], ["aab",null], null, ["ab",null], null, ["b",null] ] ],
+	[ "(a*?)*?b", [ null, ["b",null], ["ab","a"], ["aab","a"], ["aaab","a"], ["ab","a"], ["aab","a"], null, ["ab","a"], null, ["b",null] ] ],
+	[ "((a*)*)*b", [ null, ["b",null,null], ["ab","a","a"], ["aab","aa","aa"], ["aaab","aaa","aaa"], ["ab","a","a"], ["aab","aa","aa"], null, ["ab","a","a"], null, ["b",null,null] ] ],
+	[ "(?:(a?)(b?))*c", [ null, null, null, null, null, null, ["aabc","a","b"], ["c",null,null], ["abc","a","b"], null, null ] ],
+	[ "(a*){2,4}b", [ null, ["b",""], ["ab",""], ["aab",""], ["aaab",""], ["ab",""], ["aab",""], null, ["ab",""], null, ["b",""] ] ],
+	[ "(|a)+b", [ null, ["b",""], ["ab","a"], ["aab","a"], ["aaab","a"], ["ab","a"], ["aab","a"], null, ["ab","a"], null, ["b",""] ] ],
+	[ "(a|)*?$", [ ["",null], ["",null], ["",null], ["",null], ["",null], ["",null], ["",null], ["",null], ["",null], ["",null], ["",null] ] ],
+	[ "((a?)*){3}x", [ null, null, null, null, null, null, null, null, null, ["aaax","",null], null ] ],
+	[ "(((a?)*)*)*b", [ null, ["b",null,null,null], ["ab","a","a","a"], ["aab","aa","aa","a"], ["aaab","aaa","aaa","a"], ["ab","a","a","a"], ["aab","aa","aa","a"], null, ["ab","a","a","a"], null, ["b",null,null,null] ] ],
+	[ "((((a?)*)*)*)*b", [ null, ["b",null,null,null,null], ["ab","a","a","a","a"], ["aab","aa","aa","aa","a"], ["aaab","aaa","aaa","aaa","a"], ["ab","a","a","a","a"], ["aab","aa","aa","aa","a"], null, ["ab","a","a","a","a"], null, ["b",null,null,null,null] ] ],
+	[ "(?:(?:(?:(a|)*?)*)*)*?b", [ null, ["b",null], ["ab","a"], ["aab","a"], ["aaab","a"], ["ab","a"], ["aab","a"], null, ["ab","a"], null, ["b",null] ] ],
+	[ "((a?b?)*?(c?)*)*d", [ null, null, null, null, null, null, null, ["cad","a","a",null], ["abcabd","ab","ab",null], null, null ] ],
+	[ "(a?){3,}b", [ null, ["b",""], ["ab",""], ["aab",""], ["aaab","a"], ["ab",""], ["aab",""], null, ["ab",""], null, ["b",""] ] ],
+	[ "(a??){2,4}?b", [ null, ["b",""], ["ab","a"], ["aab","a"], ["aaab","a"], ["ab","a"], ["aab","a"], null, ["ab","a"], null, ["b",""] ] ],
+	[ "(?:(a)|b?)*c", [ null, null, null, null, null, null, ["aabc",null], ["c",null], ["abc",null], null, null ] ],
+	[ "(\\b|a)*b", [ null, ["b",null], ["ab","a"], ["aab","a"], ["aaab","a"], ["ab","a"], ["aab","a"], null, ["ab","a"], null, ["b",null] ] ],
+];
+for (const [ source, results ] of cases) {
+	const regexp = new RegExp(source);
+	subjects.forEach((subject, index) => check(JSON.stringify(regexp.exec(subject)), JSON.stringify(results[index]), "/" + source + "/.exec(" + JSON.stringify(subject) + ")"));
+}
+
+const start = Date.now();
+const long = "a".repeat(100000);
+for (const regexp of [ /(a*)*b/, /(a?)+b/, /(a|a?)+b/, /((a+)?)+b/, /((a?)*)*b/ ]) {
+	check(regexp.test(long), false, regexp + " on a long subject");
+	check(regexp.exec(long + "b")[0].length, 100001, regexp + " on a long match");
+}
+check(Date.now() - start < 10000, true, "linear time");
+
+if (failures)
+	throw new Error(failures + " failures");
+print("regexp-empty-iterations: ok");
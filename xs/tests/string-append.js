@@ -0,0 +1,182 @@
+/*
+ * Checks the string builtins on strings built with s += x, which XS appends in place when the local owns its string.
+ *
+ *	xst -s string-append.js
+ *
+ * Each builtin gets the same arguments with an appended string and with a joined string, and must return the same result.
+ * Copies of an appended string, in other variables, arrays, objects, maps or closures, must not change with later appends.
+ */
+
+let failures = 0;
+function fail(message) {
+	if (failures++ < 20)
+		print("FAIL " + message);
+}
+function check(actual, expected, message) {
+	if (actual !== expected)
+		fail(message + ": " + JSON.stringify(actual) + " instead of " + JSON.stringify(expected));
+}
+function same(actual, expected, message) {
+	check(JSON.stringify(actual), JSON.stringify(expected), message);
+}
+
+const pieces = [ "a", "bc", "", "def", " ", "Ab", "é", "\u{1F600}", "\uD800", "x,y", "\n", "1.5", "AbAb", "İ" ];
+let seed = 0x0badf00d | 0;
+function random(n) {
+	seed ^= seed << 13;
+	seed ^= seed >>> 17;
+	seed ^= seed << 5;
+	return (seed >>> 0) % n;
+}
+function choose(count) {
+	const parts = [];
+	for (let i = 0; i < count; i++)
+		parts.push(pieces[random(pieces.length)]);
+	return parts;
+}
+function append(parts) {
+	let s = "";
+	for (const part of parts)
+		s += part;
+	return s;
+}
+
+const calls = [
+	s => s.length,
+	s => s.at(-1),
+	s => s.charAt(3),
+	s => s.charCodeAt(2),
+	s => s.codePointAt(1),
+	s => s.concat("!", s),
+	s => s.endsWith("Ab"),
+	s => s.includes("bc"),
+	s => s.indexOf("Ab", 1),
+	s => s.lastIndexOf("a"),
+	s => s.localeCompare("bc"),
+	s => s.match(/[a-z]+/g),
+	s => [ ...s.matchAll(/A(b)/g) ].map(m => m.index),
+	s => s.padEnd(s.length + 5, "-="),
+	s => s.padStart(s.length + 3, "0"),
+	s => s.repeat(3),
+	s => s.replace("Ab", "$&$&"),
+	s => s.replaceAll("b", x => x.toUpperCase()),
+	s => s.search(/\d/),
+	s => s.slice(2, -2),
+	s => s.split(","),
+	s => s.split(""),
+	s => s.startsWith("a"),
+	s => s.substr(-4, 3),
+	s => s.substring(5, 1),
+	s => s.toLowerCase(),
+	s => s.toUpperCase(),
+	s => s.trim(),
+	s => s.trimStart(),
+	s => s.trimEnd(),
+	s => [ ...s ].length,
+	s => String.raw({ raw: s }, 0, 1),
+	s => JSON.parse(JSON.stringify(s)),
+	s => ({ [s]: 1 })[s],
+	s => new Map([ [ s, 1 ] ]).get(s.slice(0)),
+	s => s < "b",
+];
+
+for (let round = 0; round < 500; round++) {
+	const parts = choose(random(40));
+	const joined = parts.join("");
+	const appended = append(parts);
+	check(appended, joined, "append " + round);
+	calls.forEach((call, index) => same(call(appended), call(joined), "call " + index + " round " + round));
+}
+
+/* copies */
+{
+	let s = "";
+	const copies = [], object = {}, map = new Map;
+	let copy;
+	for (let i = 0; i < 100; i++) {
+		s += i;
+		if (i == 10)
+			copy = s;
+		if (i == 20)
+			copies.push(s);
+		if (i == 30)
+			object.s = s;
+		if (i == 40)
+			map.set(s, s);
+	}
+	check(copy, append([ ...Array(11).keys() ]), "copy");
+	check(copies[0], append([ ...Array(21).keys() ]), "array");
+	check(object.s, append([ ...Array(31).keys() ]), "object");
+	check([ ...map.keys() ][0], append([ ...Array(41).keys() ]), "map key");
+	check(map.get(append([ ...Array(41).keys() ])), append([ ...Array(41).keys() ]), "map value");
+	check(s, append([ ...Array(100).keys() ]), "appended");
+}
+{
+	let s = "x";
+	const read = () => s;
+	const reads = [];
+	for (let i = 0; i < 10; i++) {
+		s += i;
+		reads.push(read());
+	}
+	check(reads.join(), "x0,x01,x012,x0123,x01234,x012345,x0123456,x01234567,x012345678,x0123456789", "closure");
+}
+{
+	let s = "", t = "";
+	for (let i = 0; i < 50; i++) {
+		s += "ab";
+		t = s;
+		s += "c";
+	}
+	check(t.length, 149, "alias");
+	check(s.length, 150, "aliased");
+	check(t + "c", s, "alias content");
+}
+{
+	let s = "start";
+	const thrower = { toString() { throw new Error("no") } };
+	for (let i = 0; i < 5; i++) {
+		try {
+			s += thrower;
+		}
+		catch {
+		}
+		s += i;
+	}
+	check(s, "start01234", "throw");
+}
+{
+	let s = 1;
+	s += 2;
+	s += "3";
+	s += 4;
+	check(s, "334", "numbers");
+	let u = "u";
+	u += 1n;
+	u += null;
+	u += undefined;
+	u += [ 1, 2 ];
+	check(u, "u1nullundefined1,2", "conversions");
+}
+{
+	function* generate() {
+		let s = "";
+		for (let i = 0; i < 5; i++) {
+			s += i;
+			yield s;
+		}
+	}
+	check([ ...generate() ].join(), "0,01,012,0123,01234", "generator");
+}
+{
+	let s = "";
+	for (let i = 0; i < 100000; i++)
+		s += "0123456789";
+	check(s.length, 1000000, "long");
+	check(s.lastIndexOf("9"), 999999, "long lastIndexOf");
+	check(s.slice(500000, 500010), "0123456789", "long slice");
+}
+
+if (failures)
+	throw new Error(failures + " failures");
+print("string-append: ok");
@@ -474,6 +474,7 @@ int main(int argc, char* argv[])
 			mxBreakpoints = mxUndefined;
 			mxHostInspectors = mxUndefined;
 			mxInstanceInspectors = mxUndefined;
+			mxRegExpCacheList = mxUndefined;
 			
 			if (linker->stripFlag) {
 				fxPrepareHome(the);
@@ -488,7 +489,7 @@ int main(int argc, char* argv[])
 				fxPrepareProjection(the);
 		
 			linker->bigintSize = 0;
-			linker->slotSize = 0;
+			linker->entrySize = 0;
 			count = fxPrepareHeap(the);
 			if (linker->freezeFlag) {
 				txInteger count = fxCheckAliases(the);
@@ -557,11 +558,11 @@ int main(int argc, char* argv[])
 				linker->bigintData = fxNewLinkerChunk(linker, linker->bigintSize * sizeof(txU4));
 				linker->bigintSize = 0;
 			}
-			if (linker->slotSize) {
-				fprintf(file, "#define mxSlotCount %d\n", (int)linker->slotSize);
-				fprintf(file, "static const txSlot* const gxSlotData[mxSlotCount] ICACHE_FLASH1_ATTR;\n");
-				linker->slotData = fxNewLinkerChunk(linker, linker->slotSize * sizeof(txSlot*));
-				linker->slotSize = 0;
+			if (linker->entrySize) {
+				fprintf(file, "#define mxEntryCount %d\n", (int)linker->entrySize);
+				fprintf(file, "static const txHashEntry gxEntryData[mxEntryCount] ICACHE_FLASH1_ATTR;\n");
+				linker->entryData = fxNewLinkerChunk(linker, linker->entrySize * sizeof(txHashEntry));
+				linker->entrySize = 0;
 			}
 			fprintf(file, "#define mxHeapCount %d\n", (int)count);
 			fprintf(file, "static const txSlot gxHeap[mxHeapCount];\n");
@@ -627,9 +628,9 @@ int main(int argc, char* argv[])
 				}
 				fprintf(file, "\n};\n\n");
 			}
-			if (linker->slotSize) {
-				fprintf(file, "static const txSlot* const gxSlotData[mxSlotCount] ICACHE_FLASH1_ATTR = {\n");
-				fxPrintTable(the, file, linker->slotSize, linker->slotData);
+			if (linker->entrySize) {
+				fprintf(file, "static const txHashEntry gxEntryData[mxEntryCount] ICACHE_FLASH1_ATTR = {\n");
+				fxPrintEntries(the, file, linker->entrySize, linker->entryData);
 				fprintf(file, "};\n\n");
 			}
 // 			fprintf(file, "static const txSlot* gxGlobals[mxGlobalsCount] ICACHE_FLASH1_ATTR = {\n");
@@ -735,11 +736,9 @@ void fxBuildKeys(txMachine* the)
 	txID c = linker->symbolIndex, i;
 	for (i = 0; i < XS_SYMBOL_ID_COUNT; i++) {
 		txLinkerSymbol* symbol = linker->symbolArray[i];
-		txID id = the->keyIndex;
 		txSlot* description = fxNewSlot(the);
 		fxCopyStringC(the, description, symbol->string);
-		the->keyArray[id] = description;
-		the->keyIndex++;
+		fxNewKey(the, description);
 	}
 	for (; i < c; i++) {
 		txLinkerSymbol* symbol = linker->symbolArray[i];
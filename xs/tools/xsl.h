@@ -109,8 +109,8 @@ struct sxLinker {
 	txU4* bigintData;
 	txSize bigintSize;
 	
-	txSlot** slotData;
-	txSize slotSize;
+	txHashEntry* entryData;
+	txSize entrySize;
 	
 	txString base;
 	txSize baseLength;
@@ -195,7 +195,7 @@ struct sxLinkerSymbol {
 	txID ID;
 	txInteger length;
 	txString string;
-	txSize sum;
+	txU4 sum;
 	txFlag flag;
 };
 
@@ -262,6 +262,7 @@ extern txInteger fxPrepareHeap(txMachine* the);
 extern void fxPrepareHome(txMachine* the);
 extern void fxPrepareProjection(txMachine* the);
 extern void fxPrintBuilders(txMachine* the, FILE* file);
+extern void fxPrintEntries(txMachine* the, FILE* file, txSize count, txHashEntry* entries);
 extern void fxPrintHeap(txMachine* the, FILE* file, txInteger count);
 extern void fxPrintStack(txMachine* the, FILE* file);
 extern void fxPrintTable(txMachine* the, FILE* file, txSize modulo, txSlot** table);
@@ -482,19 +482,19 @@ txLinkerSymbol* fxNewLinkerSymbol(txLinker* linker, txString theString, txFlag f
 {
 	txString aString;
 	txSize aLength;
-	txSize aSum;
+	txU4 aSum;
 	txSize aModulo;
 	txLinkerSymbol* aSymbol;
 	txID anID;
 	
 	aString = theString;
 	aLength = 0;
-	aSum = 0;
+	aSum = mxNameSumSeed;
 	while(*aString != 0) {
 		aLength++;
-		aSum = (aSum << 1) + *aString++;
+		aSum = mxNameSum(aSum, *aString++);
 	}
-	aSum &= 0x7FFFFFFF;
+	aSum &= mxNameSumMask;
 	aModulo = aSum % linker->symbolModulo;
 	aSymbol = linker->symbolTable[aModulo];
 	while (aSymbol != C_NULL) {
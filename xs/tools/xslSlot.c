@@ -558,9 +558,7 @@ txSlot* fxNewFunctionName(txMachine* the, txSlot* instance, txID id, txIndex ind
 
 txSlot* fxNextHostFunctionProperty(txMachine* the, txSlot* property, txCallback call, txInteger length, txID id, txFlag flag)
 {
-	property = property->next = fxNewSlot(the);
-	property->flag = flag;
-	property->ID = id;
+	property = fxNewProperty(the, &(property->next), id, flag);
 	fxSetHostFunctionProperty(the, property, call, length, id);
 	return property;
 }
@@ -639,7 +637,7 @@ txInteger fxPrepareHeap(txMachine* the)
 							
 						else if ((property->kind == XS_MAP_KIND) || (property->kind == XS_SET_KIND)) {
 							fxPrepareInstance(the, slot);
-							linker->slotSize += property->value.table.length;
+							linker->entrySize += property->value.table.length + 1;
 						}
 						else if ((property->kind == XS_WEAK_MAP_KIND) || (property->kind == XS_WEAK_SET_KIND))
 							fxPrepareInstance(the, slot);
@@ -1119,9 +1117,9 @@ void fxPrintSlot(txMachine* the, FILE* file, txSlot* slot, txFlag flag)
 	} break;
 	case XS_MAP_KIND: {
 		fprintf(file, ".kind = XS_MAP_KIND}, ");
-		fprintf(file, ".value = { .table = { (txSlot**)&gxSlotData[%d], %d } }", linker->slotSize, slot->value.table.length);
-		c_memcpy(linker->slotData + linker->slotSize, slot->value.table.address, slot->value.table.length * sizeof(txSlot*));
-		linker->slotSize += slot->value.table.length;
+		fprintf(file, ".value = { .table = { (txSlot**)&gxEntryData[%d], %d } }", linker->entrySize, slot->value.table.length);
+		c_memcpy(linker->entryData + linker->entrySize, slot->value.table.address, mxTableSize(slot->value.table.length));
+		linker->entrySize += slot->value.table.length + 1;
 	} break;
 	case XS_MODULE_KIND: {
 		fprintf(file, ".kind = XS_MODULE_KIND}, ");
@@ -1153,9 +1151,9 @@ void fxPrintSlot(txMachine* the, FILE* file, txSlot* slot, txFlag flag)
 	} break;
 	case XS_SET_KIND: {
 		fprintf(file, ".kind = XS_SET_KIND}, ");
-		fprintf(file, ".value = { .table = { (txSlot**)&gxSlotData[%d], %d } }", linker->slotSize, slot->value.table.length);
-		c_memcpy(linker->slotData + linker->slotSize, slot->value.table.address, slot->value.table.length * sizeof(txSlot*));
-		linker->slotSize += slot->value.table.length;
+		fprintf(file, ".value = { .table = { (txSlot**)&gxEntryData[%d], %d } }", linker->entrySize, slot->value.table.length);
+		c_memcpy(linker->entryData + linker->entrySize, slot->value.table.address, mxTableSize(slot->value.table.length));
+		linker->entrySize += slot->value.table.length + 1;
 	} break;
 	case XS_TYPED_ARRAY_KIND: {
 		fprintf(file, ".kind = XS_TYPED_ARRAY_KIND}, ");
@@ -1279,6 +1277,20 @@ void fxPrintStack(txMachine* the, FILE* file)
 }
 
 
+void fxPrintEntries(txMachine* the, FILE* file, txSize count, txHashEntry* entries) 
+{
+	while (count > 1) {
+		fprintf(file, "\t{ ");
+		fxPrintAddress(the, file, entries->slot);
+		fprintf(file, ", 0x%x },\n", entries->sum);
+		count--;
+		entries++;
+	}
+	fprintf(file, "\t{ ");
+	fxPrintAddress(the, file, entries->slot);
+	fprintf(file, ", 0x%x }\n", entries->sum);
+}
+
 void fxPrintTable(txMachine* the, FILE* file, txSize modulo, txSlot** table) 
 {
 	while (modulo > 1) {